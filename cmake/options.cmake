@@ -107,6 +107,11 @@ add_feature_info("Unit tests" WITH_TESTS "PDAL unit tests")
 option(USE_EXTERNAL_GTEST
     "Compile against an external GTest installation" OFF)
 
+option(WITH_BENCHMARKS
+    "Choose if the pdal_bench benchmark program should be built" FALSE)
+add_feature_info("Benchmarks" WITH_BENCHMARKS
+    "pdal_bench benchmark program (requires WITH_TESTS)")
+
 option(BUILD_DOCS
     "Choose if PDAL creates targets for building documentation" FALSE)
 
@@ -257,9 +257,13 @@ void ChipperFilter::split(ChipRefList& wide, ChipRefList& narrow,
 
 void ChipperFilter::emit(ChipRefList& wide, PointId widemin, PointId widemax)
 {
-    PointViewPtr view = m_inView->makeNew();
+    m_ids.clear();
     for (size_t idx = widemin; idx <= widemax; ++idx)
-        view->appendPoint(*m_inView.get(), wide[idx].m_ptindex);
+        m_ids.push_back(wide[idx].m_ptindex);
+
+    PointViewPtr view = m_inView->makeNew();
+    view->appendPoints(*m_inView.get(), m_ids.data(),
+        m_ids.data() + m_ids.size());
 
     m_outViews.insert(view);
 }
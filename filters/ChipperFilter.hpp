@@ -135,6 +135,7 @@ private:
     ChipRefList m_xvec;
     ChipRefList m_yvec;
     ChipRefList m_spare;
+    PointIdList m_ids;
 
     ChipperFilter& operator=(const ChipperFilter&); // not implemented
     ChipperFilter(const ChipperFilter&); // not implemented
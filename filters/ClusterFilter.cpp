@@ -39,6 +39,7 @@
 #include "private/Segmentation.hpp"
 
 #include <string>
+#include <thread>
 
 namespace pdal
 {
@@ -65,6 +66,8 @@ void ClusterFilter::addArgs(ProgramArgs& args)
         (std::numeric_limits<uint64_t>::max)());
     args.add("tolerance", "Radius", m_tolerance, 1.0);
     args.add("is3d", "Perform cluster extraction in 3D?", m_is3d, true);
+    args.add("threads", "Number of threads used for neighbor searches",
+        m_threads, (size_t)(std::max)(std::thread::hardware_concurrency(), 1U));
 }
 
 void ClusterFilter::addDimensions(PointLayoutPtr layout)
@@ -77,10 +80,10 @@ void ClusterFilter::filter(PointView& view)
     std::deque<PointIdList> clusters;
     if (m_is3d)
         clusters = Segmentation::extractClusters<KD3Index>(view, m_minPoints,
-            m_maxPoints, m_tolerance);
+            m_maxPoints, m_tolerance, m_threads);
     else
         clusters = Segmentation::extractClusters<KD2Index>(view, m_minPoints,
-            m_maxPoints, m_tolerance);
+            m_maxPoints, m_tolerance, m_threads);
 
     uint64_t id = 1;
     for (auto const& c : clusters)
@@ -39,8 +39,11 @@
 
 #include <pdal/KDIndex.hpp>
 
+#include "private/DisjointSet.hpp"
+#include "private/Segmentation.hpp"
+
 #include <string>
-#include <unordered_set>
+#include <thread>
 
 namespace pdal
 {
@@ -69,6 +72,8 @@ void DBSCANFilter::addArgs(ProgramArgs& args)
     args.add("eps", "Epsilon", m_eps, 1.0);
     args.add("dimensions", "Dimensions to cluster", m_dimStringList,
              {"X", "Y", "Z"});
+    args.add("threads", "Number of threads used for neighbor searches",
+        m_threads, (size_t)(std::max)(std::thread::hardware_concurrency(), 1U));
 }
 
 void DBSCANFilter::addDimensions(PointLayoutPtr layout)
@@ -94,81 +99,75 @@ void DBSCANFilter::prepared(PointTableRef table)
     }
 }
 
+// Clusters are found in three passes that only keep a few values per point:
+//  1) Find the core points, which have at least min_points neighbors.
+//  2) Join core points that are neighbors in a disjoint set. Each set is a
+//     cluster.
+//  3) Assign each non-core point to a cluster of a core point in its
+//     neighborhood. Points without core neighbors are noise.
+// The neighbor searches of each pass are split among threads. The labels are
+// the same as those of a sequential DBSCAN that visits points in ID order.
 void DBSCANFilter::filter(PointView& view)
 {
+    using Segmentation::forEachBlock;
+
     // Construct KDFlexIndex for radius search.
     KDFlexIndex kdfi(view, m_dimIdList);
     kdfi.build();
 
-    // First pass through point cloud precomputes neighbor indices and
-    // initializes ClusterID to -2.
-    std::vector<PointIdList> neighbors(view.size());
-    for (PointId idx = 0; idx < view.size(); ++idx)
-    {
-        neighbors[idx] = kdfi.radius(idx, m_eps);
-        view.setField(Id::ClusterID, idx, -2);
-    }
+    const point_count_t count = view.size();
 
-    // Second pass through point cloud performs DBSCAN clustering.
-    int64_t cluster_label = 0;
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    std::vector<char> core(count);
+    forEachBlock(count, m_threads, [this, &kdfi, &core](PointId begin, PointId end)
     {
-        // Point has already been labeled, so move on to next.
-        if (view.getFieldAs<int64_t>(Id::ClusterID, idx) != -2)
-            continue;
+        for (PointId idx = begin; idx < end; ++idx)
+            core[idx] = kdfi.radius(idx, m_eps).size() >= m_minPoints;
+    });
 
-        // Density of the neighborhood does not meet minimum number of points
-        // constraint, label as noise.
-        if (neighbors[idx].size() < m_minPoints)
+    ConcurrentDisjointSet clusters(count);
+    forEachBlock(count, m_threads,
+        [this, &kdfi, &core, &clusters](PointId begin, PointId end)
+    {
+        for (PointId idx = begin; idx < end; ++idx)
         {
-            view.setField(Id::ClusterID, idx, -1);
-            continue;
+            if (!core[idx])
+                continue;
+            for (PointId n : kdfi.radius(idx, m_eps))
+                if (n > idx && core[n])
+                    clusters.unite(idx, n);
         }
+    });
 
-        // Initialize some bookkeeping to track which neighbors have been
-        // considered for addition to the current cluster.
-        std::unordered_set<PointId> neighbors_next(neighbors[idx].begin(),
-                                                   neighbors[idx].end());
-        std::unordered_set<PointId> neighbors_visited;
-        neighbors_visited.insert(idx);
-
-        // Unlabeled point encountered; assign cluster label.
-        view.setField(Id::ClusterID, idx, cluster_label);
+    // The root of a cluster is its lowest core point, so numbering the roots
+    // in ID order gives the cluster labels of a sequential DBSCAN.
+    std::vector<int64_t> labels(count, -1);
+    int64_t cluster_label = 0;
+    for (PointId idx = 0; idx < count; ++idx)
+    {
+        if (!core[idx])
+            continue;
+        PointId root = clusters.find(idx);
+        labels[idx] = (root == idx) ? cluster_label++ : labels[root];
+    }
 
-        // Consider all neighbors.
-        while (!neighbors_next.empty())
+    // A sequential DBSCAN expands clusters in label order, so a non-core point
+    // gets the lowest label of the clusters in its neighborhood.
+    forEachBlock(count, m_threads, [this, &kdfi, &core, &labels](PointId begin, PointId end)
+    {
+        for (PointId idx = begin; idx < end; ++idx)
         {
-            // Select first neighbor and move it to the visited set.
-            PointId p = *neighbors_next.begin();
-            neighbors_next.erase(neighbors_next.begin());
-            neighbors_visited.insert(p);
-
-            // Reassign cluster label to neighbor previously marked as noise.
-            if (view.getFieldAs<int64_t>(Id::ClusterID, p) == -1)
-                view.setField(Id::ClusterID, p, cluster_label);
-
-            // Neighbor has already been labeled, so move on to next.
-            if (view.getFieldAs<int64_t>(Id::ClusterID, p) != -2)
+            if (core[idx])
                 continue;
-
-            // Assign cluster label to neighbor.
-            view.setField(Id::ClusterID, p, cluster_label);
-
-            // If density of neighbor's neighborhood is sufficient, add it's
-            // neighbors to the set of neighbors to consider if they are not
-            // already.
-            if (neighbors[p].size() >= m_minPoints)
-            {
-                for (PointId q : neighbors[p])
-                {
-                    if (neighbors_visited.count(q) == 0)
-                        neighbors_next.insert(q);
-                }
-            }
+            int64_t label = -1;
+            for (PointId n : kdfi.radius(idx, m_eps))
+                if (core[n] && (label == -1 || labels[n] < label))
+                    label = labels[n];
+            labels[idx] = label;
         }
+    });
 
-        cluster_label++;
-    }
+    for (PointId idx = 0; idx < count; ++idx)
+        view.setField(Id::ClusterID, idx, labels[idx]);
 }
 
 } // namespace pdal
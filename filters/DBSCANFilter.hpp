@@ -58,6 +58,7 @@ private:
     double m_eps;
     StringList m_dimStringList;
     Dimension::IdList m_dimIdList;
+    size_t m_threads;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void addDimensions(PointLayoutPtr layout);
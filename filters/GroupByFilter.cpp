@@ -36,6 +36,8 @@
 
 #include <pdal/util/ProgramArgs.hpp>
 
+#include "private/Partitioner.hpp"
+
 namespace pdal
 {
 
@@ -73,13 +75,19 @@ PointViewSet GroupByFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
 
+    Partitioner partitioner;
+    partitioner.reserve(inView->size());
     for (PointId idx = 0; idx < inView->size(); idx++)
+        partitioner.add(inView->getFieldAs<int64_t>(m_dimId, idx), idx);
+
+    // Groups come back in order of first appearance, so views are created
+    // in the same order as when points were added one at a time.
+    for (const Partitioner::Group& g : partitioner.partition())
     {
-        int64_t val = inView->getFieldAs<int64_t>(m_dimId, idx);
-        PointViewPtr& outView = m_viewMap[val];
+        PointViewPtr& outView = m_viewMap[g.key];
         if (!outView)
             outView = inView->makeNew();
-        outView->appendPoint(*inView.get(), idx);
+        outView->appendPoints(*inView.get(), g.begin, g.end);
     }
 
     // Pull the buffers out of the map and stick them in the standard
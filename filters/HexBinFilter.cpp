@@ -97,6 +97,9 @@ void HexBin::addArgs(ProgramArgs& args)
         "https://h3geo.org/docs/core-library/restable", m_h3Res, -1);
     args.add("ogrdriver", "GDAL OGR vector driver for writing with 'density' or 'boundary' "
         "options.", m_driver, "GeoJSON");
+    args.add("point_count", "Number of points represented by the input when it is a "
+        "subset of the data, such as the upper levels of an octree. Used to compute "
+        "density.", m_pointCount);
 }
 
 
@@ -207,6 +210,12 @@ bool HexBin::createGrid()
                 throwError("Sampling for hexbin auto-edge length calculation failed!");
         }
 
+        // When the input is a subset of the data, a hexagon is dense when it
+        // holds the same share of 'threshold' points as was read.
+        if (m_pointCount > m_count && m_count)
+            m_grid->setDenseLimit((std::max)(1, (int)std::lround(
+                m_density * (double)m_count / m_pointCount)));
+
         m_grid->findShapes();
         m_grid->findParentPaths();
     }
@@ -269,8 +278,13 @@ void HexBin::done(PointTableRef table)
             density_p = Polygon();
     }
 
+    // When the input is a subset of the data, densities are scaled to the number
+    // of points the input represents.
+    point_count_t pointCount = m_pointCount ? m_pointCount : m_count;
+    double scale = m_count ? (double)pointCount / m_count : 1.0;
+
     double area = density_p.area();
-    double density = m_count / area;
+    double density = pointCount / area;
     if (std::isinf(density))
     {
         density = -1.0;
@@ -296,7 +310,7 @@ void HexBin::done(PointTableRef table)
 
     // what's the purpose of this? rename it?
     double hexArea(((3 * SQRT_3)/2.0) * (m_grid->height() * m_grid->height()));
-    double avg_density = (n * hexArea) / totalCount;
+    double avg_density = (n * hexArea) / (totalCount * scale);
     m_metadata.add("avg_pt_per_sq_unit", avg_density, "Area / point count "
         "(ignore contrary metadata item name. This is '(n * hexArea) / totalCount')");
 
@@ -69,6 +69,7 @@ private:
     bool m_outputTesselation;
     bool m_doSmooth;
     point_count_t m_count;
+    point_count_t m_pointCount;
     bool m_preserve_topology;
     std::string m_DensityOutput;
     std::string m_boundaryOutput;
@@ -33,10 +33,11 @@
 
 #include "MortonOrderFilter.hpp"
 
-#include <climits>
-#include <iostream>
-#include <limits>
-#include <map>
+#include <cmath>
+#include <thread>
+
+#include <pdal/private/SpaceCurve.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 namespace pdal
 {
@@ -56,42 +57,56 @@ std::string MortonOrderFilter::getName() const { return s_info.name; }
 void MortonOrderFilter::addArgs(ProgramArgs& args)
 {
     args.add("reverse", "Reverse Morton", m_reverse, false);
+    args.add("curve", "Space-filling curve used to order points: "
+        "'morton' or 'hilbert'", m_curve, "morton");
+    args.add("use_z", "Order points in three dimensions", m_useZ);
+    args.add("threads", "Number of threads used to compute and sort keys",
+        m_threads, (size_t)(std::max)(std::thread::hardware_concurrency(), 1U));
 }
 
-//This used to be a lambda, but the VS compiler exploded, I guess.
-typedef std::pair<double, double> Coord;
-namespace
-{
-bool less_msb(const int& x, const int& y)
+void MortonOrderFilter::initialize()
 {
-    return x < y && x < (x ^ y);
+    m_curve = Utils::tolower(m_curve);
+    if (m_curve != "morton" && m_curve != "hilbert")
+        throwError("Invalid curve '" + m_curve + "'. Must be 'morton' "
+            "or 'hilbert'.");
+    if (m_reverse && (m_curve != "morton" || m_useZ))
+        throwError("Option 'reverse' can only be used with a 2D "
+            "Morton curve.");
 }
 
-class CmpZOrder
+namespace
 {
-public:
-    bool operator()(const Coord& c1, const Coord& c2) const
-    {
-        int a[2] = {(int)(c1.first * INT_MAX), (int)(c1.second * INT_MAX)};
-        int b[2] = {(int)(c2.first * INT_MAX), (int)(c2.second * INT_MAX)};
 
-        int j = 0;
-        int x = 0;
+// Don't bother splitting work into pieces smaller than this.
+const point_count_t MinChunkSize = 65536;
 
-        for (int k = 0; k < 2; k++)
+// Compute the key of each point in a view, splitting the work among threads.
+template<typename KeyFunc>
+KeyIdList computeKeys(const PointView& view, size_t threads, KeyFunc f)
+{
+    const point_count_t count = view.size();
+    KeyIdList keys(count);
+
+    const size_t chunks = (std::max)((size_t)1,
+        (std::min)(threads, (size_t)(count / MinChunkSize)));
+    ThreadPool pool(chunks);
+    for (size_t c = 0; c < chunks; ++c)
+    {
+        PointId begin = c * count / chunks;
+        PointId end = (c + 1) * count / chunks;
+        pool.add([&keys, &f, begin, end]()
         {
-            int y = a[k] ^ b[k];
-            if (less_msb(x, y))
-            {
-                j = k;
-                x = y;
-            }
-        }
-        return (a[j] - b[j]) < 0;
-    };
-};
+            for (PointId idx = begin; idx < end; ++idx)
+                keys[idx] = { f(idx), idx };
+        });
+    }
+    pool.await();
+    return keys;
 }
 
+} // unnamed namespace
+
 class ReverseZOrder
 {
 public:
@@ -120,25 +135,15 @@ private:
         x = (x ^ (x <<  1)) & 0x55555555;
         return x;
     }
-
-    static uint32_t part1_by2(uint32_t x)
-    {
-        x &= 0x000003ff;
-        x = (x ^ (x << 16)) & 0xff0000ff;
-        x = (x ^ (x <<  8)) & 0x0300f00f;
-        x = (x ^ (x <<  4)) & 0x030c30c3;
-        x = (x ^ (x <<  2)) & 0x09249249;
-        return x;
-    }
 };
 
-PointViewSet MortonOrderFilter::reverseMorton(PointViewPtr inView)
+KeyIdList MortonOrderFilter::reverseMortonKeys(const PointView& view)
 {
-    const int32_t cell = static_cast<int32_t>(sqrt(inView->size()));
+    const int32_t cell = static_cast<int32_t>(sqrt(view.size()));
 
     // compute range
     BOX2D buffer_bounds;
-    inView->calculateBounds(buffer_bounds);
+    view.calculateBounds(buffer_bounds);
     const double xrange = buffer_bounds.maxx - buffer_bounds.minx;
     const double yrange = buffer_bounds.maxy - buffer_bounds.miny;
 
@@ -146,84 +151,71 @@ PointViewSet MortonOrderFilter::reverseMorton(PointViewPtr inView)
     const double cell_height = yrange / cell;
 
     // compute reverse morton code for each point
-    std::multimap<uint32_t, PointId> codes;
-    for (PointId idx = 0; idx < inView->size(); idx++)
+    return computeKeys(view, m_threads, [&](PointId idx)
     {
-        const double x = inView->getFieldAs<double>(Dimension::Id::X, idx);
+        const double x = view.getFieldAs<double>(Dimension::Id::X, idx);
         const int32_t xpos =
             static_cast<int32_t>(std::floor((x - buffer_bounds.minx) /
                 cell_width));
 
-        const double y = inView->getFieldAs<double>(Dimension::Id::Y, idx);
+        const double y = view.getFieldAs<double>(Dimension::Id::Y, idx);
         const int32_t ypos =
             static_cast<int32_t>(std::floor((y - buffer_bounds.miny) /
                 cell_height));
 
         const uint32_t code = ReverseZOrder::encode_morton(xpos, ypos);
-        const uint32_t reverse = ReverseZOrder::reverse_morton( code );
+        return (uint64_t)ReverseZOrder::reverse_morton(code);
+    });
+}
 
-        codes.insert( std::pair<uint32_t, PointId>(reverse, idx) );
-    }
+KeyIdList MortonOrderFilter::curveKeys(const PointView& view)
+{
+    using namespace Dimension;
 
-    // a map is yet order by key so its naturally ordered by lod
-    std::multimap<uint32_t, PointId>::iterator it;
-    PointViewPtr outView = inView->makeNew();
-    for (it = codes.begin(); it != codes.end(); ++it)
+    curve::Type type = (m_curve == "hilbert") ?
+        curve::Type::Hilbert : curve::Type::Morton;
+
+    if (m_useZ)
     {
-        outView->appendPoint(*inView, it->second);
+        BOX3D bounds;
+        view.calculateBounds(bounds);
+        curve::Encoder encoder(type, bounds);
+        return computeKeys(view, m_threads, [&](PointId idx)
+        {
+            return encoder.key(view.getFieldAs<double>(Id::X, idx),
+                view.getFieldAs<double>(Id::Y, idx),
+                view.getFieldAs<double>(Id::Z, idx));
+        });
     }
 
-    // build output view
-    PointViewSet viewSet;
-    viewSet.insert(outView);
-
-    return viewSet;
+    BOX2D bounds;
+    view.calculateBounds(bounds);
+    curve::Encoder encoder(type, bounds);
+    return computeKeys(view, m_threads, [&](PointId idx)
+    {
+        return encoder.key(view.getFieldAs<double>(Id::X, idx),
+            view.getFieldAs<double>(Id::Y, idx));
+    });
 }
 
-PointViewSet MortonOrderFilter::morton(PointViewPtr inView)
+PointViewSet MortonOrderFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
     if (!inView->size())
         return viewSet;
-    CmpZOrder compare;
-    std::multimap<Coord, PointId, CmpZOrder> sorted(compare);
 
-    BOX2D buffer_bounds;
-    inView->calculateBounds(buffer_bounds);
-    double xrange = buffer_bounds.maxx - buffer_bounds.minx;
-    double yrange = buffer_bounds.maxy - buffer_bounds.miny;
+    KeyIdList keys = m_reverse ?
+        reverseMortonKeys(*inView) : curveKeys(*inView);
 
-    for (PointId idx = 0; idx < inView->size(); idx++)
-    {
-        double xpos = (inView->getFieldAs<double>(Dimension::Id::X, idx) -
-            buffer_bounds.minx) / xrange;
-        double ypos = (inView->getFieldAs<double>(Dimension::Id::Y, idx) -
-            buffer_bounds.miny) / yrange;
-        Coord loc(xpos, ypos);
-        sorted.insert(std::make_pair(loc, idx));
-    }
+    // The sort is stable, so points with equal keys keep their order.
+    keysort::sort(keys, m_threads);
 
     PointViewPtr outView = inView->makeNew();
-    std::multimap<Coord, PointId, CmpZOrder>::iterator pos;
-    for (pos = sorted.begin(); pos != sorted.end(); ++pos)
-    {
-        outView->appendPoint(*inView, pos->second);
-    }
+    for (const KeyId& k : keys)
+        outView->appendPoint(*inView, k.id);
     viewSet.insert(outView);
 
     return viewSet;
 }
 
-PointViewSet MortonOrderFilter::run(PointViewPtr inView)
-{
-    if ( m_reverse )
-    {
-        return reverseMorton( inView );
-    }
-    else
-    {
-        return morton( inView );
-    }
-}
-
 } // pdal
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <pdal/Filter.hpp>
+#include <pdal/private/KeySort.hpp>
 
 namespace pdal
 {
@@ -51,12 +52,16 @@ public:
 
 private:
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
 
-    PointViewSet reverseMorton(PointViewPtr view);
-    PointViewSet morton(PointViewPtr view);
+    KeyIdList reverseMortonKeys(const PointView& view);
+    KeyIdList curveKeys(const PointView& view);
 
     bool m_reverse = false;
+    std::string m_curve;
+    bool m_useZ = false;
+    size_t m_threads = 1;
 };
 
 } // namespace pdal
@@ -125,12 +125,14 @@ void ReprojectionFilter::prepared(PointTableRef table)
 
     };
 
+    m_inAxisOrdering.clear();
     if (m_inAxisOrderingArg.size())
     {
         m_inAxisOrdering = convert(m_inAxisOrderingArg);
         check(m_inAxisOrdering);
     }
 
+    m_outAxisOrdering.clear();
     if (m_outAxisOrderingArg.size())
     {
         m_outAxisOrdering = convert(m_outAxisOrderingArg);
@@ -150,6 +152,14 @@ void ReprojectionFilter::createTransform(const SpatialReference& srsSRS)
     }
 
 
+    // Creating a transform is expensive, so reuse the existing one if
+    // nothing has changed since the last execution.
+    TransformKey key { m_inSRS.getWKT(), m_outSRS.getWKT(), m_inAxisOrdering,
+        m_outAxisOrdering, m_inCoordEpochArg, m_outCoordEpochArg };
+    if (m_transform && key == m_transformKey)
+        return;
+    m_transformKey = key;
+
     // If either vector is empty, GDAL's default ordering is used.
     if (m_inAxisOrdering.size() || m_outAxisOrdering.size())
     {
@@ -38,6 +38,8 @@
 #include <pdal/Streamable.hpp>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace pdal
 {
@@ -75,6 +77,26 @@ private:
     std::vector<int> m_outAxisOrdering;
     double m_inCoordEpochArg;
     double m_outCoordEpochArg;
+    // What m_transform was created from, so that it can be reused when the
+    // filter is executed again with the same SRSs.
+    struct TransformKey
+    {
+        std::string m_inWkt;
+        std::string m_outWkt;
+        std::vector<int> m_inAxisOrdering;
+        std::vector<int> m_outAxisOrdering;
+        double m_inEpoch;
+        double m_outEpoch;
+
+        bool operator==(const TransformKey& k) const
+        {
+            return m_inWkt == k.m_inWkt && m_outWkt == k.m_outWkt &&
+                m_inAxisOrdering == k.m_inAxisOrdering &&
+                m_outAxisOrdering == k.m_outAxisOrdering &&
+                m_inEpoch == k.m_inEpoch && m_outEpoch == k.m_outEpoch;
+        }
+    };
+    TransformKey m_transformKey;
 
     bool m_errorOnFailure;
 };
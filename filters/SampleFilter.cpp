@@ -36,6 +36,7 @@
 
 #include <pdal/util/ProgramArgs.hpp>
 
+#include <limits>
 #include <string>
 
 namespace pdal
@@ -43,6 +44,14 @@ namespace pdal
 
 using namespace Dimension;
 
+namespace
+{
+
+// Marks the end of a voxel's list of sampled points.
+const uint64_t NoCoord = (std::numeric_limits<uint64_t>::max)();
+
+} // unnamed namespace
+
 static StaticPluginInfo const s_info{
     "filters.sample", "Subsampling filter",
     "https://pdal.org/stages/filters.sample.html"};
@@ -85,6 +94,7 @@ void SampleFilter::prepared(PointTableRef table)
 void SampleFilter::ready(PointTableRef)
 {
     m_populatedVoxels.clear();
+    m_coords.clear();
 
     if (m_cellArg->set())
         m_radius = m_cell / 2.0 * std::sqrt(3.0);
@@ -104,10 +114,7 @@ PointViewSet SampleFilter::run(PointViewPtr view)
     for (PointRef point : *view)
     {
         if (keepPoint(point))
-        {
-            bool kept = voxelize(point);
             output->appendPoint(*view, point.pointId());
-        }
     }
 
     PointViewSet viewSet;
@@ -134,88 +141,69 @@ bool SampleFilter::voxelize(PointRef& point)
     }
 
     // Get voxel indices for current point.
-    Voxel v = std::make_tuple((int)(std::floor((x - m_originX) / m_cell)),
-                              (int)(std::floor((y - m_originY) / m_cell)),
-                              (int)(std::floor((z - m_originZ) / m_cell)));
+    VoxelKey v { (int)(std::floor((x - m_originX) / m_cell)),
+                 (int)(std::floor((y - m_originY) / m_cell)),
+                 (int)(std::floor((z - m_originZ) / m_cell)) };
 
     // Check current voxel before any of the neighbors. We will most often have
     // points that are too close in the point's enclosing voxel, thus saving
     // cycles.
-    if (m_populatedVoxels.find(v) != m_populatedVoxels.end())
-    {
-        // Get list of coordinates in candidate voxel.
-        CoordList coords = m_populatedVoxels[v];
-        for (Coord const& coord : coords)
-        {
-            // Compute Euclidean distance between current point and
-            // candidate voxel.
-            double xv = std::get<0>(coord);
-            double yv = std::get<1>(coord);
-            double zv = std::get<2>(coord);
-            double distSqr =
-                (xv - x) * (xv - x) + (yv - y) * (yv - y) + (zv - z) * (zv - z);
-
-            // If any point is closer than the minimum radius, we can
-            // immediately return false, as the minimum distance
-            // criterion is violated.
-            if (distSqr < m_radiusSqr)
-                return false;
-        }
-    }
+    uint64_t *head = m_populatedVoxels.find(v);
+    if (head && tooClose(*head, x, y, z))
+        return false;
 
     // Iterate over immediate neighbors of current voxel, computing minimum
     // distance between any already added point and the current point.
-    for (int xi = std::get<0>(v) - 1; xi < std::get<0>(v) + 2; ++xi)
+    for (int xi = v.x - 1; xi < v.x + 2; ++xi)
     {
-        for (int yi = std::get<1>(v) - 1; yi < std::get<1>(v) + 2; ++yi)
+        for (int yi = v.y - 1; yi < v.y + 2; ++yi)
         {
-            for (int zi = std::get<2>(v) - 1; zi < std::get<2>(v) + 2; ++zi)
+            for (int zi = v.z - 1; zi < v.z + 2; ++zi)
             {
-                Voxel candidate = std::make_tuple(xi, yi, zi);
+                VoxelKey candidate { xi, yi, zi };
 
                 // We have already visited the center voxel, and can skip it.
                 if (v == candidate)
                     continue;
 
                 // Check that candidate voxel is occupied.
-                if (m_populatedVoxels.find(candidate) ==
-                    m_populatedVoxels.end())
-                    continue;
-
-                // Get list of coordinates in candidate voxel.
-                CoordList coords = m_populatedVoxels[candidate];
-                for (Coord const& coord : coords)
-                {
-                    // Compute Euclidean distance between current point and
-                    // candidate voxel.
-                    double xv = std::get<0>(coord);
-                    double yv = std::get<1>(coord);
-                    double zv = std::get<2>(coord);
-                    double distSqr = (xv - x) * (xv - x) + (yv - y) * (yv - y) +
-                                     (zv - z) * (zv - z);
-
-                    // If any point is closer than the minimum radius, we can
-                    // immediately return false, as the minimum distance
-                    // criterion is violated.
-                    if (distSqr < m_radiusSqr)
-                        return false;
-                }
+                uint64_t *candidateHead = m_populatedVoxels.find(candidate);
+                if (candidateHead && tooClose(*candidateHead, x, y, z))
+                    return false;
             }
         }
     }
 
-    Coord coord = std::make_tuple(x, y, z);
-    if (m_populatedVoxels.find(v) != m_populatedVoxels.end())
-    {
-        m_populatedVoxels[v].push_back(coord);
-    }
+    // Link the point at the front of its voxel's list.
+    uint64_t next = head ? *head : NoCoord;
+    uint64_t idx = m_coords.size();
+    m_coords.push_back({ x, y, z, next });
+    if (head)
+        *head = idx;
     else
+        m_populatedVoxels.insert(v, idx);
+    return true;
+}
+
+// Determine if any sampled point in a voxel's list is closer than the
+// minimum radius.
+bool SampleFilter::tooClose(uint64_t head, double x, double y, double z) const
+{
+    for (uint64_t i = head; i != NoCoord; i = m_coords[i].next)
     {
-        CoordList coords;
-        coords.push_back(coord);
-        m_populatedVoxels.emplace(v, coords);
+        // Compute Euclidean distance between current point and
+        // candidate voxel.
+        const Coord& c = m_coords[i];
+        double distSqr =
+            (c.x - x) * (c.x - x) + (c.y - y) * (c.y - y) + (c.z - z) * (c.z - z);
+
+        // If any point is closer than the minimum radius, we can
+        // immediately return true, as the minimum distance
+        // criterion is violated.
+        if (distSqr < m_radiusSqr)
+            return true;
     }
-    return true;
+    return false;
 }
 
 bool SampleFilter::keepPoint(PointRef& point)
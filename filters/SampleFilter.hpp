@@ -37,13 +37,22 @@
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
+#include "private/VoxelMap.hpp"
+
 namespace pdal
 {
 
 class PDAL_EXPORT SampleFilter : public Filter, public Streamable
 {
-    using Voxel = std::tuple<int, int, int>;
-    using Coord = std::tuple<double, double, double>;
+    // Sampled points are kept in a single list. The points in a voxel are
+    // linked through 'next', starting from the index stored in the voxel map.
+    struct Coord
+    {
+        double x;
+        double y;
+        double z;
+        uint64_t next;
+    };
     using CoordList = std::vector<Coord>;
 
 public:
@@ -68,7 +77,8 @@ private:
     Arg* m_originXArg;
     Arg* m_originYArg;
     Arg* m_originZArg;
-    std::map<Voxel, CoordList> m_populatedVoxels;
+    VoxelMap<uint64_t> m_populatedVoxels;
+    CoordList m_coords;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
@@ -79,6 +89,7 @@ private:
     bool keepPoint(PointRef& point);
 
     bool voxelize(PointRef& point);
+    bool tooClose(uint64_t head, double x, double y, double z) const;
 };
 
 } // namespace pdal
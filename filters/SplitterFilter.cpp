@@ -40,6 +40,8 @@
 
 #include <pdal/util/ProgramArgs.hpp>
 
+#include "private/Partitioner.hpp"
+
 namespace pdal
 {
 
@@ -142,12 +144,10 @@ void SplitterFilter::setOrigin(double xOrigin, double yOrigin)
 PointViewSet SplitterFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
-    auto addPoint = [this, &inView](PointRef& point, int xpos, int ypos) {
-        Coord loc(xpos, ypos);
-        PointViewPtr& outView = m_viewMap[loc];
-        if (!outView)
-            outView = inView->makeNew();
-        outView->appendPoint(*inView.get(), point.pointId());
+    Partitioner partitioner;
+    partitioner.reserve(inView->size());
+    auto addPoint = [&partitioner](PointRef& point, int xpos, int ypos) {
+        partitioner.add(Partitioner::cellKey(xpos, ypos), point.pointId());
     };
 
     // Use the location of the first point as the origin, unless specified.
@@ -166,6 +166,16 @@ PointViewSet SplitterFilter::run(PointViewPtr inView)
         processPoint(point, addPoint);
     }
 
+    // Groups come back in order of first appearance, so views are created
+    // in the same order as when points were added one at a time.
+    for (const Partitioner::Group& g : partitioner.partition())
+    {
+        PointViewPtr& outView = m_viewMap[Partitioner::cell(g.key)];
+        if (!outView)
+            outView = inView->makeNew();
+        outView->appendPoints(*inView.get(), g.begin, g.end);
+    }
+
     // Pull the buffers out of the map and stick them in the standard
     // output set.
     for (auto bi = m_viewMap.begin(); bi != m_viewMap.end(); ++bi)
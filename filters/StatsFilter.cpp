@@ -34,7 +34,9 @@
 
 #include "StatsFilter.hpp"
 
+#include <algorithm>
 #include <cmath>
+#include <thread>
 #include <unordered_map>
 
 #include <pdal/Options.hpp>
@@ -56,9 +58,119 @@ CREATE_STATIC_STAGE(StatsFilter, s_info)
 
 std::string StatsFilter::getName() const { return s_info.name; }
 
+namespace
+{
+
+// Number of points summarized by each task in threaded mode.
+const point_count_t BlockSize = 16384;
+
+} // unnamed namespace
+
 namespace stats
 {
 
+void QuantileSketch::compact(size_t level)
+{
+    if (level + 1 == m_levels.size())
+    {
+        m_levels.emplace_back();
+        m_odd.push_back(false);
+    }
+
+    DataVector& values = m_levels[level];
+    DataVector& next = m_levels[level + 1];
+    std::sort(values.begin(), values.end());
+
+    // Promote every other value, alternating the starting offset so that
+    // repeated compactions don't bias the result.  An odd value out (the
+    // largest) stays behind.
+    size_t end = values.size() - (values.size() % 2);
+    for (size_t i = m_odd[level] ? 1 : 0; i < end; i += 2)
+        next.push_back(values[i]);
+    m_odd[level] = !m_odd[level];
+    values.erase(values.begin(), values.begin() + end);
+
+    if (next.size() > LevelSize)
+        compact(level + 1);
+}
+
+
+void QuantileSketch::merge(const QuantileSketch& s)
+{
+    for (size_t level = 0; level < s.m_levels.size(); ++level)
+    {
+        if (level == m_levels.size())
+        {
+            m_levels.emplace_back();
+            m_odd.push_back(false);
+        }
+        const DataVector& src = s.m_levels[level];
+        m_levels[level].insert(m_levels[level].end(), src.begin(), src.end());
+    }
+    m_count += s.m_count;
+
+    for (size_t level = 0; level < m_levels.size(); ++level)
+        if (m_levels[level].size() > LevelSize)
+            compact(level);
+}
+
+
+void QuantileSketch::clear()
+{
+    m_levels.assign(1, DataVector());
+    m_odd.assign(1, false);
+    m_count = 0;
+}
+
+
+QuantileSketch::WeightedValues QuantileSketch::weightedValues() const
+{
+    WeightedValues values;
+    for (size_t level = 0; level < m_levels.size(); ++level)
+    {
+        point_count_t weight = point_count_t(1) << level;
+        for (double d : m_levels[level])
+            values.emplace_back(d, weight);
+    }
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+
+// Find the value whose (zero-based) rank contains 'rank'.  With unit weights
+// this is the same as indexing the sorted values.
+double QuantileSketch::valueAtRank(const WeightedValues& values, double rank)
+{
+    if (values.empty())
+        return 0.0;
+
+    point_count_t cumulative = 0;
+    for (auto& v : values)
+    {
+        cumulative += v.second;
+        if (cumulative > rank)
+            return v.first;
+    }
+    return values.back().first;
+}
+
+
+double QuantileSketch::quantile(double q) const
+{
+    q = (std::max)(0.0, (std::min)(q, 1.0));
+    return valueAtRank(weightedValues(), q * m_count);
+}
+
+
+double QuantileSketch::medianDeviation(double center) const
+{
+    WeightedValues values = weightedValues();
+    for (auto& v : values)
+        v.first = std::fabs(v.first - center);
+    std::sort(values.begin(), values.end());
+    return valueAtRank(values, m_count / 2.0);
+}
+
 
 void Summary::extractMetadata(MetadataNode &m)
 {
@@ -135,17 +247,12 @@ void Summary::extractMetadata(MetadataNode &m)
 
 void Summary::computeGlobalStats()
 {
-    auto compute_median = [](std::vector<double> vals)
-    {
-        std::nth_element(vals.begin(), vals.begin() + vals.size() / 2, vals.end());
-        return *(vals.begin() + vals.size() / 2);
-    };
+    if (m_sketch.count() == 0)
+        return;
 
     // TODO add quantiles
-    m_median = compute_median(m_data);
-    std::transform(m_data.begin(), m_data.end(), m_data.begin(),
-       [this](double v) { return std::fabs(v - this->m_median); });
-    m_mad = compute_median(m_data);
+    m_median = m_sketch.quantile(0.5);
+    m_mad = m_sketch.medianDeviation(m_median);
 }
 
 // Math comes from https://prod.sandia.gov/techlib-noauth/access-control.cgi/2008/086212.pdf
@@ -168,23 +275,36 @@ bool Summary::merge(const Summary& s)
     if (n == 0)
         return true;
 
-    double m1 = M1 + s.m_cnt * deltaMean / n;
-    double m2 = M2 + s.M2 + n1n2 * std::pow(deltaMean, 2) / n;
-    double m3 = M3 + s.M3 + n1n2 * (n1 - n2) * std::pow(deltaMean, 3) / nsq +
-        3 * (n1 * s.M2 - n2 * M2) * deltaMean / n;
-    double m4 = M4 + s.M4 +
-        n1n2 * (n1sq - n1n2 + n2sq) * std::pow(deltaMean, 4) / ncube +
-        6 * (n1sq * s.M2 + n2sq * M2) * std::pow(deltaMean, 2) / nsq +
-        4 * (n1 * s.M3 - n2 * M3) * deltaMean / n;
-
-    M1 = m1;
-    M2 = m2;
-    M3 = m3;
-    M4 = m4;
+    // Merging into an empty summary is a copy.  Doing it outright keeps
+    // the moments exact.
+    if (m_cnt == 0)
+    {
+        M1 = s.M1;
+        M2 = s.M2;
+        M3 = s.M3;
+        M4 = s.M4;
+    }
+    else
+    {
+        double m1 = M1 + s.m_cnt * deltaMean / n;
+        double m2 = M2 + s.M2 + n1n2 * std::pow(deltaMean, 2) / n;
+        double m3 = M3 + s.M3 +
+            n1n2 * (n1 - n2) * std::pow(deltaMean, 3) / nsq +
+            3 * (n1 * s.M2 - n2 * M2) * deltaMean / n;
+        double m4 = M4 + s.M4 +
+            n1n2 * (n1sq - n1n2 + n2sq) * std::pow(deltaMean, 4) / ncube +
+            6 * (n1sq * s.M2 + n2sq * M2) * std::pow(deltaMean, 2) / nsq +
+            4 * (n1 * s.M3 - n2 * M3) * deltaMean / n;
+
+        M1 = m1;
+        M2 = m2;
+        M3 = m3;
+        M4 = m4;
+    }
     m_min = (std::min)(m_min, s.m_min);
     m_max = (std::max)(m_max, s.m_max);
     m_cnt = s.m_cnt + m_cnt;
-    m_data.insert(m_data.begin(), s.m_data.begin(), s.m_data.end());
+    m_sketch.merge(s.m_sketch);
     for (auto p : s.m_values)
         m_values[p.first] += p.second;
 
@@ -197,6 +317,20 @@ using namespace stats;
 
 bool StatsFilter::processOne(PointRef& point)
 {
+    if (m_pool)
+    {
+        // Buffer the values column-wise and hand full blocks to the pool.
+        double *values = m_block->data() + m_blockCount;
+        for (auto p = m_stats.begin(); p != m_stats.end(); ++p)
+        {
+            *values = point.getFieldAs<double>(p->first);
+            values += BlockSize;
+        }
+        if (++m_blockCount == BlockSize)
+            queueBlock();
+        return true;
+    }
+
     for (auto p = m_stats.begin(); p != m_stats.end(); ++p)
     {
         Dimension::Id d = p->first;
@@ -209,6 +343,26 @@ bool StatsFilter::processOne(PointRef& point)
 
 void StatsFilter::filter(PointView& view)
 {
+    if (m_pool)
+    {
+        for (PointId begin = 0; begin < view.size(); begin += BlockSize)
+        {
+            PointId end = (std::min)(begin + BlockSize, view.size());
+            size_t block = m_nextBlock++;
+            m_pool->add([this, &view, begin, end, block]()
+            {
+                std::vector<Summary> summaries(emptySummaries());
+                auto si = summaries.begin();
+                for (auto p = m_stats.begin(); p != m_stats.end(); ++p, ++si)
+                    for (PointId idx = begin; idx < end; ++idx)
+                        si->insert(view.getFieldAs<double>(p->first, idx));
+                mergeBlock(block, std::move(summaries));
+            });
+        }
+        m_pool->await();
+        return;
+    }
+
     PointRef point(view, 0);
     for (PointId idx = 0; idx < view.size(); ++idx)
     {
@@ -218,8 +372,87 @@ void StatsFilter::filter(PointView& view)
 }
 
 
+std::vector<Summary> StatsFilter::emptySummaries() const
+{
+    std::vector<Summary> summaries;
+    for (auto p = m_stats.begin(); p != m_stats.end(); ++p)
+    {
+        const Summary& s = p->second;
+        summaries.emplace_back(s.name(), s.enumerateType(), s.advanced());
+    }
+    return summaries;
+}
+
+
+void StatsFilter::queueBlock()
+{
+    std::shared_ptr<DataVector> values(std::move(m_block));
+    point_count_t count = m_blockCount;
+    size_t block = m_nextBlock++;
+
+    m_block.reset(new DataVector(m_stats.size() * BlockSize));
+    m_blockCount = 0;
+
+    m_pool->add([this, values, count, block]()
+    {
+        std::vector<Summary> summaries(emptySummaries());
+        const double *column = values->data();
+        for (Summary& s : summaries)
+        {
+            for (point_count_t i = 0; i < count; ++i)
+                s.insert(column[i]);
+            column += BlockSize;
+        }
+        mergeBlock(block, std::move(summaries));
+    });
+}
+
+
+// Merge block summaries in block order so that the result doesn't depend on
+// which thread finished first.
+void StatsFilter::mergeBlock(size_t block, std::vector<Summary>&& summaries)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_pending.emplace(block, std::move(summaries));
+    for (auto it = m_pending.find(m_mergeBlock); it != m_pending.end();
+        it = m_pending.find(m_mergeBlock))
+    {
+        auto si = it->second.begin();
+        for (auto p = m_stats.begin(); p != m_stats.end(); ++p, ++si)
+            p->second.merge(*si);
+        m_pending.erase(it);
+        m_mergeBlock++;
+    }
+}
+
+
+void StatsFilter::ready(PointTableRef table)
+{
+    m_nextBlock = 0;
+    m_mergeBlock = 0;
+    m_blockCount = 0;
+    m_pending.clear();
+    if (m_threads > 1 && m_stats.size())
+    {
+        // Limit the queue so that buffered blocks don't pile up in
+        // stream mode.
+        m_pool.reset(new ThreadPool(m_threads, m_threads));
+        m_block.reset(new DataVector(m_stats.size() * BlockSize));
+    }
+}
+
+
 void StatsFilter::done(PointTableRef table)
 {
+    if (m_pool)
+    {
+        if (m_blockCount)
+            queueBlock();
+        m_pool->await();
+        m_pool.reset();
+        m_block.reset();
+    }
     extractMetadata(table);
 }
 
@@ -235,6 +468,8 @@ void StatsFilter::addArgs(ProgramArgs& args)
     args.add("count", "Dimensions whose values should be counted", m_counts);
     args.add("advanced", "Calculate skewness and kurtosis", m_advanced);
     args.add("commonsrs", "Common SRS to use for normalizing bounding boxes", m_commonSrs, "EPSG:4326");
+    args.add("threads", "Number of threads used to compute statistics",
+        m_threads, 1);
 }
 
 
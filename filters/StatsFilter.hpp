@@ -34,14 +34,61 @@
 
 #pragma once
 
+#include <memory>
+#include <mutex>
+
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 namespace pdal
 {
 namespace stats
 {
 
+typedef std::vector<double> DataVector;
+
+// Mergeable quantile sketch of bounded size.  Values are kept in levels, where
+// a value at level h stands for 2^h inserted values.  When a level fills it is
+// sorted and every other value is promoted to the next level.  Results are
+// exact for up to LevelSize values.
+class PDAL_EXPORT QuantileSketch
+{
+public:
+    static const size_t LevelSize = 16384;
+
+    QuantileSketch() : m_levels(1), m_odd(1), m_count(0)
+    {}
+
+    void insert(double value)
+    {
+        m_count++;
+        m_levels[0].push_back(value);
+        if (m_levels[0].size() > LevelSize)
+            compact(0);
+    }
+
+    void merge(const QuantileSketch& s);
+    void clear();
+    point_count_t count() const
+        { return m_count; }
+    // Value at quantile 'q' (0 - 1).
+    double quantile(double q) const;
+    // Median of the absolute deviations from 'center'.
+    double medianDeviation(double center) const;
+
+private:
+    typedef std::vector<std::pair<double, point_count_t>> WeightedValues;
+
+    void compact(size_t level);
+    WeightedValues weightedValues() const;
+    static double valueAtRank(const WeightedValues& values, double rank);
+
+    std::vector<DataVector> m_levels;
+    std::vector<bool> m_odd;
+    point_count_t m_count;
+};
+
 class PDAL_EXPORT Summary
 {
 public:
@@ -137,6 +184,10 @@ public:
         { return m_cnt; }
     std::string name() const
         { return m_name; }
+    EnumType enumerateType() const
+        { return m_enumerate; }
+    bool advanced() const
+        { return m_advanced; }
     const EnumMap& values() const
         { return m_values; }
 
@@ -162,11 +213,7 @@ public:
         if (m_enumerate != NoEnum)
             m_values[value]++;
         if (m_enumerate == Global)
-        {
-            if (m_data.capacity() - m_data.size() < 10000)
-                m_data.reserve(m_data.capacity() + m_cnt);
-            m_data.push_back(value);
-        }
+            m_sketch.insert(value);
 
         // stolen from http://www.johndcook.com/blog/skewness_kurtosis/
 
@@ -204,7 +251,7 @@ private:
     double m_mad;
     double m_median;
     EnumMap m_values;
-    DataVector m_data;
+    QuantileSketch m_sketch;
     point_count_t m_cnt;
     double M1, M2, M3, M4;
 };
@@ -230,9 +277,13 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual bool processOne(PointRef& point);
     virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
     virtual void done(PointTableRef table);
     virtual void filter(PointView& view);
     void extractMetadata(PointTableRef table);
+    std::vector<stats::Summary> emptySummaries() const;
+    void queueBlock();
+    void mergeBlock(size_t block, std::vector<stats::Summary>&& summaries);
 
     StringList m_dimNames;
     StringList m_enums;
@@ -240,7 +291,18 @@ private:
     StringList m_global;
     std::string m_commonSrs;
     bool m_advanced;
+    int m_threads;
     std::map<Dimension::Id, stats::Summary> m_stats;
+
+    // Threaded mode: points are summarized in blocks on the pool and the
+    // block summaries are merged into m_stats in block order.
+    std::unique_ptr<ThreadPool> m_pool;
+    std::mutex m_mutex;
+    std::map<size_t, std::vector<stats::Summary>> m_pending;
+    size_t m_nextBlock;
+    size_t m_mergeBlock;
+    std::shared_ptr<stats::DataVector> m_block;
+    point_count_t m_blockCount;
 };
 
 } // namespace pdal
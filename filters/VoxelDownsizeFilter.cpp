@@ -36,6 +36,8 @@
 
 #include "VoxelDownsizeFilter.hpp"
 
+#include <pdal/util/ThreadPool.hpp>
+
 namespace pdal
 {
 
@@ -81,7 +83,7 @@ std::ostream& operator<<(std::ostream& out,
 }
 
 
-VoxelDownsizeFilter::VoxelDownsizeFilter()
+VoxelDownsizeFilter::VoxelDownsizeFilter() : m_haveOrigin(false)
 {}
 
 
@@ -95,15 +97,24 @@ void VoxelDownsizeFilter::addArgs(ProgramArgs& args)
     args.add("cell", "Cell size", m_cell, 0.001);
     args.add("mode", "Method for downsizing : center / first",
         m_mode, Mode::Center);
+    args.add("threads", "Number of threads used in standard mode",
+        m_threads, (size_t)1);
 }
 
 
 void VoxelDownsizeFilter::ready(PointTableRef)
-{ m_populatedVoxels.clear(); }
+{
+    m_populatedVoxels.clear();
+    m_partitions.clear();
+    m_haveOrigin = false;
+}
 
 
 PointViewSet VoxelDownsizeFilter::run(PointViewPtr view)
 {
+    if (m_threads > 1)
+        return parallelRun(view);
+
     PointViewPtr output = view->makeNew();
     PointRef point(*view);
     for (PointId id = 0; id < view->size(); ++id)
@@ -119,6 +130,112 @@ PointViewSet VoxelDownsizeFilter::run(PointViewPtr view)
 }
 
 
+// Two passes. First, compute the voxel of every point, splitting the
+// points into chunks among threads. Each thread also sorts the IDs of its
+// chunk into partitions by voxel hash. Second, each thread takes a
+// partition and keeps the first point it sees in each voxel, visiting the
+// chunks in order. Every voxel belongs to exactly one partition and points
+// are visited in ID order, so the result is the same as a serial run.
+PointViewSet VoxelDownsizeFilter::parallelRun(PointViewPtr view)
+{
+    using namespace Dimension;
+
+    PointViewPtr output = view->makeNew();
+    PointViewSet viewSet;
+    viewSet.insert(output);
+
+    const point_count_t count = view->size();
+    if (!count)
+        return viewSet;
+
+    if (!m_haveOrigin)
+        setOrigin(view->getFieldAs<double>(Id::X, 0),
+            view->getFieldAs<double>(Id::Y, 0),
+            view->getFieldAs<double>(Id::Z, 0));
+
+    const size_t parts = m_threads;
+    m_partitions.resize(parts);
+
+    std::vector<VoxelKey> voxels(count);
+    std::vector<std::vector<PointIdList>> ids(parts,
+        std::vector<PointIdList>(parts));
+    ThreadPool pool(parts);
+    for (size_t c = 0; c < parts; ++c)
+        pool.add([this, &view, &voxels, &ids, c, count, parts]()
+        {
+            std::vector<PointIdList>& chunkIds = ids[c];
+            PointId end = (c + 1) * count / parts;
+            for (PointId i = c * count / parts; i < end; ++i)
+            {
+                VoxelKey& v = voxels[i];
+                v = voxel(view->getFieldAs<double>(Id::X, i),
+                    view->getFieldAs<double>(Id::Y, i),
+                    view->getFieldAs<double>(Id::Z, i));
+                // Use the high bits of the hash. The low bits choose the slot
+                // within the set.
+                chunkIds[(voxelHash(v) >> 32) % parts].push_back(i);
+            }
+        });
+    pool.await();
+
+    // Flags are chars rather than bools so that threads can set them
+    // independently.
+    std::vector<char> keep(count, 0);
+    for (size_t p = 0; p < parts; ++p)
+        pool.add([this, &view, &voxels, &ids, &keep, p, parts]()
+        {
+            VoxelSet& populated = m_partitions[p];
+            PointRef point(*view);
+            for (size_t c = 0; c < parts; ++c)
+                for (PointId i : ids[c][p])
+                    if (populated.insert(voxels[i]))
+                    {
+                        keep[i] = 1;
+                        if (m_mode == Mode::Center)
+                        {
+                            point.setPointId(i);
+                            setCenter(point, voxels[i]);
+                        }
+                    }
+        });
+    pool.await();
+
+    for (PointId i = 0; i < count; ++i)
+        if (keep[i])
+            output->appendPoint(*view, i);
+    return viewSet;
+}
+
+
+void VoxelDownsizeFilter::setOrigin(double x, double y, double z)
+{
+    m_originX = x - (m_cell / 2);
+    m_originY = y - (m_cell / 2);
+    m_originZ = z - (m_cell / 2);
+    m_haveOrigin = true;
+}
+
+
+VoxelKey VoxelDownsizeFilter::voxel(double x, double y, double z) const
+{
+    // Offset by origin.
+    x -= m_originX;
+    y -= m_originY;
+    z -= m_originZ;
+
+    return { (int)(std::floor(x / m_cell)), (int)(std::floor(y / m_cell)),
+        (int)(std::floor(z / m_cell)) };
+}
+
+
+void VoxelDownsizeFilter::setCenter(PointRef& point, const VoxelKey& v) const
+{
+    point.setField(Dimension::Id::X, (v.x + 0.5) * m_cell + m_originX);
+    point.setField(Dimension::Id::Y, (v.y + 0.5) * m_cell + m_originY);
+    point.setField(Dimension::Id::Z, (v.z + 0.5) * m_cell + m_originZ);
+}
+
+
 bool VoxelDownsizeFilter::voxelize(PointRef& point)
 {
     /*
@@ -128,31 +245,13 @@ bool VoxelDownsizeFilter::voxelize(PointRef& point)
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
     double z = point.getFieldAs<double>(Dimension::Id::Z);
-    if (m_populatedVoxels.empty())
-    {
-        m_originX = x - (m_cell / 2);
-        m_originY = y - (m_cell / 2);
-        m_originZ = z - (m_cell / 2);
-    }
+    if (!m_haveOrigin)
+        setOrigin(x, y, z);
 
-    // Offset by origin.
-    x -= m_originX;
-    y -= m_originY;
-    z -= m_originZ;
-
-    Voxel v = std::make_tuple((int)(std::floor(x / m_cell)),
-        (int)(std::floor(y / m_cell)), (int)(std::floor(z / m_cell)));
-
-    auto inserted = m_populatedVoxels.insert(v).second;
+    VoxelKey v = voxel(x, y, z);
+    bool inserted = m_populatedVoxels.insert(v);
     if ((m_mode == Mode::Center) && inserted)
-    {
-        point.setField(Dimension::Id::X,
-            (std::get<0>(v) + 0.5) * m_cell + m_originX);
-        point.setField(Dimension::Id::Y,
-            (std::get<1>(v) + 0.5) * m_cell + m_originY);
-        point.setField(Dimension::Id::Z,
-            (std::get<2>(v) + 0.5) * m_cell + m_originZ);
-    }
+        setCenter(point, v);
     return inserted;
 }
 
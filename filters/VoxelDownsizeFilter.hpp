@@ -39,6 +39,8 @@
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
+#include "private/VoxelMap.hpp"
+
 namespace pdal
 {
 
@@ -47,7 +49,6 @@ class PointView;
 
 class PDAL_EXPORT VoxelDownsizeFilter : public Filter, public Streamable
 {
-    using Voxel = std::tuple<int, int, int>;
     enum class Mode
     {
         First,
@@ -66,14 +67,21 @@ private:
     virtual void ready(PointTableRef) override;
     virtual bool processOne(PointRef& point) override;
 
+    PointViewSet parallelRun(PointViewPtr view);
     bool voxelize(PointRef& point);
+    void setOrigin(double x, double y, double z);
+    VoxelKey voxel(double x, double y, double z) const;
+    void setCenter(PointRef& point, const VoxelKey& v) const;
 
     double m_cell;
     double m_originX;
     double m_originY;
     double m_originZ;
-    std::set<Voxel> m_populatedVoxels;
+    bool m_haveOrigin;
+    VoxelSet m_populatedVoxels;
+    std::vector<VoxelSet> m_partitions;
     Mode m_mode;
+    size_t m_threads;
 
     friend std::istream& operator>>(std::istream& in,
         VoxelDownsizeFilter::Mode&);
@@ -72,4 +72,48 @@ void DisjointSet::unite(PointId x, PointId y)
     m_parent[y] = x;
 }
 
+
+ConcurrentDisjointSet::ConcurrentDisjointSet(point_count_t n) : m_parent(n)
+{
+    for (PointId i = 0; i < n; ++i)
+        m_parent[i].store(i, std::memory_order_relaxed);
+}
+
+// Find with path halving. A failed update of the path just means that another
+// thread changed it first, which is harmless.
+PointId ConcurrentDisjointSet::find(PointId x)
+{
+    while (true)
+    {
+        PointId parent = m_parent[x].load(std::memory_order_relaxed);
+        if (parent == x)
+            return x;
+        PointId grandparent = m_parent[parent].load(std::memory_order_relaxed);
+        if (parent != grandparent)
+            m_parent[x].compare_exchange_weak(parent, grandparent,
+                std::memory_order_relaxed);
+        x = grandparent;
+    }
+}
+
+void ConcurrentDisjointSet::unite(PointId x, PointId y)
+{
+    while (true)
+    {
+        x = find(x);
+        y = find(y);
+        if (x == y)
+            return;
+
+        // Link the root with the higher ID under the other one. If the root
+        // was linked elsewhere in the meantime, try again.
+        if (x > y)
+            std::swap(x, y);
+        PointId expected = y;
+        if (m_parent[y].compare_exchange_strong(expected, x,
+                std::memory_order_acq_rel))
+            return;
+    }
+}
+
 } // namespace pdal
@@ -34,6 +34,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <vector>
+
+#include <pdal/pdal_export.hpp>
 #include <pdal/pdal_types.hpp>
 
 namespace pdal
@@ -50,4 +54,18 @@ private:
     PointIdList m_parent;
 };
 
+// Disjoint set that can be updated from multiple threads without locking.
+// Sets are always linked under the root with the lower ID, so the root of
+// a set is its smallest member once all updates are complete.
+class PDAL_EXPORT ConcurrentDisjointSet
+{
+public:
+    ConcurrentDisjointSet(point_count_t n);
+    PointId find(PointId x);
+    void unite(PointId x, PointId y);
+
+private:
+    std::vector<std::atomic<PointId>> m_parent;
+};
+
 } // namespace pdal
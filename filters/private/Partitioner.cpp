@@ -0,0 +1,135 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "Partitioner.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace pdal
+{
+
+namespace
+{
+
+const uint32_t NoGroup = (std::numeric_limits<uint32_t>::max)();
+
+} // unnamed namespace
+
+// Number the distinct keys in order of first appearance.  On return 'keys'
+// holds the distinct keys and the result holds the group of each entry.
+std::vector<uint32_t> Partitioner::groupIndexes(
+    std::vector<int64_t>& keys) const
+{
+    std::vector<uint32_t> groups(m_keys.size());
+    keys.clear();
+
+    auto minmax = std::minmax_element(m_keys.begin(), m_keys.end());
+    int64_t minKey = *minmax.first;
+    uint64_t range = (uint64_t)*minmax.second - (uint64_t)minKey;
+
+    // Keys that are dense enough are looked up directly in a table.
+    // Otherwise (for 2D cell keys, for example) use a hash of the keys.
+    if (range < m_keys.size() + 65536)
+    {
+        std::vector<uint32_t> slots(range + 1, NoGroup);
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            uint32_t& slot = slots[(uint64_t)m_keys[i] - (uint64_t)minKey];
+            if (slot == NoGroup)
+            {
+                slot = (uint32_t)keys.size();
+                keys.push_back(m_keys[i]);
+            }
+            groups[i] = slot;
+        }
+    }
+    else
+    {
+        std::unordered_map<int64_t, uint32_t> slots;
+        for (size_t i = 0; i < m_keys.size(); ++i)
+        {
+            // Neighboring points usually share a key, so skip the lookup.
+            if (i && m_keys[i] == m_keys[i - 1])
+            {
+                groups[i] = groups[i - 1];
+                continue;
+            }
+            auto res = slots.insert({ m_keys[i], (uint32_t)keys.size() });
+            if (res.second)
+                keys.push_back(m_keys[i]);
+            groups[i] = res.first->second;
+        }
+    }
+    return groups;
+}
+
+
+std::vector<Partitioner::Group> Partitioner::partition()
+{
+    std::vector<Group> out;
+    if (m_keys.empty())
+        return out;
+
+    std::vector<int64_t> keys;
+    std::vector<uint32_t> groups = groupIndexes(keys);
+
+    // Counting sort of the ids by group.
+    std::vector<size_t> offsets(keys.size() + 1);
+    for (uint32_t g : groups)
+        offsets[g + 1]++;
+    for (size_t g = 1; g < offsets.size(); ++g)
+        offsets[g] += offsets[g - 1];
+
+    m_sorted.resize(m_ids.size());
+    std::vector<size_t> pos(offsets.begin(), offsets.end() - 1);
+    for (size_t i = 0; i < m_ids.size(); ++i)
+        m_sorted[pos[groups[i]]++] = m_ids[i];
+
+    const PointId *base = m_sorted.data();
+    for (size_t g = 0; g < keys.size(); ++g)
+        out.push_back({ keys[g], base + offsets[g], base + offsets[g + 1] });
+    return out;
+}
+
+
+void Partitioner::clear()
+{
+    m_keys.clear();
+    m_ids.clear();
+    m_sorted.clear();
+}
+
+} // namespace pdal
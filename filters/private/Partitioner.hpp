@@ -0,0 +1,98 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <pdal/pdal_export.hpp>
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+// Groups point ids by an integer key.  Keys and ids are collected into flat
+// arrays and then counting-sorted by key, so that the ids of each group are
+// contiguous in a single buffer.  Ids keep their insertion order within a
+// group and groups are returned in order of first appearance.
+class PDAL_EXPORT Partitioner
+{
+public:
+    struct Group
+    {
+        int64_t key;
+        const PointId *begin;
+        const PointId *end;
+    };
+
+    void reserve(size_t size)
+    {
+        m_keys.reserve(size);
+        m_ids.reserve(size);
+    }
+
+    // Pack a 2D cell coordinate into a key that sorts like the coordinate.
+    static int64_t cellKey(int x, int y)
+        { return (int64_t)x * 0x100000000LL + ((int64_t)y + 0x80000000LL); }
+
+    static std::pair<int, int> cell(int64_t key)
+    {
+        int64_t y = (key & 0xFFFFFFFFLL) - 0x80000000LL;
+        int64_t x = (key - (y + 0x80000000LL)) / 0x100000000LL;
+        return { (int)x, (int)y };
+    }
+
+    void add(int64_t key, PointId id)
+    {
+        m_keys.push_back(key);
+        m_ids.push_back(id);
+    }
+
+    // Sort the ids by key.  The returned groups refer to storage owned by
+    // the partitioner and are valid until the next call to partition()
+    // or clear().
+    std::vector<Group> partition();
+    void clear();
+
+private:
+    std::vector<uint32_t> groupIndexes(std::vector<int64_t>& keys) const;
+
+    std::vector<int64_t> m_keys;
+    PointIdList m_ids;
+    PointIdList m_sorted;
+};
+
+} // namespace pdal
@@ -37,8 +37,12 @@
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_types.hpp>
 
+#include <pdal/util/ThreadPool.hpp>
+
 #include "DimRange.hpp"
+#include "DisjointSet.hpp"
 
+#include <limits>
 #include <vector>
 
 namespace pdal
@@ -80,78 +84,103 @@ private:
 std::istream& operator>>(std::istream& in, PointClasses& classes);
 std::ostream& operator<<(std::ostream& out, const PointClasses& classes);
 
+// Number of points handled by a task when work is split among threads.
+constexpr point_count_t BlockSize = 4096;
+
+/**
+  Call a function for consecutive blocks of point IDs in [0, count), using a
+  pool of threads.
+
+  \param[in] count the number of points.
+  \param[in] threads the number of threads to use.
+  \param[in] f the function to call with the first and one past the last ID
+    of each block. It is called from multiple threads and must not throw.
+*/
+template <typename Func>
+void forEachBlock(point_count_t count, size_t threads, Func f)
+{
+    if (threads <= 1 || count <= BlockSize)
+    {
+        f(0, count);
+        return;
+    }
+
+    ThreadPool pool(threads);
+    for (PointId begin = 0; begin < count; begin += BlockSize)
+    {
+        PointId end = (std::min)(begin + BlockSize, count);
+        pool.add([&f, begin, end]() { f(begin, end); });
+    }
+    pool.await();
+}
+
 /**
   Extract clusters of points from input PointView.
 
-  For each point, find neighbors within a given tolerance (Euclidean distance).
-  If a neighbor already belongs to another cluster, skip it. Otherwise, add it
-  to the current cluster. Recursively visit newly added cluster points, looking
-  for neighbors to add to the cluster.
+  Each point is joined with the neighbors within a given tolerance (Euclidean
+  distance) in a disjoint set. The neighbor searches are split among threads.
+  Clusters are ordered by their lowest point ID and the points of a cluster
+  are in ID order.
 
   \param[in] view the input PointView.
   \param[in] min_points the minimum number of points in a cluster.
   \param[in] max_points the maximum number of points in a cluster.
   \param[in] tolerance the tolerance for adding points to a cluster.
+  \param[in] threads the number of threads used for neighbor searches.
   \returns a deque of clusters (themselves vectors of PointIds).
 */
 template <class KDINDEX>
 PDAL_EXPORT std::deque<PointIdList> extractClusters(PointView& view, uint64_t min_points,
-                                                 uint64_t max_points, double tolerance)
+    uint64_t max_points, double tolerance, size_t threads = 1)
 {
     // Index the incoming PointView for subsequent radius searches.
     KDINDEX kdi(view);
     kdi.build();
 
-    // Create variables to track PointIds that have already been added to
-    // clusters and to build the list of cluster indices.
-    PointIdList processed(view.size(), 0);
-    std::deque<PointIdList> clusters;
+    const point_count_t count = view.size();
 
-    for (PointId i = 0; i < view.size(); ++i)
+    // Join each point with its neighbors. The neighbor relation is symmetric,
+    // so each point only needs to be joined with the neighbors that have
+    // higher IDs.
+    ConcurrentDisjointSet sets(count);
+    forEachBlock(count, threads, [&kdi, &sets, tolerance](PointId begin, PointId end)
     {
-        // Points can only belong to a single cluster.
-        if (processed[i])
-            continue;
-
-        // Initialize list of indices belonging to current cluster, marking the
-        // seed point as processed.
-        PointIdList seed_queue;
-        size_t sq_idx = 0;
-        seed_queue.push_back(i);
-        processed[i] = 1;
-
-        // Check each point in the cluster for additional neighbors within the
-        // given tolerance, remembering that the list can grow if we add points
-        // to the cluster.
-        while (sq_idx < seed_queue.size())
+        typename KDINDEX::RadiusResults neighbors;
+        for (PointId i = begin; i < end; ++i)
         {
-            // Find neighbors of the next cluster point.
-            PointId j = seed_queue[sq_idx];
-            PointIdList ids = kdi.radius(j, tolerance);
-
-            // The case where the only neighbor is the query point.
-            if (ids.size() == 1)
-            {
-                sq_idx++;
-                continue;
-            }
-
-            // Skip neighbors that already belong to a cluster and add the rest
-            // to this cluster.
-            for (auto const& k : ids)
-            {
-                if (processed[k])
-                    continue;
-                seed_queue.push_back(k);
-                processed[k] = 1;
-            }
-
-            sq_idx++;
+            kdi.radius(i, tolerance, neighbors);
+            for (auto const& n : neighbors)
+                if ((PointId)n.first > i)
+                    sets.unite(i, (PointId)n.first);
         }
+    });
 
-        // Keep clusters that are within the min/max number of points.
-        if (seed_queue.size() >= min_points && seed_queue.size() <= max_points)
-            clusters.push_back(seed_queue);
+    // The root of each set is its lowest point ID. Count the points of each
+    // set and number the sets that are within the min/max number of points.
+    const PointId NoCluster = (std::numeric_limits<PointId>::max)();
+    PointIdList slots(count, 0);
+    for (PointId i = 0; i < count; ++i)
+        slots[sets.find(i)]++;
+
+    std::deque<PointIdList> clusters;
+    for (PointId i = 0; i < count; ++i)
+    {
+        point_count_t size = slots[i];
+        if (size && size >= min_points && size <= max_points)
+        {
+            slots[i] = clusters.size();
+            clusters.emplace_back();
+            clusters.back().reserve(size);
+        }
+        else
+            slots[i] = NoCluster;
+    }
+
+    for (PointId i = 0; i < count; ++i)
+    {
+        PointId slot = slots[sets.find(i)];
+        if (slot != NoCluster)
+            clusters[slot].push_back(i);
     }
 
     return clusters;
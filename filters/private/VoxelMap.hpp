@@ -0,0 +1,197 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace pdal
+{
+
+// Integer coordinates of a voxel.
+struct VoxelKey
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+
+    bool operator==(const VoxelKey& other) const
+        { return x == other.x && y == other.y && z == other.z; }
+    bool operator!=(const VoxelKey& other) const
+        { return !(*this == other); }
+};
+
+// Hash of a voxel's coordinates. Coordinates are mixed with the
+// splitmix64 finalizer so that both the high and low bits are usable.
+inline uint64_t voxelHash(const VoxelKey& key)
+{
+    uint64_t h = ((uint64_t)(uint32_t)key.x << 32) ^ (uint32_t)key.y;
+    h ^= (uint64_t)(uint32_t)key.z * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return h;
+}
+
+/**
+  Hash map from voxel to value using open addressing with linear probing.
+  All entries live in a single array, so there is no allocation per voxel
+  and lookups touch few cache lines. Slots are chosen from the low bits of
+  voxelHash(). Entries can't be removed.
+*/
+template<typename T>
+class VoxelMap
+{
+    struct Entry
+    {
+        VoxelKey key;
+        bool used;
+        T value;
+    };
+
+public:
+    VoxelMap()
+        { clear(); }
+
+    // Remove all entries and release memory.
+    void clear()
+    {
+        std::vector<Entry> entries(MinCapacity);
+        m_entries.swap(entries);
+        m_size = 0;
+    }
+
+    std::size_t size() const
+        { return m_size; }
+
+    bool empty() const
+        { return m_size == 0; }
+
+    // Bytes allocated for the table.
+    std::size_t memory() const
+        { return m_entries.size() * sizeof(Entry); }
+
+    /**
+      Find the value associated with a voxel.
+
+      \param key  Voxel to find.
+      \return  Pointer to the value or nullptr if the voxel isn't in the map.
+    */
+    T *find(const VoxelKey& key)
+    {
+        Entry& e = slot(key);
+        return e.used ? &e.value : nullptr;
+    }
+
+    /**
+      Add a voxel to the map if it's not already present.
+
+      \param key  Voxel to add.
+      \param value  Value to associate with the voxel if it's added.
+      \return  Pointer to the value associated with the voxel and true if
+        the voxel was added.
+    */
+    std::pair<T *, bool> insert(const VoxelKey& key, const T& value = T())
+    {
+        Entry *e = &slot(key);
+        if (e->used)
+            return { &e->value, false };
+
+        // Grow when the table would be more than 3/4 full.
+        if ((m_size + 1) * 4 > m_entries.size() * 3)
+        {
+            grow();
+            e = &slot(key);
+        }
+        e->key = key;
+        e->used = true;
+        e->value = value;
+        m_size++;
+        return { &e->value, true };
+    }
+
+private:
+    static const std::size_t MinCapacity = 1024;
+
+    // Find the entry for a key or the empty entry where it would go.
+    Entry& slot(const VoxelKey& key)
+    {
+        const std::size_t mask = m_entries.size() - 1;
+        std::size_t pos = voxelHash(key) & mask;
+        while (m_entries[pos].used && m_entries[pos].key != key)
+            pos = (pos + 1) & mask;
+        return m_entries[pos];
+    }
+
+    void grow()
+    {
+        std::vector<Entry> old(m_entries.size() * 2);
+        m_entries.swap(old);
+        for (Entry& e : old)
+            if (e.used)
+                slot(e.key) = e;
+    }
+
+    std::vector<Entry> m_entries;
+    std::size_t m_size;
+};
+
+// Set of voxels.
+class VoxelSet
+{
+public:
+    void clear()
+        { m_map.clear(); }
+    std::size_t size() const
+        { return m_map.size(); }
+    bool empty() const
+        { return m_map.empty(); }
+    std::size_t memory() const
+        { return m_map.memory(); }
+
+    // Add a voxel. Returns true if the voxel wasn't already in the set.
+    bool insert(const VoxelKey& key)
+        { return m_map.insert(key).second; }
+    bool contains(const VoxelKey& key)
+        { return m_map.find(key) != nullptr; }
+
+private:
+    VoxelMap<char> m_map;
+};
+
+} // namespace pdal
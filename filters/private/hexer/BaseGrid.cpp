@@ -54,6 +54,17 @@ void BaseGrid::setHexes(const std::vector<HexId>& ids)
     }
 }
 
+// The possible roots are the dense hexagons without a dense neighbor at
+// edge 0, so they're found again for the new limit.
+void BaseGrid::setDenseLimit(int limit)
+{
+    m_denseLimit = limit;
+    m_possibleRoots.clear();
+    for (auto& [hex, count] : m_counts)
+        if (count >= m_denseLimit && !isDense(edgeHex(hex, 0)))
+            addRoot(hex);
+}
+
 void BaseGrid::flushSamples()
 {
     if (m_sample.empty())
@@ -42,6 +42,8 @@ public:
         { return m_counts; }
     int denseLimit() const
         { return m_denseLimit; }
+    // changes the density threshold of hexagons that already hold points
+    void setDenseLimit(int limit);
 
     // test function: adds pre-defined hexagon coordinates to the grid
     void setHexes(const std::vector<HexId>& hexes);
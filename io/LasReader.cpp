@@ -36,6 +36,7 @@
 #include "LasReader.hpp"
 #include "private/las/ChunkInfo.hpp"
 #include "private/las/Header.hpp"
+#include "private/las/SpatialIndex.hpp"
 #include "private/las/Srs.hpp"
 #include "private/las/Tile.hpp"
 #include "private/las/Utils.hpp"
@@ -64,6 +65,8 @@ namespace
 {
 
 constexpr int DefaultNumThreads = 7;
+// Number of points read by a task for uncompressed files.
+constexpr uint64_t StandardChunkSize = 50'000;
 
 struct invalid_stream : public std::runtime_error
 {
@@ -141,7 +144,10 @@ struct LasReader::Options
     PointId start;
     bool nosrs;
     int numThreads;
+    bool useMmap;
     SrsOrderSpec srsVlrOrder;
+    Bounds bounds;
+    std::string indexFilename;
 };
 
 struct LasReader::Private
@@ -172,9 +178,74 @@ struct LasReader::Private
     std::condition_variable processedCv;
     bool isRemote;
     std::unique_ptr<connector::Connector> connector;
-
-    Private() : apiHeader(header, srs, vlrs), index(0), pool(DefaultNumThreads), isRemote(false)
+    // Mapping of the local file. When the file is mapped, chunk tasks read point data
+    // directly from memory rather than opening a stream per chunk.
+    FileUtils::MapContext map;
+    const char *mapData;
+    uint64_t mapSize;
+    // Region to which points are clipped. For 2D bounds, Z is unlimited.
+    BOX3D clip;
+    bool doClip;
+    // Chunks that can be skipped because the spatial index shows they have no points
+    // in the clip region. Empty if no chunks are skipped.
+    std::vector<bool> skipChunks;
+
+    Private() : apiHeader(header, srs, vlrs), index(0), pool(DefaultNumThreads), isRemote(false),
+        mapData(nullptr), mapSize(0), doClip(false)
     {}
+
+    // The range of points [first, last) that we read from chunk 'c'.
+    std::pair<uint64_t, uint64_t> chunkRange(uint32_t c)
+    {
+        uint64_t first;
+        uint64_t last;
+        if (header.dataCompressed())
+        {
+            first = (std::max)((uint64_t)chunkInfo.firstPoint(c), (uint64_t)opts.start);
+            last = (uint64_t)chunkInfo.firstPoint(c) + chunkInfo.chunkPoints(c);
+        }
+        else
+        {
+            first = opts.start + c * StandardChunkSize;
+            last = first + StandardChunkSize;
+        }
+        return { first, (std::min)(last, (uint64_t)end) };
+    }
+
+    // Number of chunks that make up the file.
+    uint32_t numChunks()
+    {
+        if (header.dataCompressed())
+            return (uint32_t)chunkInfo.numChunks();
+        return (uint32_t)((end - opts.start + StandardChunkSize - 1) / StandardChunkSize);
+    }
+
+    bool skipChunk(uint32_t c) const
+    {
+        return c < skipChunks.size() && skipChunks[c];
+    }
+
+    // Whether the point in a LAS point buffer is in the clip region.
+    bool inClip(const char *buf) const
+    {
+        if (!doClip)
+            return true;
+
+        int32_t xi, yi, zi;
+        LeExtractor in(buf, 3 * sizeof(int32_t));
+        in >> xi >> yi >> zi;
+        return clip.contains(xi * header.scale.x + header.offset.x,
+            yi * header.scale.y + header.offset.y, zi * header.scale.z + header.offset.z);
+    }
+
+    // Address of 'size' bytes at 'offset' in the mapped LAS data, or nullptr if the
+    // range isn't mapped.
+    const char *mapped(uint64_t offset, uint64_t size) const
+    {
+        if (!mapData || offset > mapSize || size > mapSize - offset)
+            return nullptr;
+        return mapData + offset;
+    }
 };
 
 LasReader::LasReader() : d(new Private)
@@ -196,8 +267,13 @@ void LasReader::addArgs(ProgramArgs& args)
         "invalid characters to '_'", d->opts.fixNames, true);
     args.add("nosrs", "Skip reading/processing file SRS", d->opts.nosrs);
     args.add("threads", "Thread pool size", d->opts.numThreads, DefaultNumThreads);
+    args.add("mmap", "Read point data from a memory map of the file", d->opts.useMmap, true);
     args.add("srs_vlr_order", "Preference order to read SRS VLRs",
         d->opts.srsVlrOrder);
+    args.add("bounds", "Only read points inside these bounds", d->opts.bounds);
+    args.add("index", "Spatial index file used to skip data outside of 'bounds'. "
+        "Defaults to the file name with an '.lsi' extension, if it exists.",
+        d->opts.indexFilename);
 }
 
 
@@ -467,6 +543,8 @@ void LasReader::ready(PointTableRef table)
         return;
 
     d->pool.resize(d->opts.numThreads);
+    if (d->opts.useMmap)
+        mapFile();
     LasStreamPtr lasStream(createStream());
     std::istream& stream(*lasStream);
 
@@ -509,12 +587,106 @@ void LasReader::ready(PointTableRef table)
         d->nextReadChunk = 0;
     }
 
+    selectChunks();
+
     for (int i = 0; i < d->opts.numThreads; ++i)
         d->queueNext();
 }
 
+void LasReader::selectChunks()
+{
+    d->doClip = !d->opts.bounds.empty();
+    d->skipChunks.clear();
+    if (!d->doClip)
+        return;
+
+    if (d->opts.bounds.is3d())
+        d->clip = d->opts.bounds.to3d();
+    else
+    {
+        d->clip = BOX3D(d->opts.bounds.to2d());
+        d->clip.minz = (std::numeric_limits<double>::lowest)();
+        d->clip.maxz = (std::numeric_limits<double>::max)();
+    }
+
+    std::string filename = d->opts.indexFilename;
+    if (filename.empty())
+    {
+        // We don't look for an index next to remote files.
+        if (d->isRemote)
+            return;
+        filename = las::SpatialIndex::filename(m_filename);
+        if (!FileUtils::fileExists(filename))
+        {
+            log()->get(LogLevel::Debug) << "No spatial index found for '" << m_filename <<
+                "'. All points will be read to check against 'bounds'.\n";
+            return;
+        }
+    }
+
+    las::SpatialIndex index;
+    try
+    {
+        index.load(filename, d->header.pointCount());
+    }
+    catch (const pdal_error& err)
+    {
+        // A missing or stale default index isn't an error -- just read all the data.
+        if (d->opts.indexFilename.size())
+            throwError(err.what());
+        log()->get(LogLevel::Warning) << err.what() << " Ignoring index.\n";
+        return;
+    }
+
+    uint32_t numChunks = d->numChunks();
+    uint32_t skipped = 0;
+    d->skipChunks.resize(numChunks);
+    for (uint32_t c = d->nextFetchChunk; c < numChunks; ++c)
+    {
+        auto range = d->chunkRange(c);
+        if (range.first >= range.second)
+            break;
+        if (!index.overlaps(range.first, range.second, d->clip))
+        {
+            d->skipChunks[c] = true;
+            skipped++;
+        }
+    }
+    log()->get(LogLevel::Debug) << "Spatial index '" << filename << "' allows skipping " <<
+        skipped << " of " << numChunks << " chunks.\n";
+}
+
+void LasReader::mapFile()
+{
+    if (d->map.addr())
+        return;
+
+    d->map = FileUtils::mapFile(m_filename);
+    if (!d->map.addr())
+    {
+        log()->get(LogLevel::Debug) << "Unable to map '" << m_filename << "': " <<
+            d->map.what() << ". Reading with streams.\n";
+        return;
+    }
+
+    uint64_t offset = dataOffset();
+    if (offset > d->map.m_size)
+    {
+        d->map = FileUtils::unmapFile(d->map);
+        return;
+    }
+    d->mapData = (const char *)d->map.addr() + offset;
+    d->mapSize = d->map.m_size - offset;
+}
+
 void LasReader::queueNextCompressedChunk()
 {
+    while (d->nextFetchChunk < d->chunkInfo.numChunks() && d->skipChunk(d->nextFetchChunk))
+    {
+        d->nextFetchChunk++;
+        d->nextFetchPoint = 0;
+    }
+
     if ((d->nextFetchChunk >= d->chunkInfo.numChunks()) ||
         (d->chunkInfo.firstPoint(d->nextFetchChunk) >= d->end))
         return;
@@ -528,18 +700,26 @@ void LasReader::queueNextCompressedChunk()
         uint64_t chunkoffset = d->chunkInfo.chunkOffset(chunk);
         uint32_t chunksize = d->chunkInfo.chunkSize(chunk);
 
-        LasStreamPtr lasStream = createStream();
-        std::istream& in(*lasStream);
+        // Decompress straight from the mapped file when we can. Otherwise copy the
+        // chunk into a buffer.
+        std::vector<char> buf;
+        const char *src = d->mapped(chunkoffset, chunksize);
+        if (!src)
+        {
+            LasStreamPtr lasStream = createStream();
+            std::istream& in(*lasStream);
 
-        std::vector<char> buf(chunksize);
-        in.seekg(chunkoffset);
-        in.read(buf.data(), buf.size());
+            buf.resize(chunksize);
+            in.seekg(chunkoffset);
+            in.read(buf.data(), buf.size());
+            src = buf.data();
+        }
 
         int32_t tilepoints = chunkpoints - start;
         las::TilePtr tile = std::make_unique<las::Tile>(chunk, tilepoints * d->header.pointSize);
 
         lazperf::reader::chunk_decompressor decomp(d->header.pointFormat(), d->header.ebCount(),
-            buf.data());
+            src);
 
         // We have to decompress all the points, even if we're discarding the points at
         // the front because nextFetchPoint isn't 0. Just reuse the front of the tile
@@ -573,7 +753,20 @@ void LasReader::queueNextCompressedChunk()
 
 void LasReader::queueNextStandardChunk()
 {
-    const uint64_t chunkSize = 50'000;
+    const uint64_t chunkSize = StandardChunkSize;
+
+    // This check is just to prevent overflow.
+    auto advance = [this, chunkSize]()
+    {
+        if (d->nextFetchPoint > (std::numeric_limits<uint64_t>::max)() - chunkSize)
+            d->nextFetchPoint = d->end;
+        else
+            d->nextFetchPoint += chunkSize;
+        d->nextFetchChunk++;
+    };
+
+    while (d->nextFetchPoint < d->end && d->skipChunk(d->nextFetchChunk))
+        advance();
 
     if (d->nextFetchPoint >= d->end)
         return;
@@ -583,12 +776,19 @@ void LasReader::queueNextStandardChunk()
     uint64_t count = (std::min)(chunkSize, d->end - start);
     d->pool.add([this, chunk, count, start]()
     {
-        LasStreamPtr lasStream = createStream();
-        std::istream& in(*lasStream);
-
         las::TilePtr tile = std::make_unique<las::Tile>(chunk, count * d->header.pointSize);
-        in.seekg(d->header.pointOffset + start * d->header.pointSize);
-        in.read(tile->data(), tile->size());
+        uint64_t offset = d->header.pointOffset + start * d->header.pointSize;
+        const char *src = d->mapped(offset, tile->size());
+        if (src)
+            std::copy(src, src + tile->size(), tile->data());
+        else
+        {
+            LasStreamPtr lasStream = createStream();
+            std::istream& in(*lasStream);
+
+            in.seekg(offset);
+            in.read(tile->data(), tile->size());
+        }
 
         {
             std::unique_lock l(d->mutex);
@@ -604,12 +804,7 @@ void LasReader::queueNextStandardChunk()
         d->processedCv.notify_one();
     });
 
-    // This check is just to prevent overflow.
-    if (d->nextFetchPoint > (std::numeric_limits<uint64_t>::max)() - chunkSize)
-        d->nextFetchPoint = d->end;
-    else
-        d->nextFetchPoint += chunkSize;
-    d->nextFetchChunk++;
+    advance();
 }
 
 void LasReader::readExtraBytesVlr()
@@ -696,35 +891,50 @@ bool LasReader::processOne(PointRef& point)
         return las::TilePtr();
     };
 
-    if (eof())
-        return false;
-
-    // If we don't have an active tile, get the next one or wait for it to be ready.
-    if (!d->currentTile)
+    while (!eof())
     {
+        // If we don't have an active tile, get the next one or wait for it to be ready.
+        if (!d->currentTile)
         {
-            std::unique_lock<std::mutex> l(d->mutex);
-            while (true)
+            while (d->skipChunk(d->nextReadChunk))
+                d->nextReadChunk++;
+            if (d->nextReadChunk >= d->numChunks() ||
+                d->chunkRange(d->nextReadChunk).first >= d->end)
             {
-                d->currentTile = getTile(d->nextReadChunk);
-                if (d->currentTile)
-                    break;
-                d->processedCv.wait(l);
+                d->index = getNumPoints();
+                break;
             }
-        }
 
-        // Found the tile we wanted. Queue the next file read.
-        d->nextReadChunk++;
-        d->queueNext();
-    }
+            {
+                std::unique_lock<std::mutex> l(d->mutex);
+                while (true)
+                {
+                    d->currentTile = getTile(d->nextReadChunk);
+                    if (d->currentTile)
+                        break;
+                    d->processedCv.wait(l);
+                }
+            }
 
-    // Load the point and advance the tile location.
-    d->loadPoint(point, d->currentTile->pos(), d->header.pointSize);
-    if (!d->currentTile->advance(d->header.pointSize))
-        d->currentTile.reset();
+            // Found the tile we wanted. Queue the next file read.
+            d->index = d->chunkRange(d->nextReadChunk).first - d->opts.start;
+            d->nextReadChunk++;
+            d->queueNext();
+        }
 
-    d->index++;
-    return true;
+        // Load the point if it's wanted and advance the tile location.
+        const char *pos = d->currentTile->pos();
+        bool keep = d->inClip(pos);
+        if (keep)
+            d->loadPoint(point, pos, d->header.pointSize);
+        if (!d->currentTile->advance(d->header.pointSize))
+            d->currentTile.reset();
+
+        d->index++;
+        if (keep)
+            return true;
+    }
+    return false;
 }
 
 point_count_t LasReader::read(PointViewPtr view, point_count_t count)
@@ -735,7 +945,8 @@ point_count_t LasReader::read(PointViewPtr view, point_count_t count)
     for (i = 0; i < count; i++)
     {
         PointRef point = view->point(i);
-        processOne(point);
+        if (!processOne(point))
+            break;
         if (m_cb)
             m_cb(*view, view->size() - 1);
     }
@@ -933,6 +1144,10 @@ void LasReader::done(PointTableRef)
 void LasReader::cleanup()
 {
     d->pool.join();
+    if (d->map.addr())
+        d->map = FileUtils::unmapFile(d->map);
+    d->mapData = nullptr;
+    d->mapSize = 0;
     if (d->isRemote)
         FileUtils::deleteFile(m_filename);
 }
@@ -940,7 +1155,7 @@ void LasReader::cleanup()
 bool LasReader::eof()
 {
     // This breaks when the number of points is the maximum (2^64 - 1), but that's never happening.
-    return d->index >= d->end;
+    return d->index >= getNumPoints();
 }
 
 
@@ -107,6 +107,10 @@ public:
 
 protected:
     virtual LasStreamPtr createStream();
+    // Offset of the LAS data in the file. Non-zero when the LAS data is embedded
+    // in some other file.
+    virtual uint64_t dataOffset() const
+        { return 0; }
 
 private:
     virtual void addArgs(ProgramArgs& args);
@@ -129,6 +133,8 @@ private:
 
     void cleanup();
     void tryLoadRemote();
+    void mapFile();
+    void selectChunks();
     bool eof();
     void queueNextCompressedChunk();
     void queueNextStandardChunk();
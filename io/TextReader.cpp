@@ -32,8 +32,13 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <charconv>
+#include <cstring>
+#include <thread>
+
 #include <pdal/PDALUtils.hpp>
 #include <pdal/util/Algorithm.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include "TextReader.hpp"
 #include "../filters/StatsFilter.hpp"
@@ -53,6 +58,109 @@ CREATE_STATIC_STAGE(TextReader, s_info)
 
 std::string TextReader::getName() const { return s_info.name; }
 
+namespace
+{
+
+// Initial size of the read buffer.  The buffer grows if a line doesn't fit.
+const size_t BufferSize = 1 << 20;
+
+// Amount of text parsed by each thread at a time in standard mode.
+const size_t RangeSize = 1 << 22;
+
+typedef std::pair<const char *, const char *> Span;
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Convert a field to a double.  As with stream extraction, leading
+// whitespace and a leading '+' are accepted and anything following the
+// number is ignored.
+bool convert(const char *pos, const char *end, double& d)
+{
+    while (pos != end && isBlank(*pos))
+        pos++;
+    if (pos != end && *pos == '+')
+        pos++;
+#ifdef __cpp_lib_to_chars
+    auto res = std::from_chars(pos, end, d);
+    return res.ec == std::errc() && res.ptr != pos;
+#else
+    return Utils::fromString(std::string(pos, end), d);
+#endif
+}
+
+// Split the line [pos, end) into fields and pass each converted value to
+// 'sink'.  Fields beyond 'numFields' are counted but not converted.  Fields
+// that can't be converted are passed to the sink as 0 and added to 'bad'.
+// Returns the number of fields found.  A line without fields is empty.
+template<typename Sink>
+size_t parseLine(const char *pos, const char *end, char separator,
+    size_t numFields, std::vector<Span>& bad, Sink&& sink)
+{
+    bad.clear();
+    if (pos != end && end[-1] == '\r')
+        end--;
+
+    size_t field = 0;
+    auto convertField = [&](const char *fieldEnd)
+    {
+        if (field < numFields)
+        {
+            double d;
+            if (!convert(pos, fieldEnd, d))
+            {
+                bad.emplace_back(pos, fieldEnd);
+                d = 0;
+            }
+            sink(field, d);
+        }
+        field++;
+    };
+
+    if (separator == ' ')
+    {
+        // Runs of spaces separate fields.
+        while (true)
+        {
+            while (pos != end && *pos == ' ')
+                pos++;
+            if (pos == end)
+                break;
+            const char *next = (const char *)std::memchr(pos, ' ', end - pos);
+            if (!next)
+                next = end;
+            convertField(next);
+            pos = next;
+        }
+    }
+    else if (pos != end)
+    {
+        while (true)
+        {
+            const char *next =
+                (const char *)std::memchr(pos, separator, end - pos);
+            if (!next)
+                next = end;
+            convertField(next);
+            if (next == end)
+                break;
+            pos = next + 1;
+        }
+    }
+    return field;
+}
+
+// Find the first position after a newline at or after 'pos'.
+const char *nextLineStart(const char *pos, const char *end)
+{
+    const char *nl = (const char *)std::memchr(pos, '\n', end - pos);
+    return nl ? nl + 1 : end;
+}
+
+} // unnamed namespace
+
 // NOTE: - Forces reading of the entire file.
 QuickInfo TextReader::inspect()
 {
@@ -227,6 +335,9 @@ void TextReader::addArgs(ProgramArgs& args)
     args.add("header", "Use this string as the header line.", m_header);
     args.add("skip", "Skip this number of lines before attempting to "
         "read the header.", m_skip);
+    args.add("threads", "Number of threads used to parse the file in "
+        "standard mode.", m_threads,
+        (int)(std::max)(1U, std::thread::hardware_concurrency()));
 }
 
 
@@ -254,12 +365,20 @@ void TextReader::ready(PointTableRef table)
 
     std::string dummy;
     for (size_t i = 0; i < m_line; ++i)
-	std::getline(*m_istream, dummy);
+        std::getline(*m_istream, dummy);
+
+    m_buf.resize(BufferSize);
+    m_pos = 0;
+    m_end = 0;
+    m_eof = false;
 }
 
 
 point_count_t TextReader::read(PointViewPtr view, point_count_t numPts)
 {
+    if (m_threads > 1 && numPts == (std::numeric_limits<point_count_t>::max)())
+        return readParallel(*view);
+
     PointId idx = view->size();
     point_count_t cnt = 0;
     PointRef point(*view);
@@ -275,64 +394,207 @@ point_count_t TextReader::read(PointViewPtr view, point_count_t numPts)
 }
 
 
-bool TextReader::processOne(PointRef& point)
+point_count_t TextReader::readParallel(PointView& view)
 {
-    if (!fillFields())
-        return false;
+    // Points parsed from one range of a block.
+    struct Range
+    {
+        const char *begin;
+        const char *end;
+        size_t lines;
+        std::vector<double> values;
+        std::vector<Span> bad;
+        // Line (relative to the range), field count and bad field for
+        // each line with an error.
+        std::vector<std::tuple<size_t, size_t, std::string>> errors;
+    };
+
+    const size_t numFields = m_dims.size();
+    std::vector<Range> ranges(m_threads);
+    ThreadPool pool(m_threads);
+
+    auto parseRange = [this, numFields](Range& r)
+    {
+        r.lines = 0;
+        r.values.clear();
+        r.errors.clear();
+        for (const char *pos = r.begin; pos != r.end;)
+        {
+            const char *lineEnd =
+                (const char *)std::memchr(pos, '\n', r.end - pos);
+            const char *next = lineEnd ? lineEnd + 1 : r.end;
+            if (!lineEnd)
+                lineEnd = r.end;
+            r.lines++;
+
+            size_t start = r.values.size();
+            size_t fields = parseLine(pos, lineEnd, m_separator, numFields,
+                r.bad, [&r](size_t, double d){ r.values.push_back(d); });
+            pos = next;
+            if (fields == 0)
+                continue;
+            if (fields != numFields)
+            {
+                r.values.resize(start);
+                r.errors.emplace_back(r.lines, fields, std::string());
+                continue;
+            }
+            for (const Span& s : r.bad)
+                r.errors.emplace_back(r.lines, fields,
+                    std::string(s.first, s.second));
+        }
+    };
 
-    double d;
-    for (size_t i = 0; i < m_fields.size(); ++i)
+    m_buf.resize((std::max)(m_buf.size(), m_threads * RangeSize));
+    point_count_t cnt = 0;
+    PointRef point(view);
+    while (fillBuffer())
     {
-        if (!Utils::fromString(m_fields[i], d))
+        const char *begin = m_buf.data() + m_pos;
+        const char *end = m_buf.data() + m_end;
+
+        // Parse only complete lines unless this is the end of the file.
+        if (!m_eof)
         {
-            log()->get(LogLevel::Error) << "Can't convert "
-                "field '" << m_fields[i] << "' to numeric value on line " <<
-                m_line << " in '" << m_filename << "'.  Setting to 0." <<
-                std::endl;
-            d = 0;
+            while (end != begin && end[-1] != '\n')
+                end--;
+            if (end == begin)
+                continue;
+        }
+        m_pos = end - m_buf.data();
+
+        // Split the block into line-aligned ranges.
+        size_t step = (end - begin) / m_threads;
+        const char *pos = begin;
+        for (int i = 0; i < m_threads; ++i)
+        {
+            Range& r = ranges[i];
+            r.begin = pos;
+            r.end = (i == m_threads - 1) ?
+                end : nextLineStart((std::max)(pos, begin + step * (i + 1)),
+                    end);
+            pos = r.end;
+            pool.add([&parseRange, &r](){ parseRange(r); });
+        }
+        pool.await();
+
+        // Append the points in file order.
+        for (Range& r : ranges)
+        {
+            for (auto& e : r.errors)
+            {
+                size_t line = m_line + std::get<0>(e);
+                if (std::get<2>(e).empty() && std::get<1>(e) != numFields)
+                    logFieldCount(line, std::get<1>(e));
+                else
+                    logConversion(line, std::get<2>(e));
+            }
+            m_line += r.lines;
+
+            for (auto vi = r.values.begin(); vi != r.values.end();)
+            {
+                point.setPointId(view.size());
+                for (size_t i = 0; i < numFields; ++i)
+                    point.setField(m_dims[i], *vi++);
+                cnt++;
+            }
         }
-        point.setField(m_dims[i], d);
     }
-    return true;
+    return cnt;
 }
 
 
-bool TextReader::fillFields()
+bool TextReader::fillBuffer()
+{
+    size_t partial = m_end - m_pos;
+    if (m_eof)
+        return partial != 0;
+
+    std::memmove(m_buf.data(), m_buf.data() + m_pos, partial);
+    if (partial == m_buf.size())
+        m_buf.resize(m_buf.size() * 2);
+    m_istream->read(m_buf.data() + partial, m_buf.size() - partial);
+    m_pos = 0;
+    m_end = partial + (size_t)m_istream->gcount();
+    if (!m_istream->good())
+        m_eof = true;
+    return m_end != 0;
+}
+
+
+bool TextReader::nextLine(const char *& begin, const char *& end)
 {
     while (true)
     {
-        if (!m_istream->good())
+        begin = m_buf.data() + m_pos;
+        const char *last = m_buf.data() + m_end;
+        const char *nl = (const char *)std::memchr(begin, '\n', last - begin);
+        if (nl)
+        {
+            end = nl;
+            m_pos = nl - m_buf.data() + 1;
+            return true;
+        }
+        // The last line of the file needn't end with a newline.
+        if (m_eof)
+        {
+            end = last;
+            m_pos = m_end;
+            return begin != end;
+        }
+        if (!fillBuffer())
             return false;
+    }
+}
 
-        std::string buf;
 
-        std::getline(*m_istream, buf);
+bool TextReader::processOne(PointRef& point)
+{
+    const char *begin;
+    const char *end;
+    while (nextLine(begin, end))
+    {
         m_line++;
-        if (buf.empty())
+        size_t fields = parseLine(begin, end, m_separator, m_dims.size(),
+            m_badFields, [this, &point](size_t i, double d)
+                { point.setField(m_dims[i], d); });
+        if (fields == 0)
             continue;
-        if (m_separator != ' ')
+        if (fields != m_dims.size())
         {
-            Utils::remove(buf, ' ');
-            m_fields = Utils::split(buf, m_separator);
-        }
-        else
-            m_fields = Utils::split2(buf, m_separator);
-        if (m_fields.size() != m_dims.size())
-        {
-            log()->get(LogLevel::Error) << "Line " << m_line <<
-                " in '" << m_filename << "' contains " << m_fields.size() <<
-                " fields when " << m_dims.size() << " were expected.  "
-                "Ignoring." << std::endl;
+            logFieldCount(m_line, fields);
             continue;
         }
+        for (const Span& s : m_badFields)
+            logConversion(m_line, std::string(s.first, s.second));
         return true;
     }
+    return false;
+}
+
+
+void TextReader::logFieldCount(size_t line, size_t fields)
+{
+    log()->get(LogLevel::Error) << "Line " << line <<
+        " in '" << m_filename << "' contains " << fields <<
+        " fields when " << m_dims.size() << " were expected.  "
+        "Ignoring." << std::endl;
+}
+
+
+void TextReader::logConversion(size_t line, const std::string& field)
+{
+    log()->get(LogLevel::Error) << "Can't convert "
+        "field '" << field << "' to numeric value on line " <<
+        line << " in '" << m_filename << "'.  Setting to 0." <<
+        std::endl;
 }
 
 
 void TextReader::done(PointTableRef table)
 {
     Utils::closeFile(m_istream);
+    m_buf = std::vector<char>();
 }
 
 
@@ -35,6 +35,7 @@
 #pragma once
 
 #include <istream>
+#include <vector>
 
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
@@ -111,7 +112,35 @@ private:
     */
     virtual bool processOne(PointRef& point);
 
-    bool fillFields();
+    /**
+      Read the remainder of the file in blocks, parsing line-aligned ranges
+      of each block in parallel.
+
+      \param view  PointView in which to insert point data.
+      \return  Number of points read.
+    */
+    point_count_t readParallel(PointView& view);
+
+    /**
+      Get the next line from the read buffer, refilling it as necessary.
+      The line doesn't include the terminating newline.
+
+      \param begin  Set to the start of the line.
+      \param end  Set to the end of the line.
+      \return  False if there are no more lines.
+    */
+    bool nextLine(const char *& begin, const char *& end);
+
+    /**
+      Move any unparsed data to the front of the read buffer and fill the
+      rest from the input stream.
+
+      \return  False if no data remains.
+    */
+    bool fillBuffer();
+
+    void logFieldCount(size_t line, size_t fields);
+    void logConversion(size_t line, const std::string& field);
 
     /**
       Parse a header line into a list of dimension names.
@@ -148,10 +177,17 @@ private:
     std::istream *m_istream;
     StringList m_dimNames;
     Dimension::IdList m_dims;
-    StringList m_fields;
     size_t m_line;
     std::string m_header;
     size_t m_skip;
+    int m_threads;
+
+    // Read buffer.  Unparsed data is in [m_pos, m_end).
+    std::vector<char> m_buf;
+    size_t m_pos;
+    size_t m_end;
+    bool m_eof;
+    std::vector<std::pair<const char *, const char *>> m_badFields;
 };
 
 } // namespace pdal
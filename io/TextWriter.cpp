@@ -39,8 +39,12 @@
 #include <pdal/PointView.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
+#include <charconv>
 #include <iostream>
+#include <sstream>
+#include <thread>
 
 namespace pdal
 {
@@ -81,6 +85,41 @@ std::ostream& operator << (std::ostream& out,
     return out;
 }
 
+namespace
+{
+
+// Size at which buffered output is written to the stream.
+const size_t FlushSize = 1 << 20;
+
+// Number of points formatted by each thread at a time in standard mode.
+const point_count_t BlockSize = 16384;
+
+// Append 'd' in fixed notation with 'precision' digits after the decimal
+// point.  The result is the same as streaming with std::fixed.
+void appendValue(std::string& buf, double d, size_t precision)
+{
+#ifdef __cpp_lib_to_chars
+    char tmp[128];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), d,
+        std::chars_format::fixed, (int)precision);
+    if (res.ec == std::errc())
+    {
+        buf.append(tmp, res.ptr);
+        return;
+    }
+#endif
+    // Very large values or precisions.
+    std::ostringstream oss;
+    oss.imbue(std::locale::classic());
+    oss << std::fixed;
+    oss.precision(precision);
+    oss << d;
+    buf += oss.str();
+}
+
+} // unnamed namespace
+
+
 struct FileStreamDeleter
 {
 
@@ -109,6 +148,9 @@ void TextWriter::addArgs(ProgramArgs& args)
     args.add("quote_header", "Whether a header should be quoted",
         m_quoteHeader, true);
     args.add("precision", "Output precision", m_precision, 3);
+    args.add("threads", "Number of threads used to format points in "
+        "standard mode", m_threads,
+        (int)(std::max)(1U, std::thread::hardware_concurrency()));
 }
 
 
@@ -163,6 +205,8 @@ void TextWriter::ready(PointTableRef table)
         throwError("Couldn't open '" + filename() + "' for output.");
 
     *m_stream << std::fixed;
+    m_buf.clear();
+    m_buf.reserve(FlushSize + 4096);
 
     m_xDim = { Dimension::Id::X, static_cast<size_t>(m_precision),
         table.layout()->dimName(Dimension::Id::X) };
@@ -219,6 +263,7 @@ void TextWriter::writeHeader(PointTableRef table)
 
 void TextWriter::writeFooter()
 {
+    flush();
     if (m_outputType == OutputType::GEOJSON)
     {
         *m_stream << "]}";
@@ -254,56 +299,79 @@ void TextWriter::writeCSVHeader(PointTableRef table)
 }
 
 
-void TextWriter::processOneCSV(PointRef& point)
+void TextWriter::formatCSV(PointRef& point, std::string& buf) const
 {
     for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
     {
         if (di != m_dims.begin())
-            *m_stream << m_delimiter;
-        m_stream->precision(di->precision);
-        *m_stream << point.getFieldAs<double>(di->id);
+            buf += m_delimiter;
+        appendValue(buf, point.getFieldAs<double>(di->id), di->precision);
     }
-    *m_stream << m_newline;
+    buf += m_newline;
 }
 
-void TextWriter::processOneGeoJSON(PointRef& point)
+
+void TextWriter::formatGeoJSON(PointRef& point, PointId idx,
+    std::string& buf) const
 {
-    if (m_idx > 0)
-        *m_stream << ",";
-    *m_stream << "{ \"type\":\"Feature\",\"geometry\": "
+    if (idx > 0)
+        buf += ",";
+    buf += "{ \"type\":\"Feature\",\"geometry\": "
         "{ \"type\": \"Point\", \"coordinates\": [";
 
-    m_stream->precision(m_xDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::X) << ",";
-    m_stream->precision(m_yDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::Y) << ",";
-    m_stream->precision(m_zDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::Z) << "]},";
+    appendValue(buf, point.getFieldAs<double>(Dimension::Id::X),
+        m_xDim.precision);
+    buf += ",";
+    appendValue(buf, point.getFieldAs<double>(Dimension::Id::Y),
+        m_yDim.precision);
+    buf += ",";
+    appendValue(buf, point.getFieldAs<double>(Dimension::Id::Z),
+        m_zDim.precision);
+    buf += "]},";
 
-    *m_stream << "\"properties\": {";
+    buf += "\"properties\": {";
 
     for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
     {
         if (di != m_dims.begin())
-            *m_stream << ",";
+            buf += ",";
 
-        *m_stream << "\"" << di->name << "\":";
-        *m_stream << "\"";
-        m_stream->precision(di->precision);
-        *m_stream << point.getFieldAs<double>(di->id);
-        *m_stream <<"\"";
+        buf += "\"";
+        buf += di->name;
+        buf += "\":\"";
+        appendValue(buf, point.getFieldAs<double>(di->id), di->precision);
+        buf += "\"";
     }
-    *m_stream << "}"; // end properties
-    *m_stream << "}"; // end feature
+    buf += "}"; // end properties
+    buf += "}"; // end feature
 }
 
 
-bool TextWriter::processOne(PointRef& point)
+void TextWriter::formatPoint(PointRef& point, PointId idx,
+    std::string& buf) const
 {
     if (m_outputType == OutputType::CSV)
-        processOneCSV(point);
+        formatCSV(point, buf);
     else
-        processOneGeoJSON(point);
+        formatGeoJSON(point, idx, buf);
+}
+
+
+void TextWriter::flush()
+{
+    if (m_buf.size())
+    {
+        m_stream->write(m_buf.data(), m_buf.size());
+        m_buf.clear();
+    }
+}
+
+
+bool TextWriter::processOne(PointRef& point)
+{
+    formatPoint(point, m_idx, m_buf);
+    if (m_buf.size() >= FlushSize)
+        flush();
     m_idx++;
     return true;
 }
@@ -311,13 +379,47 @@ bool TextWriter::processOne(PointRef& point)
 
 void TextWriter::write(const PointViewPtr view)
 {
-    PointRef point(*view, 0);
+    const point_count_t count = view->size();
+    if (m_threads <= 1 || count <= BlockSize)
+    {
+        PointRef point(*view, 0);
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            processOne(point);
+        }
+        return;
+    }
 
-    for (PointId idx = 0; idx < view->size(); ++idx)
+    // Format a window of blocks in parallel, then write them in order.
+    flush();
+    ThreadPool pool(m_threads);
+    std::vector<std::string> bufs(m_threads);
+    for (PointId start = 0; start < count; start += BlockSize * m_threads)
     {
-        point.setPointId(idx);
-        processOne(point);
+        for (int i = 0; i < m_threads; ++i)
+        {
+            PointId begin = start + i * BlockSize;
+            PointId end = (std::min)(begin + BlockSize, count);
+            std::string& buf = bufs[i];
+            buf.clear();
+            if (begin >= end)
+                continue;
+            pool.add([this, &view, &buf, begin, end]()
+            {
+                PointRef point(*view, 0);
+                for (PointId idx = begin; idx < end; ++idx)
+                {
+                    point.setPointId(idx);
+                    formatPoint(point, m_idx + idx, buf);
+                }
+            });
+        }
+        pool.await();
+        for (const std::string& buf : bufs)
+            m_stream->write(buf.data(), buf.size());
     }
+    m_idx += count;
 }
 
 
@@ -80,8 +80,10 @@ private:
     void writeFooter();
     void writeGeoJSONHeader();
     void writeCSVHeader(PointTableRef table);
-    void processOneCSV(PointRef& point);
-    void processOneGeoJSON(PointRef& point);
+    void formatCSV(PointRef& point, std::string& buf) const;
+    void formatGeoJSON(PointRef& point, PointId idx, std::string& buf) const;
+    void formatPoint(PointRef& point, PointId idx, std::string& buf) const;
+    void flush();
 
     DimSpec extractDim(std::string dim, PointTableRef table);
     bool findDim(Dimension::Id id, DimSpec& ds);
@@ -95,8 +97,12 @@ private:
     std::string m_delimiter;
     bool m_quoteHeader;
     int m_precision;
+    int m_threads;
     PointId m_idx;
 
+    // Formatted output not yet written to the stream.
+    std::string m_buf;
+
     FileStreamPtr m_stream;
     std::vector<DimSpec> m_dims;
     DimSpec m_xDim;
@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <algorithm>
+
+#include <pdal/pdal_types.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/IStream.hpp>
+#include <pdal/util/OStream.hpp>
+
+#include "SpatialIndex.hpp"
+
+namespace pdal
+{
+namespace las
+{
+
+namespace
+{
+
+const std::string Signature("PLSI");
+const uint32_t Version = 1;
+
+} // unnamed namespace
+
+SpatialIndex::SpatialIndex(uint64_t rangeSize) :
+    m_rangeSize((std::max)(rangeSize, (uint64_t)1)), m_pointCount(0)
+{}
+
+
+std::string SpatialIndex::filename(const std::string& lasFilename)
+{
+    return lasFilename + ".lsi";
+}
+
+
+void SpatialIndex::add(double x, double y, double z)
+{
+    if (m_entries.empty() || m_entries.back().count == m_rangeSize)
+        m_entries.push_back({ m_pointCount, 0, BOX3D() });
+
+    Entry& e = m_entries.back();
+    e.bounds.grow(x, y, z);
+    e.count++;
+    m_pointCount++;
+}
+
+
+void SpatialIndex::save(const std::string& filename) const
+{
+    OLeStream out(filename);
+    if (!out.isOpen())
+        throw pdal_error("Unable to create spatial index file '" + filename + "'.");
+
+    out.put(Signature);
+    out << Version << m_pointCount << m_rangeSize << (uint64_t)m_entries.size();
+    for (const Entry& e : m_entries)
+        out << e.first << e.count << e.bounds.minx << e.bounds.miny << e.bounds.minz <<
+            e.bounds.maxx << e.bounds.maxy << e.bounds.maxz;
+    out.close();
+}
+
+
+void SpatialIndex::load(const std::string& filename, uint64_t pointCount)
+{
+    auto fail = [&filename](const std::string& err)
+    {
+        throw pdal_error("Invalid spatial index file '" + filename + "': " + err);
+    };
+
+    m_entries.clear();
+    m_pointCount = 0;
+
+    ILeStream in(filename);
+    if (!in)
+        throw pdal_error("Unable to open spatial index file '" + filename + "'.");
+
+    std::string signature;
+    uint32_t version;
+    uint64_t indexPoints;
+    uint64_t numEntries;
+
+    in.get(signature, Signature.size());
+    in >> version >> indexPoints >> m_rangeSize >> numEntries;
+    if (!in || signature != Signature)
+        fail("bad signature.");
+    if (version != Version)
+        fail("unsupported version " + std::to_string(version) + ".");
+    if (indexPoints != pointCount)
+        fail("index is for " + std::to_string(indexPoints) + " points but the file "
+            "contains " + std::to_string(pointCount) + ".");
+
+    for (uint64_t i = 0; i < numEntries; ++i)
+    {
+        Entry e;
+        in >> e.first >> e.count >> e.bounds.minx >> e.bounds.miny >> e.bounds.minz >>
+            e.bounds.maxx >> e.bounds.maxy >> e.bounds.maxz;
+        if (!in)
+            fail("unexpected end of file.");
+
+        // Entries must cover the points in order without gaps.
+        if (e.first != m_pointCount)
+            fail("range " + std::to_string(i) + " doesn't start at point " +
+                std::to_string(m_pointCount) + ".");
+        m_pointCount += e.count;
+        m_entries.push_back(e);
+    }
+    if (m_pointCount != pointCount)
+        fail("index doesn't cover all points.");
+}
+
+
+bool SpatialIndex::overlaps(uint64_t first, uint64_t last, const BOX3D& box) const
+{
+    // Find the first entry that ends after 'first'.
+    auto it = std::upper_bound(m_entries.begin(), m_entries.end(), first,
+        [](uint64_t point, const Entry& e) { return point < e.first + e.count; });
+    for (; it != m_entries.end() && it->first < last; ++it)
+        if (it->count && box.overlaps(it->bounds))
+            return true;
+    return false;
+}
+
+} // namespace las
+} // namespace pdal
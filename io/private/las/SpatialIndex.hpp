@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+namespace las
+{
+
+// Bounds of consecutive ranges of points in a LAS file. The index is stored in a
+// sidecar file next to the LAS file so that a reader can skip data that can't
+// intersect a query region.
+class PDAL_EXPORT SpatialIndex
+{
+public:
+    struct Entry
+    {
+        // Index of the first point in the range.
+        uint64_t first;
+        // Number of points in the range.
+        uint64_t count;
+        BOX3D bounds;
+    };
+
+    static const uint64_t DefaultRangeSize = 50'000;
+
+    SpatialIndex(uint64_t rangeSize = DefaultRangeSize);
+
+    // Name of the sidecar file for a LAS file.
+    static std::string filename(const std::string& lasFilename);
+
+    // Add the next point of the file to the index.
+    void add(double x, double y, double z);
+
+    // Write the index. Throws pdal_error on failure.
+    void save(const std::string& filename) const;
+
+    // Read an index built for a file with 'pointCount' points. Throws pdal_error
+    // if the file can't be read or doesn't cover the points of the LAS file.
+    void load(const std::string& filename, uint64_t pointCount);
+
+    // Whether any of the points in the range [first, last) may be inside 'box'.
+    bool overlaps(uint64_t first, uint64_t last, const BOX3D& box) const;
+
+    uint64_t pointCount() const
+        { return m_pointCount; }
+    const std::vector<Entry>& entries() const
+        { return m_entries; }
+
+private:
+    uint64_t m_rangeSize;
+    uint64_t m_pointCount;
+    std::vector<Entry> m_entries;
+};
+
+} // namespace las
+} // namespace pdal
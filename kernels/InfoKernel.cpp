@@ -36,6 +36,7 @@
 
 #include <ctime>
 #include <algorithm>
+#include <thread>
 
 #include <pdal/pdal_config.hpp>
 #include <pdal/pdal_features.hpp>
@@ -66,6 +67,7 @@ std::string InfoKernel::getName() const { return s_info.name; }
 
 InfoKernel::InfoKernel() : m_showStats(false), m_showSchema(false),
     m_showAll(false), m_showMetadata(false), m_boundary(false),
+    m_boundaryResolution(0), m_boundaryCount(0),
     m_showSummary(false), m_needPoints(false), m_statsStage(nullptr),
     m_hexbinStage(nullptr), m_infoStage(nullptr), m_reader(nullptr)
 {}
@@ -100,6 +102,17 @@ void InfoKernel::validateSwitches(ProgramArgs& args)
         functions++;
         m_needPoints = true;
     }
+    if (m_boundaryResolution < 0)
+        throw pdal_error("'boundary_resolution' can't be negative.");
+    if (m_boundaryResolution > 0)
+    {
+        // Only the upper octree levels are read, which is no good for anything
+        // but the boundary.
+        if (m_showStats || m_stac || m_queryPoint.size() || m_pointIndexes.size())
+            throw pdal_error("'boundary_resolution' can't be used with options "
+                "that need all points ('stats', 'stac', 'query', 'point' or 'all').");
+        m_boundary = true;
+    }
     if (m_boundary)
     {
         functions++;
@@ -161,10 +174,15 @@ void InfoKernel::addSwitches(ProgramArgs& args)
         m_breakoutDimension );
     args.add("boundary", "Compute a hexagonal hull/boundary of dataset",
         m_boundary);
+    args.add("boundary_resolution", "Compute the boundary from the octree "
+        "levels of a COPC or EPT dataset down to this resolution rather than "
+        "from all points. Implies 'boundary'.", m_boundaryResolution);
     args.add("dimensions", "Dimensions on which to compute statistics",
         m_dimensions);
     args.add("enumerate", "Dimensions whose values should be enumerated",
         m_enumerate);
+    args.add("threads", "Number of threads used to compute statistics",
+        m_threads, (int)std::thread::hardware_concurrency());
     args.add("schema", "Dump the schema", m_showSchema);
     args.add("pipeline-serialization", "Output filename for pipeline "
         "serialization", m_pipelineFile);
@@ -183,6 +201,8 @@ void InfoKernel::makeReader(const std::string& filename)
     Options rOps;
     if (!m_needPoints)
         rOps.add("count", 0);
+    if (m_boundaryResolution > 0)
+        rOps.add("resolution", m_boundaryResolution);
     m_reader = &(m_manager.makeReader(filename, m_driverOverride, rOps));
 }
 
@@ -205,6 +225,7 @@ void InfoKernel::makePipeline()
             filterOptions.add({"dimensions", m_dimensions});
         if (m_enumerate.size())
             filterOptions.add({"enumerate", m_enumerate});
+        filterOptions.add("threads", m_threads);
         stage = m_statsStage =
             &m_manager.makeFilter("filters.stats", *stage, filterOptions);
 
@@ -229,13 +250,19 @@ void InfoKernel::makePipeline()
             Options stacOps;
             if (m_enumerate.size())
                 stacOps.add({"enumerate", m_enumerate});
+            stacOps.add("threads", m_threads);
             m_stacStage = stage = &m_manager.makeFilter("filters.stats", *stage, stacOps);
         }
         else
             m_stacStage = stage;
     }
     if (m_boundary)
-        m_hexbinStage = &m_manager.makeFilter("filters.hexbin", *stage);
+    {
+        Options hexOps;
+        if (m_boundaryCount)
+            hexOps.add("point_count", m_boundaryCount);
+        m_hexbinStage = &m_manager.makeFilter("filters.hexbin", *stage, hexOps);
+    }
 }
 
 MetadataNode InfoKernel::run(const std::string& filename)
@@ -247,6 +274,10 @@ MetadataNode InfoKernel::run(const std::string& filename)
 
     uint64_t pointCountOverride = 0;
 
+    if (m_boundaryResolution > 0 &&
+            readerDriver != "readers.copc" && readerDriver != "readers.ept")
+        throw pdal_error("'boundary_resolution' requires COPC or EPT input.");
+
     if (!m_needPoints && readerDriver == "readers.las" && Utils::isRemote(filename))
     {
         auto pointless = getPointlessLasFile(filename);
@@ -257,6 +288,16 @@ MetadataNode InfoKernel::run(const std::string& filename)
     else
         makeReader(filename);
 
+    // For a coarse boundary, get the total number of points from the octree so
+    // that the density reflects all points, not just those read.
+    m_boundaryCount = 0;
+    if (m_boundaryResolution > 0)
+    {
+        QuickInfo qi = m_reader->preview();
+        if (qi.valid())
+            m_boundaryCount = qi.m_pointCount;
+    }
+
     root.add("filename", filename);
     root.add("pdal_version", Config::fullVersionString());
 
@@ -77,11 +77,14 @@ private:
     bool m_showAll;
     bool m_showMetadata;
     bool m_boundary;
+    double m_boundaryResolution;
+    point_count_t m_boundaryCount;
     bool m_stac;
     std::string m_breakoutDimension;
     std::string m_pointIndexes;
     std::string m_dimensions;
     std::string m_enumerate;
+    int m_threads;
     std::string m_queryPoint;
     std::string m_pipelineFile;
     std::string m_pcType;
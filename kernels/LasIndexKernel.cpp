@@ -0,0 +1,121 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "LasIndexKernel.hpp"
+
+#include <pdal/PointTable.hpp>
+#include <filters/StreamCallbackFilter.hpp>
+#include <io/LasReader.hpp>
+#include <io/private/las/SpatialIndex.hpp>
+#include <io/private/las/Vlr.hpp>
+#include <lazperf/vlr.hpp>
+
+namespace pdal
+{
+
+static StaticPluginInfo const s_info
+{
+    "kernels.lasindex",
+    "LAS Spatial Index Kernel",
+    "https://pdal.org/apps/lasindex.html"
+};
+
+CREATE_STATIC_KERNEL(LasIndexKernel, s_info)
+
+std::string LasIndexKernel::getName() const
+{
+    return s_info.name;
+}
+
+
+void LasIndexKernel::addSwitches(ProgramArgs& args)
+{
+    args.add("input,i", "Input LAS/LAZ filename", m_inputFile).setPositional();
+    args.add("output,o", "Output index filename. Defaults to the input "
+        "filename with an '.lsi' extension.", m_outputFile);
+    args.add("range_size", "Number of points in each indexed range. Defaults "
+        "to the LAZ chunk size.", m_rangeSize);
+}
+
+
+int LasIndexKernel::execute()
+{
+    if (m_outputFile.empty())
+        m_outputFile = las::SpatialIndex::filename(m_inputFile);
+
+    Stage& reader = makeReader(m_inputFile, "readers.las");
+    LasReader *lasReader = dynamic_cast<LasReader *>(&reader);
+    if (!lasReader)
+        throw pdal_error("Input file '" + m_inputFile + "' must be read with "
+            "readers.las.");
+
+    StreamCallbackFilter f;
+    f.setInput(reader);
+
+    FixedPointTable table(10000);
+    f.prepare(table);
+
+    // Index ranges are aligned with the LAZ chunks by default so that a reader can
+    // skip whole chunks.
+    uint64_t rangeSize = m_rangeSize;
+    if (rangeSize == 0)
+    {
+        rangeSize = las::SpatialIndex::DefaultRangeSize;
+        const char *data;
+        uint64_t size = lasReader->vlrData(las::LaszipUserId,
+            las::LaszipRecordId, data);
+        if (size)
+        {
+            lazperf::laz_vlr vlr;
+            vlr.fill(data, size);
+            if (!lazperf::laz_vlr::variableChunks(vlr.chunk_size))
+                rangeSize = vlr.chunk_size;
+        }
+    }
+
+    las::SpatialIndex index(rangeSize);
+    f.setCallback([&index](PointRef& p)
+    {
+        index.add(p.getFieldAs<double>(Dimension::Id::X),
+            p.getFieldAs<double>(Dimension::Id::Y),
+            p.getFieldAs<double>(Dimension::Id::Z));
+        return true;
+    });
+    f.execute(table);
+
+    index.save(m_outputFile);
+    return 0;
+}
+
+} // namespace pdal
@@ -57,7 +57,8 @@ CREATE_STATIC_KERNEL(PipelineKernel, s_info)
 
 std::string PipelineKernel::getName() const { return s_info.name; }
 
-PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1)
+PipelineKernel::PipelineKernel() : m_validate(false), m_progressFd(-1),
+    m_profile(false)
 {}
 
 
@@ -77,6 +78,8 @@ void PipelineKernel::validateSwitches(ProgramArgs& args)
         m_mode = ExecMode::Standard;
     else
         m_mode = ExecMode::PreferStream;
+    if (m_traceFile.size())
+        m_profile = true;
 }
 
 
@@ -106,6 +109,11 @@ void PipelineKernel::addSwitches(ProgramArgs& args)
         m_stream);
     args.add("nostream", "Run in standard mode.", m_noStream);
     args.add("metadata", "Metadata filename", m_metadataFile);
+    args.add("profile", "Profile stage execution.  The profile is written "
+        "with the metadata or to standard output if no metadata file is "
+        "given.", m_profile);
+    args.add("profile_trace", "Write a Chrome trace-event file of stage "
+        "execution to this filename.  Implies 'profile'.", m_traceFile);
     args.add("dims", "Dimensions to be stored", m_dimNames);
 }
 
@@ -150,6 +158,7 @@ int PipelineKernel::execute()
     if (!m_manager.hasReader())
         throw pdal_error("Pipeline does not start with a reader.");
     m_manager.setAllowedDims(m_dimNames);
+    m_manager.setProfiling(m_profile, m_traceFile.size());
     if (m_manager.execute(m_mode).m_mode == ExecMode::None)
         throw pdal_error("Couldn't run pipeline in requested execution mode.");
 
@@ -162,6 +171,18 @@ int PipelineKernel::execute()
         Utils::toJSON(m_manager.getMetadata(), *out);
         Utils::closeFile(out);
     }
+    else if (m_profile)
+        Utils::toJSON(m_manager.profiler()->toMetadata(), std::cout);
+
+    if (m_traceFile.size())
+    {
+        std::ostream *out = Utils::createFile(m_traceFile, false);
+        if (!out)
+            throw pdal_error("Can't open file '" + m_traceFile +
+                "' for trace output.");
+        m_manager.profiler()->writeTrace(*out);
+        Utils::closeFile(out);
+    }
     if (m_pipelineFile.size())
         PipelineWriter::writePipeline(m_manager.getStage(), m_pipelineFile);
 
@@ -64,6 +64,8 @@ private:
     bool m_usestdin;
     bool m_stream;
     bool m_noStream;
+    bool m_profile;
+    std::string m_traceFile;
     ExecMode m_mode;
     StringList m_dimNames;
 };
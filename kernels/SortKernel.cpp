@@ -34,7 +34,18 @@
 
 #include "SortKernel.hpp"
 
+#include <fstream>
+#include <queue>
+#include <thread>
+
+#include "arbiter/arbiter.hpp"
+
 #include <pdal/Stage.hpp>
+#include <pdal/StageWrapper.hpp>
+#include <pdal/Streamable.hpp>
+#include <pdal/private/SpaceCurve.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Uuid.hpp>
 
 namespace pdal
 {
@@ -53,8 +64,83 @@ std::string SortKernel::getName() const
     return s_info.name;
 }
 
+namespace
+{
+
+// Number of points in the table used to pass points between stages.
+const point_count_t StreamTableSize = 1000;
+
+// Buffered, sequential access to a sorted run stored in a temporary file.
+// Each record is a 64-bit key followed by a packed point.
+class RunReader
+{
+public:
+    RunReader(const std::string& filename, size_t recordSize,
+            size_t bufRecords) :
+        m_in(filename, std::ios::binary), m_recordSize(recordSize),
+        m_buf(recordSize * bufRecords), m_pos(0), m_end(0)
+    {
+        if (!m_in)
+            throw pdal_error("Unable to open sort run file '" +
+                filename + "'.");
+    }
+
+    // Advance to the next record. Returns false when the run is exhausted.
+    bool next()
+    {
+        m_pos += m_recordSize;
+        if (m_pos < m_end)
+            return true;
+        m_in.read(m_buf.data(), m_buf.size());
+        m_pos = 0;
+        m_end = (size_t)m_in.gcount();
+        return m_end >= m_recordSize;
+    }
+
+    uint64_t key() const
+    {
+        uint64_t k;
+        std::memcpy(&k, m_buf.data() + m_pos, sizeof(k));
+        return k;
+    }
 
-SortKernel::SortKernel() : m_bCompress(false), m_bForwardMetadata(false)
+    const char *point() const
+        { return m_buf.data() + m_pos + sizeof(uint64_t); }
+
+private:
+    std::ifstream m_in;
+    size_t m_recordSize;
+    std::vector<char> m_buf;
+    size_t m_pos;
+    size_t m_end;
+};
+
+// Removes temporary run files when sorting completes or fails.
+class RunFiles
+{
+public:
+    ~RunFiles()
+    {
+        for (const std::string& f : m_files)
+            FileUtils::deleteFile(f);
+    }
+
+    void add(const std::string& filename)
+        { m_files.push_back(filename); }
+    const StringList& files() const
+        { return m_files; }
+    size_t size() const
+        { return m_files.size(); }
+
+private:
+    StringList m_files;
+};
+
+} // unnamed namespace
+
+
+SortKernel::SortKernel() : m_bCompress(false), m_bForwardMetadata(false),
+    m_external(false), m_pointSize(0)
 {}
 
 
@@ -67,20 +153,70 @@ void SortKernel::addSwitches(ProgramArgs& args)
     args.add("metadata,m",
         "Forward metadata (VLRs, header entries, etc) from previous stages",
         m_bForwardMetadata);
+    args.add("key", "Sort key: 'morton', 'hilbert' or a dimension name",
+        m_key, "morton");
+    args.add("order", "Sort order for dimension keys: ASC or DESC", m_order,
+        SortOrder::ASC);
+    args.add("external", "Sort data larger than memory by merging "
+        "sorted runs from temporary files", m_external);
+    args.add("memory", "Memory used to hold a sorted run, in megabytes "
+        "(external sort only)", m_memory, 1024.0);
+    args.add("temp_dir", "Directory for temporary run files "
+        "(external sort only)", m_tempDir);
+    args.add("threads", "Number of threads used to sort", m_threads,
+        (size_t)(std::max)(std::thread::hardware_concurrency(), 1U));
 }
 
 
-int SortKernel::execute()
+void SortKernel::validateSwitches(ProgramArgs& args)
 {
-    Stage& readerStage = makeReader(m_inputFile, m_driverOverride);
-    Stage& sortStage = makeFilter("filters.mortonorder", readerStage);
+    const std::string key = Utils::tolower(m_key);
+    const bool curve = (key == "morton" || key == "hilbert");
+    if (curve)
+        m_key = key;
+    if (curve && m_order == SortOrder::DESC)
+        throw pdal_error("Option 'order' can only be used when sorting by "
+            "a dimension.");
+    if (m_memory <= 0)
+        throw pdal_error("Option 'memory' must be greater than 0.");
+}
+
 
-    Options writerOptions;
+Options SortKernel::writerOptions() const
+{
+    Options opts;
     if (m_bCompress)
-        writerOptions.add("compression", true);
+        opts.add("compression", true);
     if (m_bForwardMetadata)
-        writerOptions.add("forward_metadata", true);
-    Stage& writer = makeWriter(m_outputFile, sortStage, "", writerOptions);
+        opts.add("forward_metadata", true);
+    return opts;
+}
+
+
+int SortKernel::execute()
+{
+    if (m_external)
+        return externalSort();
+
+    Stage& readerStage = makeReader(m_inputFile, m_driverOverride);
+    Stage *sortStage;
+    if (m_key == "morton" || m_key == "hilbert")
+    {
+        Options sortOptions;
+        sortOptions.add("curve", m_key);
+        sortOptions.add("threads", m_threads);
+        sortStage = &makeFilter("filters.mortonorder", readerStage,
+            sortOptions);
+    }
+    else
+    {
+        Options sortOptions;
+        sortOptions.add("dimension", m_key);
+        sortOptions.add("order", m_order == SortOrder::ASC ? "ASC" : "DESC");
+        sortOptions.add("algorithm", "STABLE");
+        sortStage = &makeFilter("filters.sort", readerStage, sortOptions);
+    }
+    Stage& writer = makeWriter(m_outputFile, *sortStage, "", writerOptions());
 
     ColumnPointTable table;
     writer.prepare(table);
@@ -89,4 +225,246 @@ int SortKernel::execute()
     return 0;
 }
 
+
+// Sort in three steps:
+//  1) Read points in runs that fit in the memory limit, sort each run
+//     by key and write it to a temporary file.
+//  2) Merge the runs, passing each point to the writer in key order.
+//  3) Delete the temporary files.
+// If all points fit in a single run, the run is written directly.
+int SortKernel::externalSort()
+{
+    Stage& readerStage = makeReader(m_inputFile, m_driverOverride);
+    Streamable *reader = dynamic_cast<Streamable *>(&readerStage);
+    if (!reader)
+        throw pdal_error("Driver '" + readerStage.getName() + "' for input "
+            "file '" + m_inputFile + "' is not streamable.");
+
+    Stage& writerStage = m_manager.makeWriter(m_outputFile, "",
+        writerOptions());
+    Streamable *writer = dynamic_cast<Streamable *>(&writerStage);
+    if (!writer)
+        throw pdal_error("Driver '" + writerStage.getName() + "' for output "
+            "file '" + m_outputFile + "' is not streamable.");
+
+    FixedPointTable table(StreamTableSize);
+    reader->prepare(table);
+    writer->prepare(table);
+    table.finalize();
+
+    PointLayoutPtr layout = table.layout();
+    m_dimTypes = layout->dimTypes();
+    m_pointSize = layout->pointSize();
+
+    KeyFunc key = keyFunc(*reader, table);
+
+    const size_t memory = (size_t)(m_memory * 1024 * 1024);
+    const size_t capacity = (std::max)((size_t)1,
+        memory / (m_pointSize + sizeof(KeyId)));
+
+    std::string tempDir = m_tempDir.empty() ?
+        arbiter::getTempPath() : m_tempDir;
+    const std::string prefix = arbiter::join(tempDir,
+        "pdal_sort_" + RandomUuid().toString());
+
+    RunFiles runs;
+    std::vector<char> points;
+    KeyIdList keys;
+    PointRef point(table, 0);
+    bool finished = false;
+    bool written = false;
+
+    StageWrapper::ready(*reader, table);
+    SpatialReference srs = reader->getSpatialReference();
+    if (!srs.empty())
+        table.setSpatialReference(srs);
+    while (!finished)
+    {
+        keys.clear();
+        while (keys.size() < capacity)
+        {
+            if (!StreamableWrapper::processOne(*reader, point))
+            {
+                finished = true;
+                break;
+            }
+            PointId id = keys.size();
+
+            // Grow the buffers as needed so that small inputs don't
+            // allocate the entire memory limit.
+            if (id * m_pointSize == points.size())
+            {
+                size_t size = (std::min)(capacity,
+                    (std::max)((size_t)65536, 2 * id));
+                keys.reserve(size);
+                points.resize(size * m_pointSize);
+            }
+            point.getPackedData(m_dimTypes, points.data() + id * m_pointSize);
+            keys.push_back({ key(point), id });
+        }
+        if (keys.empty())
+            break;
+
+        keysort::sort(keys, m_threads);
+
+        // Everything fit in memory. Write the points without a merge.
+        if (finished && runs.size() == 0)
+        {
+            StageWrapper::ready(*writer, table);
+            StreamableWrapper::spatialReferenceChanged(*writer, srs);
+            for (const KeyId& k : keys)
+            {
+                point.setPackedData(m_dimTypes,
+                    points.data() + k.id * m_pointSize);
+                StreamableWrapper::processOne(*writer, point);
+            }
+            written = true;
+            break;
+        }
+
+        std::string filename = prefix + "_" + std::to_string(runs.size());
+        runs.add(filename);
+        writeRun(filename, keys, points);
+        m_log->get(LogLevel::Debug) << "Wrote sorted run of " <<
+            keys.size() << " points to '" << filename << "'." << std::endl;
+    }
+    StageWrapper::done(*reader, table);
+
+    // Release the run buffers before merging.
+    KeyIdList().swap(keys);
+    std::vector<char>().swap(points);
+
+    // Merge the runs. If there were no points, the writer still
+    // creates its output.
+    if (!written)
+    {
+        StageWrapper::ready(*writer, table);
+        StreamableWrapper::spatialReferenceChanged(*writer, srs);
+        if (runs.size())
+            mergeRuns(runs.files(), *writer, point);
+    }
+    StageWrapper::done(*writer, table);
+
+    return 0;
+}
+
+
+SortKernel::KeyFunc SortKernel::keyFunc(Streamable& reader,
+    PointTableRef table)
+{
+    using namespace Dimension;
+
+    if (m_key == "morton" || m_key == "hilbert")
+    {
+        curve::Type type = (m_key == "morton") ?
+            curve::Type::Morton : curve::Type::Hilbert;
+        curve::Encoder encoder(type, readBounds(reader, table));
+        return [encoder](PointRef& p)
+        {
+            return encoder.key(p.getFieldAs<double>(Id::X),
+                p.getFieldAs<double>(Id::Y));
+        };
+    }
+
+    Id dim = table.layout()->findDim(m_key);
+    if (dim == Id::Unknown)
+        throw pdal_error("Cannot sort because dimension '" + m_key +
+            "' was not found.");
+    if (m_order == SortOrder::DESC)
+        return [dim](PointRef& p)
+            { return ~keysort::orderedKey(p.getFieldAs<double>(dim)); };
+    return [dim](PointRef& p)
+        { return keysort::orderedKey(p.getFieldAs<double>(dim)); };
+}
+
+
+// Curve keys are relative to the bounds of all the data. Use the bounds
+// from the file header when available, otherwise make an extra pass
+// through the data to compute them.
+BOX2D SortKernel::readBounds(Streamable& reader, PointTableRef table)
+{
+    QuickInfo qi = reader.preview();
+    if (qi.valid() && qi.m_bounds.valid())
+        return qi.m_bounds.to2d();
+
+    m_log->get(LogLevel::Debug) << "No bounds available from '" <<
+        m_inputFile << "'. Reading points to compute bounds." << std::endl;
+
+    BOX2D bounds;
+    PointRef point(table, 0);
+    StageWrapper::ready(reader, table);
+    while (StreamableWrapper::processOne(reader, point))
+        bounds.grow(point.getFieldAs<double>(Dimension::Id::X),
+            point.getFieldAs<double>(Dimension::Id::Y));
+    StageWrapper::done(reader, table);
+    return bounds;
+}
+
+
+void SortKernel::writeRun(const std::string& filename, const KeyIdList& keys,
+    const std::vector<char>& points)
+{
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if (!out)
+        throw pdal_error("Unable to create sort run file '" + filename +
+            "'.");
+
+    // Write records in blocks to avoid a stream call per point.
+    const size_t recordSize = sizeof(uint64_t) + m_pointSize;
+    const size_t blockRecords = (std::max)((size_t)1,
+        (4 * 1024 * 1024) / recordSize);
+    std::vector<char> block;
+    block.reserve(blockRecords * recordSize);
+    for (const KeyId& k : keys)
+    {
+        const char *key = reinterpret_cast<const char *>(&k.key);
+        block.insert(block.end(), key, key + sizeof(uint64_t));
+        const char *point = points.data() + k.id * m_pointSize;
+        block.insert(block.end(), point, point + m_pointSize);
+        if (block.size() >= blockRecords * recordSize)
+        {
+            out.write(block.data(), block.size());
+            block.clear();
+        }
+    }
+    out.write(block.data(), block.size());
+    if (!out)
+        throw pdal_error("Error writing sort run file '" + filename + "'.");
+}
+
+
+void SortKernel::mergeRuns(const StringList& filenames, Streamable& writer,
+    PointRef& point)
+{
+    // Split the memory budget among the run buffers.
+    const size_t recordSize = sizeof(uint64_t) + m_pointSize;
+    const size_t memory = (size_t)(m_memory * 1024 * 1024);
+    const size_t bufRecords = (std::max)((size_t)64,
+        memory / (filenames.size() * recordSize));
+
+    std::vector<std::unique_ptr<RunReader>> runs;
+    for (const std::string& filename : filenames)
+        runs.emplace_back(new RunReader(filename, recordSize, bufRecords));
+
+    // Order by key and then by run number so that equal keys keep
+    // their input order.
+    using Entry = std::pair<uint64_t, size_t>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+    for (size_t i = 0; i < runs.size(); ++i)
+        if (runs[i]->next())
+            heap.push({ runs[i]->key(), i });
+
+    while (heap.size())
+    {
+        size_t i = heap.top().second;
+        heap.pop();
+
+        RunReader& run = *runs[i];
+        point.setPackedData(m_dimTypes, run.point());
+        StreamableWrapper::processOne(writer, point);
+        if (run.next())
+            heap.push({ run.key(), i });
+    }
+}
+
 } // namespace pdal
@@ -34,11 +34,17 @@
 
 #pragma once
 
+#include <functional>
+
 #include <pdal/Kernel.hpp>
+#include <pdal/private/KeySort.hpp>
+#include <filters/SortFilter.hpp>
 
 namespace pdal
 {
 
+class Streamable;
+
 class PDAL_EXPORT SortKernel : public Kernel
 {
 public:
@@ -47,12 +53,31 @@ public:
     SortKernel();
 
 private:
+    using KeyFunc = std::function<uint64_t(PointRef&)>;
+
     void addSwitches(ProgramArgs& args);
+    void validateSwitches(ProgramArgs& args);
+    Options writerOptions() const;
+    int externalSort();
+    KeyFunc keyFunc(Streamable& reader, PointTableRef table);
+    BOX2D readBounds(Streamable& reader, PointTableRef table);
+    void writeRun(const std::string& filename, const KeyIdList& keys,
+        const std::vector<char>& points);
+    void mergeRuns(const StringList& filenames, Streamable& writer,
+        PointRef& point);
 
     std::string m_inputFile;
     std::string m_outputFile;
     bool m_bCompress;
     bool m_bForwardMetadata;
+    bool m_external;
+    std::string m_key;
+    SortOrder m_order;
+    double m_memory;
+    std::string m_tempDir;
+    size_t m_threads;
+    DimTypeList m_dimTypes;
+    size_t m_pointSize;
 };
 
 } // namespace pdal
@@ -34,11 +34,16 @@
 
 #include "TIndexKernel.hpp"
 
+#include <condition_variable>
+#include <fstream>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include <ogr_api.h>
 
+#include "arbiter/arbiter.hpp"
+
 #include <pdal/PDALUtils.hpp>
 #include <pdal/Polygon.hpp>
 #include <pdal/util/FileUtils.hpp>
@@ -49,6 +54,7 @@
 #include "../io/LasWriter.hpp"
 
 #include <cpl_string.h>
+#include <cpl_time.h>
 
 namespace
 {
@@ -61,6 +67,39 @@ void setDate(OGRFeatureH feature, const tm& tyme, int fieldNumber)
 }
 
 
+// Modification times are compared as seconds since the epoch, since some
+// drivers (notably ESRI Shapefile) don't keep the time of a date field.
+GIntBig toSeconds(const tm& tyme)
+{
+    return CPLYMDHMSToUnixTime(&tyme);
+}
+
+
+// SHA-256 of the SHA-256 digests of consecutive blocks of a file, so that
+// large files don't need to be held in memory.
+std::string checksum(const std::string& filename)
+{
+    const size_t BlockSize = 4 * 1024 * 1024;
+
+    std::ifstream in(filename, std::ios::binary);
+    if (!in)
+        throw pdal::pdal_error("Unable to open file '" + filename +
+            "' to compute its checksum.");
+
+    std::vector<char> block(BlockSize);
+    std::vector<char> digests;
+    while (in)
+    {
+        in.read(block.data(), block.size());
+        block.resize((size_t)in.gcount());
+        std::vector<char> digest = pdal::arbiter::crypto::sha256(block);
+        digests.insert(digests.end(), digest.begin(), digest.end());
+        block.resize(BlockSize);
+    }
+    return pdal::arbiter::crypto::encodeAsHex(pdal::arbiter::crypto::sha256(digests));
+}
+
+
 } // anonymous namespace
 
 
@@ -215,6 +254,8 @@ void TIndexKernel::addSubSwitches(ProgramArgs& args,
             "internal hexbin filter (exact boundary)", m_sampleSize, 5000U);
         args.add("where", "Expression describing points to be processed for exact "
             "boundary creation", m_boundaryExpr);
+        args.add("incremental", "Reindex files already in the index whose size, "
+            "modification time and checksum have changed", m_incremental);
     }
     else if (subcommand == "merge")
     {
@@ -319,34 +360,36 @@ StringList readFileList(const std::string& filename)
 }
 
 
-bool TIndexKernel::isFileIndexed(const FieldIndexes& indexes,
-    const FileInfo& fileInfo)
+TIndexKernel::IndexedFiles TIndexKernel::getIndexedFiles(
+    const FieldIndexes& indexes)
 {
-    std::ostringstream qstring;
-
-    qstring << Utils::toupper(m_tileIndexColumnName) << "=" <<
-        "'" << fileInfo.m_filename << "'";
-    std::string query = qstring.str();
-    OGRErr err = OGR_L_SetAttributeFilter(m_layer, query.c_str());
-    if (err != OGRERR_NONE)
-    {
-        std::ostringstream oss;
-        oss << "Unable to set attribute filter for file '" <<
-             fileInfo.m_filename << "'";
-        throw pdal_error(oss.str());
-    }
+    IndexedFiles files;
 
-    bool output(false);
     OGR_L_ResetReading(m_layer);
-    auto hFeat = OGR_L_GetNextFeature(m_layer);
-    if( hFeat )
+    while (true)
     {
-        OGR_F_Destroy(hFeat);
-        output = true;
+        OGRFeatureH feature = OGR_L_GetNextFeature(m_layer);
+        if (!feature)
+            break;
+
+        IndexedFile file {};
+        file.m_fid = OGR_F_GetFID(feature);
+        file.m_mtime = -1;
+        if (indexes.m_mtimeSeconds >= 0 &&
+                OGR_F_IsFieldSetAndNotNull(feature, indexes.m_mtimeSeconds))
+            file.m_mtime =
+                OGR_F_GetFieldAsInteger64(feature, indexes.m_mtimeSeconds);
+        if (indexes.m_size >= 0)
+            file.m_size = OGR_F_GetFieldAsInteger64(feature, indexes.m_size);
+        if (indexes.m_checksum >= 0)
+            file.m_checksum =
+                OGR_F_GetFieldAsString(feature, indexes.m_checksum);
+        files[OGR_F_GetFieldAsString(feature, indexes.m_filename)] = file;
+
+        OGR_F_Destroy(feature);
     }
     OGR_L_ResetReading(m_layer);
-    OGR_L_SetAttributeFilter(m_layer, NULL);
-    return output;
+    return files;
 }
 
 
@@ -391,44 +434,121 @@ void TIndexKernel::createFile()
             throw pdal_error(out.str());
         }
 
+    // Layers created before file sizes and checksums were recorded need
+    // the fields to be indexed incrementally.
+    if (m_incremental)
+        createFileStateFields();
+    FieldIndexes indexes = getFields();
+
+    // Read the index once rather than querying it for each file.
+    const IndexedFiles indexed = getIndexedFiles(indexes);
+
     std::vector<FileInfo> infos;
     for (auto f : m_files)
     {
         FileInfo info;
-        info.m_filename = f;
+        info.m_path = f;
         info.m_isRemote = Utils::isRemote(f);
+        if (m_prefix.size() && ! info.m_isRemote)
+            info.m_filename = m_prefix + FileUtils::getFilename(f);
+        else if (m_absPath && ! info.m_isRemote)
+            info.m_filename = FileUtils::toAbsolutePath(f);
+        else
+            info.m_filename = f;
         if (!info.m_isRemote)
-            FileUtils::fileTimes(info.m_filename, &info.m_ctime, &info.m_mtime);
+        {
+            FileUtils::fileTimes(f, &info.m_ctime, &info.m_mtime);
+            info.m_size = FileUtils::fileSize(f);
+        }
+
+        // Files already in the index are skipped unless they have changed
+        // and we're indexing incrementally.
+        auto it = indexed.find(info.m_filename);
+        if (it != indexed.end())
+        {
+            const IndexedFile& file = it->second;
+            if (!m_incremental || info.m_isRemote)
+                continue;
+            if (file.m_size == info.m_size &&
+                    file.m_mtime == toSeconds(info.m_mtime))
+                continue;
+            info.m_fid = file.m_fid;
+            info.m_oldChecksum = file.m_checksum;
+        }
         infos.push_back(info);
     }
 
+    if (infos.empty() && m_incremental)
+    {
+        m_log->get(LogLevel::Info) << "No new or changed files to index." <<
+            std::endl;
+        OGR_DS_Destroy(m_dataset);
+        m_dataset = nullptr;
+        m_layer = nullptr;
+        return;
+    }
+
+    // Files are processed on the pool and written to the index in order as
+    // they complete.  No more than 'window' files are in flight so that
+    // memory use doesn't depend on the number of files.
     ThreadPool pool(m_threads);
+    const size_t window = 2 * (size_t)(std::max)(m_threads, 1);
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<bool> processed(infos.size());
+    size_t next = 0;
 
-    for (auto &info : infos)
+    bool haveSrs(false);
+    bool indexedFile(false);
+    bool updatedFile(false);
+    for (size_t i = 0; i < infos.size(); ++i)
     {
-        pool.add([this, &info]()
+        for (; next < infos.size() && next < i + window; ++next)
         {
-            getFileInfo(info);
-        });
+            FileInfo& info = infos[next];
+            size_t pos = next;
+            pool.add([this, &info, &mutex, &cv, &processed, pos]()
+            {
+                processFile(info);
+                std::lock_guard<std::mutex> lock(mutex);
+                processed[pos] = true;
+                cv.notify_all();
+            });
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&processed, i](){ return processed[i]; });
+        lock.unlock();
+
+        FileInfo& info = infos[i];
+        if (info.m_boundary.empty())
+        {
+            // Content unchanged - only the file's attributes are updated.
+            if (info.m_fid >= 0 && info.m_checksum == info.m_oldChecksum)
+            {
+                updateFeature(indexes, info);
+                updatedFile = true;
+            }
+            continue;
+        }
+
+        if (!haveSrs)
+        {
+            m_originalSrs = info.m_srs;
+            // Same thing that happens to assign SRS in createFeature
+            if (m_originalSrs.empty() || m_overrideASrs)
+                m_originalSrs = m_assignSrsString;
+            haveSrs = true;
+        }
+        if (info.m_fid >= 0)
+            OGR_L_DeleteFeature(m_layer, info.m_fid);
+        indexedFile |= createFeature(indexes, info);
+        info.m_boundary.clear();
+        info.m_boundary.shrink_to_fit();
     }
     pool.await();
 
-    m_originalSrs = infos[0].m_srs;
-    // Same thing that happens to assign SRS in createFeature
-    if (m_originalSrs.empty() || m_overrideASrs)
-        m_originalSrs = m_assignSrsString;
-    bool indexedFile(false);
-    FieldIndexes indexes = getFields();
-    for (auto &info : infos)
-    {
-        if (m_prefix.size() && ! info.m_isRemote)
-            info.m_filename = m_prefix + FileUtils::getFilename(info.m_filename);
-        else if (m_absPath && ! info.m_isRemote)
-            info.m_filename = FileUtils::toAbsolutePath(info.m_filename);
-        if (!info.m_boundary.empty() && !isFileIndexed(indexes, info))
-            indexedFile |= createFeature(indexes, info);
-    }
-    if (!indexedFile)
+    if (!indexedFile && !updatedFile)
         throw pdal_error("Couldn't index any files.");
     OGR_DS_Destroy(m_dataset);
     m_dataset = nullptr;
@@ -561,6 +681,18 @@ bool TIndexKernel::createFeature(const FieldIndexes& indexes,
     setStringField(hFeature, indexes.m_filename,
         fileInfo.m_filename.c_str());
 
+    // Set the file size, modification time and checksum used to detect
+    // changes.
+    if (indexes.m_size >= 0 && !fileInfo.m_isRemote)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_size,
+            (GIntBig)fileInfo.m_size);
+    if (indexes.m_mtimeSeconds >= 0 && !fileInfo.m_isRemote)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_mtimeSeconds,
+            toSeconds(fileInfo.m_mtime));
+    if (indexes.m_checksum >= 0 && fileInfo.m_checksum.size())
+        setStringField(hFeature, indexes.m_checksum,
+            fileInfo.m_checksum.c_str());
+
     // Set the SRS into the feature.
     // We override if m_assignSrsString is set
     if (fileInfo.m_srs.empty() || m_overrideASrs)
@@ -610,6 +742,29 @@ bool TIndexKernel::createFeature(const FieldIndexes& indexes,
 }
 
 
+// Record the new size and modification time of a file whose content
+// hasn't changed.
+void TIndexKernel::updateFeature(const FieldIndexes& indexes,
+    const FileInfo& fileInfo)
+{
+    OGRFeatureH hFeature = OGR_L_GetFeature(m_layer, (GIntBig)fileInfo.m_fid);
+    if (!hFeature)
+        return;
+
+    setDate(hFeature, fileInfo.m_mtime, indexes.m_mtime);
+    if (indexes.m_size >= 0)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_size,
+            (GIntBig)fileInfo.m_size);
+    if (indexes.m_mtimeSeconds >= 0)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_mtimeSeconds,
+            toSeconds(fileInfo.m_mtime));
+    if (OGR_L_SetFeature(m_layer, hFeature) == OGRERR_NONE)
+        m_log->get(LogLevel::Info) << "Updated unchanged file " <<
+            fileInfo.m_filename << std::endl;
+    OGR_F_Destroy(hFeature);
+}
+
+
 void TIndexKernel::setStringField(OGRFeatureH hFeature, int idx,
     const char* value)
 {
@@ -644,6 +799,28 @@ void TIndexKernel::fastBoundary(Stage& reader, FileInfo& fileInfo)
 }
 
 
+// Compute the checksum of a file when indexing incrementally and its
+// boundary unless the content of a previously indexed file is unchanged.
+void TIndexKernel::processFile(FileInfo& fileInfo)
+{
+    if (m_incremental && !fileInfo.m_isRemote)
+    {
+        try
+        {
+            fileInfo.m_checksum = checksum(fileInfo.m_path);
+        }
+        catch (pdal_error& e)
+        {
+            m_log->get(LogLevel::Warning) << e.what() << std::endl;
+            return;
+        }
+        if (fileInfo.m_fid >= 0 && fileInfo.m_checksum == fileInfo.m_oldChecksum)
+            return;
+    }
+    getFileInfo(fileInfo);
+}
+
+
 void TIndexKernel::getFileInfo(FileInfo& fileInfo)
 {
     PipelineManager manager;
@@ -651,7 +828,7 @@ void TIndexKernel::getFileInfo(FileInfo& fileInfo)
     manager.stageOptions() = m_manager.stageOptions();
 
     // Need to make sure options get set.
-    Stage& reader = manager.makeReader(fileInfo.m_filename, "");
+    Stage& reader = manager.makeReader(fileInfo.m_path, "");
 
     // If we aren't able to make a hexbin filter, we
     // will just do a simple fast_boundary.
@@ -769,6 +946,36 @@ void TIndexKernel::createFields()
     hFieldDefn = OGR_Fld_Create("created", OFTDateTime);
     OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
     OGR_Fld_Destroy(hFieldDefn);
+
+    createFileStateFields();
+}
+
+
+// Create the fields used to detect changed files if they don't exist.
+void TIndexKernel::createFileStateFields()
+{
+    OGRFeatureDefnH fDefn = OGR_L_GetLayerDefn(m_layer);
+
+    if (OGR_FD_GetFieldIndex(fDefn, "filesize") < 0)
+    {
+        OGRFieldDefnH hFieldDefn = OGR_Fld_Create("filesize", OFTInteger64);
+        OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
+        OGR_Fld_Destroy(hFieldDefn);
+    }
+
+    if (OGR_FD_GetFieldIndex(fDefn, "mtime") < 0)
+    {
+        OGRFieldDefnH hFieldDefn = OGR_Fld_Create("mtime", OFTInteger64);
+        OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
+        OGR_Fld_Destroy(hFieldDefn);
+    }
+
+    if (OGR_FD_GetFieldIndex(fDefn, "checksum") < 0)
+    {
+        OGRFieldDefnH hFieldDefn = OGR_Fld_Create("checksum", OFTString);
+        OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
+        OGR_Fld_Destroy(hFieldDefn);
+    }
 }
 
 
@@ -800,6 +1007,9 @@ TIndexKernel::FieldIndexes TIndexKernel::getFields()
 
     indexes.m_ctime = OGR_FD_GetFieldIndex(fDefn, "created");
     indexes.m_mtime = OGR_FD_GetFieldIndex(fDefn, "modified");
+    indexes.m_size = OGR_FD_GetFieldIndex(fDefn, "filesize");
+    indexes.m_mtimeSeconds = OGR_FD_GetFieldIndex(fDefn, "mtime");
+    indexes.m_checksum = OGR_FD_GetFieldIndex(fDefn, "checksum");
 
     return indexes;
 }
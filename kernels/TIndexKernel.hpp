@@ -40,6 +40,8 @@
 #include <pdal/SubcommandKernel.hpp>
 #include <pdal/util/FileUtils.hpp>
 
+#include <unordered_map>
+
 // Get GDAL's forward decls if available
 // otherwise make our own
 #if __has_include(<gdal_fwd.h>)
@@ -65,6 +67,7 @@ class PDAL_EXPORT TIndexKernel : public SubcommandKernel
 {
     struct FileInfo
     {
+        std::string m_path;
         std::string m_filename;
         std::string m_srs;
         std::string m_boundary;
@@ -72,7 +75,22 @@ class PDAL_EXPORT TIndexKernel : public SubcommandKernel
         struct tm m_ctime;
         struct tm m_mtime;
         bool m_isRemote = false;
+        uintmax_t m_size = 0;
+        std::string m_checksum;
+
+        // Feature and checksum of a previously indexed version of the file.
+        int64_t m_fid = -1;
+        std::string m_oldChecksum;
+    };
+
+    struct IndexedFile
+    {
+        int64_t m_fid;
+        uintmax_t m_size;
+        int64_t m_mtime;  // Seconds since the epoch, or -1 if unknown.
+        std::string m_checksum;
     };
+    using IndexedFiles = std::unordered_map<std::string, IndexedFile>;
 
     struct FieldIndexes
     {
@@ -80,6 +98,9 @@ class PDAL_EXPORT TIndexKernel : public SubcommandKernel
         int m_srs;
         int m_ctime;
         int m_mtime;
+        int m_size;
+        int m_mtimeSeconds;
+        int m_checksum;
     };
 
 public:
@@ -100,16 +121,18 @@ private:
     bool openLayer(const std::string& layerName);
     bool createLayer(const std::string& layerName);
     FieldIndexes getFields();
+    IndexedFiles getIndexedFiles(const FieldIndexes& indexes);
+    void processFile(FileInfo& info);
     void getFileInfo(FileInfo& info);
     bool createFeature(const FieldIndexes& indexes, FileInfo& info);
+    void updateFeature(const FieldIndexes& indexes, const FileInfo& info);
     pdal::Polygon prepareGeometry(const FileInfo& fileInfo);
     void createFields();
+    void createFileStateFields();
     void setStringField(OGRFeatureH hFeature, int idx, const char* value);
     void fastBoundary(Stage& reader, FileInfo& fileInfo);
     std::string makeMultiPolygon(const std::string& wkt);
 
-    bool isFileIndexed( const FieldIndexes& indexes, const FileInfo& fileInfo);
-
     std::string m_idxFilename;
     std::string m_filespec;
     StringList m_files;
@@ -138,6 +161,7 @@ private:
     bool m_usestdin;
     bool m_overrideASrs;
     bool m_skipMultiSrs;
+    bool m_incremental;
     std::string m_originalSrs;
     size_t m_maxFieldSize;
 };
@@ -34,10 +34,26 @@
 
 #include "TileKernel.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+
+#include "arbiter/arbiter.hpp"
+
+#include <filters/private/Partitioner.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/StageWrapper.hpp>
 #include <pdal/Writer.hpp>
 #include <pdal/PDALUtils.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/ThreadPool.hpp>
+#include <pdal/util/Uuid.hpp>
 
 namespace pdal
 {
@@ -51,7 +67,173 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_KERNEL(TileKernel, s_info)
 
-TileKernel::TileKernel() : m_table(10000), m_repro(nullptr)
+namespace
+{
+
+// Number of points in the tables used to pass points between stages.
+const point_count_t StreamTableSize = 10000;
+
+// A stream table that shares the (finalized) layout of the kernel's table so
+// that several inputs and outputs can be processed at once.
+class WorkerTable : public StreamPointTable
+{
+public:
+    WorkerTable(PointLayout& layout, point_count_t capacity) :
+        StreamPointTable(layout, capacity), m_buf(pointsToBytes(capacity + 1))
+    {}
+
+protected:
+    void reset() override
+        { std::fill(m_buf.begin(), m_buf.end(), 0); }
+
+    char *getPoint(PointId idx) override
+        { return m_buf.data() + pointsToBytes(idx); }
+
+private:
+    std::vector<char> m_buf;
+};
+
+// Holds the first exception thrown by a threaded task so that it can be
+// rethrown on the main thread.
+class TaskError
+{
+public:
+    void run(const std::function<void()>& task)
+    {
+        try
+        {
+            task();
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error)
+                m_error = std::current_exception();
+        }
+    }
+
+    void check()
+    {
+        if (m_error)
+            std::rethrow_exception(m_error);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::exception_ptr m_error;
+};
+
+} // unnamed namespace
+
+// Temporary files of packed points, one per tile.  About 'maxOpen' files
+// are open at once.  When the limit is reached the least recently written
+// file is closed and it is reopened for append the next time points are
+// added to its tile.  The store's mutex only guards the tile map and the
+// LRU list, so threads write to different tiles at the same time.  Since a
+// file is closed after it is removed from the list, up to one file per
+// writing thread may be open beyond the limit.
+class TileStore
+{
+    using Coord = std::pair<int, int>;
+
+public:
+    TileStore(const std::string& prefix, size_t maxOpen) :
+        m_prefix(prefix), m_maxOpen(maxOpen)
+    {}
+
+    ~TileStore()
+    {
+        close();
+        for (auto& t : m_tiles)
+            FileUtils::deleteFile(t.second.filename);
+    }
+
+    void append(const Coord& loc, const char *data, size_t size)
+    {
+        Tile *tile;
+        Tile *evicted = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            tile = &m_tiles[loc];
+            if (tile->filename.empty())
+                tile->filename = m_prefix + "_" + std::to_string(loc.first) +
+                    "_" + std::to_string(loc.second);
+
+            if (tile->inLru)
+                m_lru.splice(m_lru.begin(), m_lru, tile->lru);
+            else
+            {
+                if (m_lru.size() >= m_maxOpen)
+                {
+                    evicted = &m_tiles[m_lru.back()];
+                    evicted->inLru = false;
+                    m_lru.pop_back();
+                }
+                m_lru.push_front(loc);
+                tile->lru = m_lru.begin();
+                tile->inLru = true;
+            }
+        }
+
+        if (evicted)
+        {
+            std::lock_guard<std::mutex> lock(evicted->mutex);
+            evicted->out.reset();
+        }
+
+        std::lock_guard<std::mutex> lock(tile->mutex);
+        if (!tile->out)
+            tile->out.reset(new std::ofstream(tile->filename,
+                std::ios::binary | std::ios::app));
+        tile->out->write(data, size);
+        if (!*tile->out)
+            throw pdal_error("Unable to write temporary tile file '" +
+                tile->filename + "'.");
+    }
+
+    void close()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        for (auto& t : m_tiles)
+        {
+            std::lock_guard<std::mutex> tileLock(t.second.mutex);
+            t.second.out.reset();
+            t.second.inLru = false;
+        }
+        m_lru.clear();
+    }
+
+    std::vector<std::pair<Coord, std::string>> tiles() const
+    {
+        std::vector<std::pair<Coord, std::string>> tiles;
+        for (auto& t : m_tiles)
+            tiles.emplace_back(t.first, t.second.filename);
+        return tiles;
+    }
+
+private:
+    // The file name and LRU position are guarded by the store's mutex,
+    // the output stream by the tile's mutex.
+    struct Tile
+    {
+        std::string filename;
+        bool inLru = false;
+        std::list<Coord>::iterator lru;
+        std::mutex mutex;
+        std::unique_ptr<std::ofstream> out;
+    };
+
+    std::string m_prefix;
+    size_t m_maxOpen;
+    std::mutex m_mutex;
+    std::map<Coord, Tile> m_tiles;
+    std::list<Coord> m_lru;
+};
+
+
+TileKernel::TileKernel() : m_table(StreamTableSize)
 {}
 
 
@@ -74,6 +256,11 @@ void TileKernel::addSwitches(ProgramArgs& args)
         m_buffer);
     args.add("out_srs", "Output SRS to which points will be reprojected",
         m_outSrs);
+    args.add("threads", "Number of input files to read and output files to "
+        "write at once", m_threads, (int)std::thread::hardware_concurrency());
+    args.add("max_open", "Maximum number of temporary tile files to hold "
+        "open at once", m_maxOpen, 256);
+    args.add("temp_dir", "Directory for temporary tile files", m_tempDir);
 }
 
 
@@ -84,22 +271,25 @@ void TileKernel::validateSwitches(ProgramArgs& args)
     if (m_hashPos == std::string::npos)
         throw pdal_error("Output filename must contain a single '#' "
             "template placeholder.");
+    if (m_threads < 1)
+        m_threads = 1;
+    if (m_maxOpen < 1)
+        throw pdal_error("Option 'max_open' must be greater than 0.");
 }
 
 
 int TileKernel::execute()
 {
-    const StringList& files = Utils::glob(m_inputFile);
+    StringList files = Utils::glob(m_inputFile);
     if (files.empty())
         throw pdal_error("No input files found for path '" +
             m_inputFile + "'.");
+    std::sort(files.begin(), files.end());
 
-    Readers readers;
+    Inputs inputs;
     for (auto&& file : files)
-        readers[file] = prepareReader(file);
-    checkReaders(readers);
-    if (m_repro)
-        m_repro->prepare(m_table);
+        inputs.push_back({ file, prepareReader(file), nullptr });
+    checkReaders(inputs);
     Options opts;
     opts.add("length", m_length);
     opts.add("buffer", m_buffer);
@@ -107,24 +297,30 @@ int TileKernel::execute()
     m_splitter.prepare(m_table);
 
     m_table.finalize();
-    process(readers);
+
+    std::string tempDir = m_tempDir.empty() ?
+        arbiter::getTempPath() : m_tempDir;
+    TileStore store(arbiter::join(tempDir,
+        "pdal_tile_" + RandomUuid().toString()), (size_t)m_maxOpen);
+
+    StageWrapper::ready(m_splitter, m_table);
+    process(inputs, store);
     StageWrapper::done(m_splitter, m_table);
-    for (auto&& wp : m_writers)
-        StageWrapper::done(*wp.second, m_table);
+    writeTiles(store);
     return 0;
 }
 
 
-void TileKernel::checkReaders(const Readers& readers)
+void TileKernel::checkReaders(Inputs& inputs)
 {
     SpatialReference tempSrs;
     SpatialReference srs;
     bool needRepro(false);
 
-    for (auto& rp : readers)
+    for (Input& in : inputs)
     {
-        const std::string& filename = rp.first;
-        Streamable *r = rp.second;
+        const std::string& filename = in.filename;
+        Streamable *r = in.reader;
 
         tempSrs = r->getSpatialReference();
 
@@ -162,14 +358,21 @@ void TileKernel::checkReaders(const Readers& readers)
     // Non-matching SRS and we requested reprojection
     if (!m_outSrs.empty() && srs != m_outSrs)
         needRepro = true;
+    m_srs = m_outSrs.empty() ? srs : m_outSrs;
 
+    // Inputs are read concurrently, so each gets its own reprojection
+    // filter.
     if (needRepro)
     {
         Options opts;
         opts.add("out_srs", m_outSrs);
 
-        m_repro = dynamic_cast<Streamable *>(
-            &m_manager.makeFilter("filters.reprojection", opts));
+        for (Input& in : inputs)
+        {
+            in.repro = dynamic_cast<Streamable *>(
+                &m_manager.makeFilter("filters.reprojection", opts));
+            in.repro->prepare(m_table);
+        }
     }
 }
 
@@ -192,130 +395,195 @@ Streamable *TileKernel::prepareReader(const std::string& filename)
 }
 
 
-// We calculate the origin specially in order to avoid a "first point"
-// check for every point iteration, seeing as we might have BILLIONS
-// of points to process.
-void TileKernel::process(const Readers& readers)
+// Unless an origin was given, the first point read is the origin.  Find it
+// before the inputs are read concurrently so that it doesn't depend on
+// which input happens to be read first.
+void TileKernel::setOrigin(const Inputs& inputs)
 {
-    using std::placeholders::_1;
-    using std::placeholders::_2;
-    using std::placeholders::_3;
-    SplitterFilter::PointAdder adder =
-        std::bind(&TileKernel::adder, this, _1, _2, _3);
+    if (!std::isnan(m_xOrigin) && !std::isnan(m_yOrigin))
+    {
+        m_splitter.setOrigin(m_xOrigin, m_yOrigin);
+        return;
+    }
 
-    bool haveOrigin(false);
-    StageWrapper::ready(m_splitter, m_table);
-    for (auto&& rp : readers)
+    WorkerTable table(*m_table.layout(), 1);
+    PointRef point(table, 0);
+    for (const Input& in : inputs)
     {
-        Streamable& r = *(rp.second);
-        std::vector<bool> skips(m_table.capacity());
-        PointId idx(0);
-        PointRef point(m_table, idx);
-
-        StreamableWrapper::ready(r, m_table);
-        if (m_repro)
-            StreamableWrapper::spatialReferenceChanged(*m_repro,
-                r.getSpatialReference());
-
-        // Read first point.
-        bool finished(false);
-        finished = !StreamableWrapper::processOne(r, point);
-        if (!haveOrigin && !finished)
+        StreamableWrapper::ready(*in.reader, table);
+        bool found = StreamableWrapper::processOne(*in.reader, point);
+        StreamableWrapper::done(*in.reader, table);
+        if (found)
         {
             if (std::isnan(m_xOrigin))
                 m_xOrigin = point.getFieldAs<double>(Dimension::Id::X);
             if (std::isnan(m_yOrigin))
                 m_yOrigin = point.getFieldAs<double>(Dimension::Id::Y);
-            m_splitter.setOrigin(m_xOrigin, m_yOrigin);
-            haveOrigin = true;
+            break;
         }
+    }
+    m_splitter.setOrigin(m_xOrigin, m_yOrigin);
+}
+
+
+void TileKernel::process(const Inputs& inputs, TileStore& store)
+{
+    setOrigin(inputs);
+
+    ThreadPool pool((size_t)m_threads);
+    TaskError error;
+    for (const Input& in : inputs)
+        pool.add([this, &in, &store, &error]()
+            { error.run([&]() { ingest(in, store); }); });
+    pool.await();
+    error.check();
+}
 
-        idx++;
 
-        while (!finished)
+// Read an input, split its points into tiles a table at a time and append
+// each tile's points to its temporary file.
+void TileKernel::ingest(const Input& in, TileStore& store)
+{
+    WorkerTable table(*m_table.layout(), StreamTableSize);
+    const DimTypeList dimTypes = table.layout()->dimTypes();
+    const size_t pointSize = table.layout()->pointSize();
+    Streamable& r = *in.reader;
+
+    Partitioner partitioner;
+    SplitterFilter::PointAdder adder =
+        [&partitioner](PointRef& point, int xpos, int ypos)
+        { partitioner.add(Partitioner::cellKey(xpos, ypos), point.pointId()); };
+    std::vector<char> buf;
+    PointRef point(table, 0);
+
+    StreamableWrapper::ready(r, table);
+    if (in.repro)
+        StreamableWrapper::spatialReferenceChanged(*in.repro,
+            r.getSpatialReference());
+
+    bool finished(false);
+    while (!finished)
+    {
+        PointId end(0);
+        for (; end < table.capacity(); ++end)
         {
-            // Read subsequent points.
-            while (true)
+            point.setPointId(end);
+            if (!StreamableWrapper::processOne(r, point))
             {
-                point.setPointId(idx);
-                finished = !StreamableWrapper::processOne(r, point);
-                if (finished || idx == m_table.capacity() - 1)
-                    break;
-                idx++;
+                finished = true;
+                break;
             }
+        }
 
-            // "end" points just beyond the last valid point ID
-            PointId end = finished ? idx : m_table.capacity();
+        // Reproject if necessary and split.
+        partitioner.clear();
+        for (PointId idx = 0; idx < end; ++idx)
+        {
+            point.setPointId(idx);
+            if (in.repro && !StreamableWrapper::processOne(*in.repro, point))
+                continue;
+            m_splitter.processPoint(point, adder);
+        }
 
-            SpatialReference srs = r.getSpatialReference();
-            if (!srs.empty())
-                m_table.setSpatialReference(srs);
-            // Reproject if necessary.
-            if (m_repro)
+        for (const Partitioner::Group& g : partitioner.partition())
+        {
+            buf.resize((g.end - g.begin) * pointSize);
+            char *pos = buf.data();
+            for (const PointId *id = g.begin; id != g.end; ++id)
             {
-                for (idx = 0; idx < end; ++idx)
-                {
-                    point.setPointId(idx);
-                    if (!StreamableWrapper::processOne(*m_repro, point))
-                        skips[idx] = true;
-                }
-                SpatialReference srs = r.getSpatialReference();
-                if (!srs.empty())
-                    m_table.setSpatialReference(srs);
+                point.setPointId(*id);
+                point.getPackedData(dimTypes, pos);
+                pos += pointSize;
             }
+            store.append(Partitioner::cell(g.key), buf.data(), buf.size());
+        }
+    }
+    StreamableWrapper::done(r, table);
+    if (in.repro)
+        StreamableWrapper::done(*in.repro, table);
+}
 
-            // Split and write.
-            for (idx = 0; idx < end; ++idx)
-            {
-                if (skips[idx])
-                    continue;
 
-                point.setPointId(idx);
-                m_splitter.processPoint(point, adder);
-            }
-            for (size_t i = 0; i < skips.size(); ++i)
-                skips[i] = false;
-            idx = 0;
+// Convert the temporary tile files to output files, several at a time.
+void TileKernel::writeTiles(TileStore& store)
+{
+    store.close();
+    const auto tiles = store.tiles();
+
+    ThreadPool pool((size_t)m_threads);
+    TaskError error;
+    for (size_t i = 0; i < tiles.size(); i += m_threads)
+    {
+        // Stages are created on this thread.
+        size_t end = (std::min)(tiles.size(), i + m_threads);
+        std::vector<Streamable *> writers;
+        for (size_t j = i; j < end; ++j)
+            writers.push_back(makeWriter(tiles[j].first));
+
+        for (size_t j = i; j < end; ++j)
+        {
+            const std::string& tempFilename = tiles[j].second;
+            Streamable& writer = *writers[j - i];
+            pool.add([this, &tempFilename, &writer, &error]()
+                { error.run([&]() { writeTile(tempFilename, writer); }); });
         }
-        StreamableWrapper::done(r, m_table);
-        if (m_repro)
-            StreamableWrapper::done(*m_repro, m_table);
+        pool.await();
+        error.check();
     }
 }
 
 
-void TileKernel::adder(PointRef& point, int xpos, int ypos)
+Streamable *TileKernel::makeWriter(const Coord& loc)
 {
-    Coord loc(xpos, ypos);
+    std::string filename(m_outputFile);
+    std::string xname(std::to_string(loc.first));
+    std::string yname(std::to_string(loc.second));
+    filename.replace(m_hashPos, 1, (xname + "_" + yname));
+
+    Stage *w = &m_manager.makeWriter(filename, "");
+    if (!w)
+        throw pdal_error("Couldn't create writer for output file '" +
+            m_outputFile + "'.");
+    Streamable *sw = dynamic_cast<Streamable *>(w);
+    if (!sw)
+        throw pdal_error("Driver '" + w->getName() + "' for output file '" +
+            m_outputFile + "' is not streamable.");
+    sw->prepare(m_table);
+    return sw;
+}
 
-    Stage *w;
-    Streamable *sw;
 
-    auto wi = m_writers.find(loc);
-    if (wi == m_writers.end())
+void TileKernel::writeTile(const std::string& tempFilename, Streamable& writer)
+{
+    WorkerTable table(*m_table.layout(), StreamTableSize);
+    const DimTypeList dimTypes = table.layout()->dimTypes();
+    const size_t pointSize = table.layout()->pointSize();
+
+    std::ifstream in(tempFilename, std::ios::binary);
+    if (!in)
+        throw pdal_error("Unable to open temporary tile file '" +
+            tempFilename + "'.");
+
+    table.setSpatialReference(m_srs);
+    StreamableWrapper::spatialReferenceChanged(writer, m_srs);
+    StreamableWrapper::ready(writer, table);
+
+    std::vector<char> buf(pointSize * table.capacity());
+    PointRef point(table, 0);
+    while (in)
     {
-        std::string filename(m_outputFile);
-        std::string xname(std::to_string(xpos));
-        std::string yname(std::to_string(ypos));
-        filename.replace(m_hashPos, 1, (xname + "_" + yname));
-
-        w = &m_manager.makeWriter(filename, "");
-        if (!w)
-            throw pdal_error("Couldn't create writer for output file '" +
-                m_outputFile + "'.");
-        sw = dynamic_cast<Streamable *>(w);
-        if (!sw)
-            throw pdal_error("Driver '" + w->getName() + "' for output file '" +
-                m_outputFile + "' is not streamable.");
-        m_writers[loc] = sw;
-
-        sw->prepare(m_table);
-        StreamableWrapper::spatialReferenceChanged(*sw, m_outSrs);
-        StreamableWrapper::ready(*sw, m_table);
+        in.read(buf.data(), buf.size());
+        point_count_t count = (point_count_t)in.gcount() / pointSize;
+        const char *pos = buf.data();
+        for (PointId idx = 0; idx < count; ++idx)
+        {
+            point.setPointId(idx);
+            point.setPackedData(dimTypes, pos);
+            StreamableWrapper::processOne(writer, point);
+            pos += pointSize;
+        }
     }
-    else
-        sw = wi->second;
-    StreamableWrapper::processOne(*sw, point);
+    StreamableWrapper::done(writer, table);
 }
 
 } // namespace pdal
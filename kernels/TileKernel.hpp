@@ -34,7 +34,7 @@
 
 #pragma once
 
-#include <map>
+#include <vector>
 
 #include <pdal/Kernel.hpp>
 #include <filters/SplitterFilter.hpp>
@@ -42,10 +42,19 @@
 namespace pdal
 {
 
+class TileStore;
+
 class PDAL_EXPORT TileKernel : public Kernel
 {
     using Coord = std::pair<int, int>;
-    using Readers = std::map<std::string, Streamable *>;
+
+    struct Input
+    {
+        std::string filename;
+        Streamable *reader;
+        Streamable *repro;
+    };
+    using Inputs = std::vector<Input>;
 
 public:
     TileKernel();
@@ -56,9 +65,13 @@ private:
     void addSwitches(ProgramArgs& args);
     void validateSwitches(ProgramArgs& args);
     Streamable *prepareReader(const std::string& filename);
-    void process(const Readers& readers);
-    void checkReaders(const Readers& readers);
-    void adder(PointRef& point, int xpos, int ypos);
+    void checkReaders(Inputs& inputs);
+    void setOrigin(const Inputs& inputs);
+    void process(const Inputs& inputs, TileStore& store);
+    void ingest(const Input& input, TileStore& store);
+    void writeTiles(TileStore& store);
+    void writeTile(const std::string& tempFilename, Streamable& writer);
+    Streamable *makeWriter(const Coord& loc);
 
     std::string m_inputFile;
     std::string m_outputFile;
@@ -66,11 +79,13 @@ private:
     double m_xOrigin;
     double m_yOrigin;
     double m_buffer;
-    std::map<Coord, Streamable *> m_writers;
+    int m_threads;
+    int m_maxOpen;
+    std::string m_tempDir;
     FixedPointTable m_table;
     SplitterFilter m_splitter;
-    Streamable *m_repro;
     SpatialReference m_outSrs;
+    SpatialReference m_srs;  // SRS of the output tiles
     std::string::size_type m_hashPos;
 };
 
@@ -0,0 +1,590 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <fcntl.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#include <malloc.h>
+#include <windows.h>
+#endif
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+#include <arbiter/arbiter.hpp>
+
+#include <pdal/BlockAllocator.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+#include <pdal/util/Uuid.hpp>
+
+namespace pdal
+{
+
+BlockAllocator::~BlockAllocator()
+{}
+
+
+struct FileBlockAllocator::Private
+{
+    struct Mapping
+    {
+        std::size_t m_size;
+#ifdef _WIN32
+        HANDLE m_handle;
+#endif
+    };
+
+    // A mapped extent of the file from which blocks are carved.
+    struct Arena
+    {
+        char *m_base;
+        Mapping m_mapping;
+    };
+
+    Advice m_advice;
+    std::string m_filename;
+    uint64_t m_fileSize;
+    uint64_t m_granularity;
+    std::size_t m_pageSize;
+    std::vector<Arena> m_arenas;
+    // Bytes handed out from the last arena.
+    std::size_t m_arenaUsed;
+    // Freed blocks by (rounded) size.
+    std::map<std::size_t, std::vector<char *>> m_free;
+    // Blocks in use and their (rounded) sizes.
+    std::map<const char *, std::size_t> m_blocks;
+    mutable std::mutex m_mutex;
+#ifndef _WIN32
+    int m_fd;
+#else
+    HANDLE m_file;
+#endif
+
+    void open(const std::string& dir);
+    void close();
+    char *map(uint64_t offset, std::size_t size, Mapping& mapping);
+    void unmap(const char *block, const Mapping& mapping);
+    char *carve(std::size_t size);
+};
+
+
+#ifndef _WIN32
+
+void FileBlockAllocator::Private::open(const std::string& dir)
+{
+    m_pageSize = (std::size_t)::sysconf(_SC_PAGESIZE);
+    m_granularity = m_pageSize;
+    m_fd = ::open(m_filename.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (m_fd == -1)
+        throw pdal_error("Unable to create point data file '" + m_filename +
+            "' in '" + dir + "'.");
+    // The file goes away once it is closed.
+    ::unlink(m_filename.c_str());
+}
+
+
+void FileBlockAllocator::Private::close()
+{
+    ::close(m_fd);
+}
+
+
+char *FileBlockAllocator::Private::map(uint64_t offset, std::size_t size,
+    Mapping&)
+{
+    // Growing the file fills it with zeros without touching the disk.
+    if (::ftruncate(m_fd, (off_t)(offset + size)) != 0)
+        throw pdal_error("Unable to grow point data file '" + m_filename +
+            "'.");
+
+    void *addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+        m_fd, (off_t)offset);
+    if (addr == MAP_FAILED)
+        throw pdal_error("Unable to map point data file '" + m_filename +
+            "'.");
+
+    int advice = MADV_NORMAL;
+    if (m_advice == Advice::Sequential)
+        advice = MADV_SEQUENTIAL;
+    else if (m_advice == Advice::Random)
+        advice = MADV_RANDOM;
+    ::madvise(addr, size, advice);
+    return (char *)addr;
+}
+
+
+void FileBlockAllocator::Private::unmap(const char *block,
+    const Mapping& mapping)
+{
+    ::munmap((void *)block, mapping.m_size);
+}
+
+#else
+
+void FileBlockAllocator::Private::open(const std::string& dir)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    m_pageSize = info.dwPageSize;
+    m_granularity = info.dwAllocationGranularity;
+
+    m_file = CreateFileW(FileUtils::toNative(m_filename).c_str(),
+        GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_NEW,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, NULL);
+    if (m_file == INVALID_HANDLE_VALUE)
+        throw pdal_error("Unable to create point data file '" + m_filename +
+            "' in '" + dir + "'.");
+}
+
+
+void FileBlockAllocator::Private::close()
+{
+    CloseHandle(m_file);
+}
+
+
+char *FileBlockAllocator::Private::map(uint64_t offset, std::size_t size,
+    Mapping& mapping)
+{
+    // Creating a mapping larger than the file grows the file.
+    uint64_t end = offset + size;
+    mapping.m_handle = CreateFileMapping(m_file, NULL, PAGE_READWRITE,
+        (DWORD)(end >> 32), (DWORD)(end & 0xFFFFFFFF), NULL);
+    if (mapping.m_handle == NULL)
+        throw pdal_error("Unable to grow point data file '" + m_filename +
+            "'.");
+
+    void *addr = MapViewOfFile(mapping.m_handle, FILE_MAP_ALL_ACCESS,
+        (DWORD)(offset >> 32), (DWORD)(offset & 0xFFFFFFFF), size);
+    if (addr == NULL)
+    {
+        CloseHandle(mapping.m_handle);
+        throw pdal_error("Unable to map point data file '" + m_filename +
+            "'.");
+    }
+    return (char *)addr;
+}
+
+
+void FileBlockAllocator::Private::unmap(const char *block,
+    const Mapping& mapping)
+{
+    UnmapViewOfFile(block);
+    CloseHandle(mapping.m_handle);
+}
+
+#endif
+
+
+const std::size_t FileBlockAllocator::ArenaSize;
+
+
+// Take 'size' bytes from the last arena, mapping a new arena if it doesn't
+// have room.  Space that has never been handed out is already zero.
+char *FileBlockAllocator::Private::carve(std::size_t size)
+{
+    if (m_arenas.empty() ||
+        m_arenaUsed + size > m_arenas.back().m_mapping.m_size)
+    {
+        // The file offset of an arena must be a multiple of the mapping
+        // granularity.  The remainder of the previous arena is unused.
+        uint64_t g = m_granularity;
+        std::size_t arenaSize = (std::max)(ArenaSize, size);
+        arenaSize = (std::size_t)(((arenaSize + g - 1) / g) * g);
+
+        Arena arena { nullptr, { arenaSize } };
+        arena.m_base = map(m_fileSize, arenaSize, arena.m_mapping);
+        m_arenas.push_back(arena);
+        m_fileSize += arenaSize;
+        m_arenaUsed = 0;
+    }
+
+    char *block = m_arenas.back().m_base + m_arenaUsed;
+    m_arenaUsed += size;
+    return block;
+}
+
+
+FileBlockAllocator::FileBlockAllocator(const std::string& dir, Advice advice) :
+    m_p(new Private)
+{
+    std::string tempDir = dir.empty() ? arbiter::getTempPath() : dir;
+
+    m_p->m_advice = advice;
+    m_p->m_fileSize = 0;
+    m_p->m_arenaUsed = 0;
+    m_p->m_filename = arbiter::join(tempDir,
+        "pdal_points_" + RandomUuid().toString() + ".tmp");
+    m_p->open(tempDir);
+}
+
+
+FileBlockAllocator::~FileBlockAllocator()
+{
+    for (auto& a : m_p->m_arenas)
+        m_p->unmap(a.m_base, a.m_mapping);
+    m_p->close();
+}
+
+
+char *FileBlockAllocator::allocate(std::size_t size)
+{
+    // Blocks are page-aligned so that the system can page them in and out
+    // independently.
+    std::size_t page = m_p->m_pageSize;
+    size = ((size + page - 1) / page) * page;
+
+    char *block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+        auto it = m_p->m_free.find(size);
+        if (it != m_p->m_free.end() && it->second.size())
+        {
+            block = it->second.back();
+            it->second.pop_back();
+        }
+        else
+        {
+            char *fresh = m_p->carve(size);
+            m_p->m_blocks[fresh] = size;
+            return fresh;
+        }
+        m_p->m_blocks[block] = size;
+    }
+
+    // Reused space must be cleared.  Do it outside of the lock.
+    memset(block, 0, size);
+    return block;
+}
+
+
+void FileBlockAllocator::deallocate(char *block, std::size_t)
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    // Keep the space for reuse by a block of the same size.
+    auto it = m_p->m_blocks.find(block);
+    if (it != m_p->m_blocks.end())
+    {
+        m_p->m_free[it->second].push_back(block);
+        m_p->m_blocks.erase(it);
+    }
+}
+
+
+bool FileBlockAllocator::owns(const char *block) const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_blocks.find(block) != m_p->m_blocks.end();
+}
+
+
+uint64_t FileBlockAllocator::fileSize() const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_fileSize;
+}
+
+
+namespace
+{
+
+const std::size_t HugePageSize = 2 * 1024 * 1024;
+const std::size_t CacheLineSize = 64;
+
+char *alignedAlloc(std::size_t size, std::size_t alignment)
+{
+    void *p;
+#ifdef _WIN32
+    p = _aligned_malloc(size, alignment);
+#else
+    if (posix_memalign(&p, alignment, size) != 0)
+        p = nullptr;
+#endif
+    if (!p)
+        throw pdal_error("Unable to allocate block of " +
+            std::to_string(size) + " bytes.");
+    return (char *)p;
+}
+
+
+void alignedFree(char *p)
+{
+#ifdef _WIN32
+    _aligned_free(p);
+#else
+    free(p);
+#endif
+}
+
+} // unnamed namespace
+
+
+struct PoolBlockAllocator::Private
+{
+    Options m_options;
+    // Free blocks by (rounded) size.
+    std::map<std::size_t, std::vector<char *>> m_pool;
+    // Blocks in use and their (rounded) sizes.
+    std::map<const char *, std::size_t> m_blocks;
+    std::size_t m_pooledBytes;
+    std::size_t m_allocatedBytes;
+    std::size_t m_reuseCount;
+    mutable std::mutex m_mutex;
+
+    std::size_t m_pageSize;
+
+    std::size_t alignment(std::size_t size) const;
+    std::size_t roundSize(std::size_t size) const;
+    char *newBlock(std::size_t size) const;
+};
+
+
+// Small blocks are aligned to cache lines.  Blocks that may be placed on a
+// NUMA node must be page-aligned, and blocks that are large enough to hold a
+// huge page are aligned to huge pages.  Rounding a small block up to a huge
+// page would waste most of it.
+std::size_t PoolBlockAllocator::Private::alignment(std::size_t size) const
+{
+    if (m_options.m_hugePages && size >= HugePageSize)
+        return HugePageSize;
+    if (m_options.m_numaLocal)
+        return m_pageSize;
+    return CacheLineSize;
+}
+
+
+std::size_t PoolBlockAllocator::Private::roundSize(std::size_t size) const
+{
+    std::size_t granularity = (std::min)(alignment(size), m_pageSize);
+    return ((size + granularity - 1) / granularity) * granularity;
+}
+
+
+char *PoolBlockAllocator::Private::newBlock(std::size_t size) const
+{
+    char *block = alignedAlloc(size, alignment(size));
+#ifdef __linux__
+    // Both hints must be given before the pages are first touched.
+    if (m_options.m_hugePages && size >= HugePageSize)
+        madvise(block, size, MADV_HUGEPAGE);
+    if (m_options.m_numaLocal)
+    {
+        const int MpolLocal = 4;  // MPOL_LOCAL from <numaif.h>
+        // ENOSYS means the kernel has no NUMA support, so there's only one
+        // node.
+        if (syscall(SYS_mbind, block, size, MpolLocal, nullptr, 0, 0) != 0 &&
+            errno != ENOSYS)
+        {
+            int err = errno;
+            alignedFree(block);
+            throw pdal_error("Unable to place block of " +
+                std::to_string(size) + " bytes on the local NUMA node: " +
+                std::strerror(err) + ".");
+        }
+    }
+#endif
+    return block;
+}
+
+
+PoolBlockAllocator::PoolBlockAllocator(const Options& options) :
+    m_p(new Private)
+{
+    m_p->m_options = options;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    m_p->m_pageSize = info.dwPageSize;
+#else
+    m_p->m_pageSize = (std::size_t)::sysconf(_SC_PAGESIZE);
+#endif
+    m_p->m_pooledBytes = 0;
+    m_p->m_allocatedBytes = 0;
+    m_p->m_reuseCount = 0;
+}
+
+
+PoolBlockAllocator::~PoolBlockAllocator()
+{
+    clear();
+}
+
+
+char *PoolBlockAllocator::allocate(std::size_t size)
+{
+    size = m_p->roundSize(size);
+
+    char *block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+        auto it = m_p->m_pool.find(size);
+        if (it != m_p->m_pool.end() && it->second.size())
+        {
+            block = it->second.back();
+            it->second.pop_back();
+            m_p->m_pooledBytes -= size;
+            m_p->m_reuseCount++;
+        }
+    }
+
+    // Allocate and clear outside of the lock.
+    if (!block)
+        block = m_p->newBlock(size);
+    memset(block, 0, size);
+
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+    m_p->m_blocks[block] = size;
+    m_p->m_allocatedBytes += size;
+    return block;
+}
+
+
+void PoolBlockAllocator::deallocate(char *block, std::size_t)
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    auto it = m_p->m_blocks.find(block);
+    if (it == m_p->m_blocks.end())
+        return;
+    std::size_t size = it->second;
+    m_p->m_blocks.erase(it);
+    m_p->m_allocatedBytes -= size;
+
+    std::size_t max = m_p->m_options.m_maxPoolBytes;
+    if (max && m_p->m_pooledBytes + size > max)
+        alignedFree(block);
+    else
+    {
+        m_p->m_pool[size].push_back(block);
+        m_p->m_pooledBytes += size;
+    }
+}
+
+
+bool PoolBlockAllocator::owns(const char *block) const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_blocks.find(block) != m_p->m_blocks.end();
+}
+
+
+std::size_t PoolBlockAllocator::pooledBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_pooledBytes;
+}
+
+
+std::size_t PoolBlockAllocator::allocatedBytes() const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_allocatedBytes;
+}
+
+
+std::size_t PoolBlockAllocator::reuseCount() const
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    return m_p->m_reuseCount;
+}
+
+
+void PoolBlockAllocator::clear()
+{
+    std::lock_guard<std::mutex> lock(m_p->m_mutex);
+
+    for (auto& p : m_p->m_pool)
+        for (char *block : p.second)
+            alignedFree(block);
+    m_p->m_pool.clear();
+    m_p->m_pooledBytes = 0;
+}
+
+
+std::istream& operator>>(std::istream& in, FileBlockAllocator::Advice& advice)
+{
+    std::string s;
+    in >> s;
+    s = Utils::tolower(s);
+    if (s == "normal")
+        advice = FileBlockAllocator::Advice::Normal;
+    else if (s == "sequential")
+        advice = FileBlockAllocator::Advice::Sequential;
+    else if (s == "random")
+        advice = FileBlockAllocator::Advice::Random;
+    else
+        in.setstate(std::ios_base::failbit);
+    return in;
+}
+
+
+std::ostream& operator<<(std::ostream& out,
+    const FileBlockAllocator::Advice& advice)
+{
+    switch (advice)
+    {
+    case FileBlockAllocator::Advice::Normal:
+        out << "normal";
+        break;
+    case FileBlockAllocator::Advice::Sequential:
+        out << "sequential";
+        break;
+    case FileBlockAllocator::Advice::Random:
+        out << "random";
+        break;
+    }
+    return out;
+}
+
+} // namespace pdal
@@ -0,0 +1,183 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+
+/**
+  Provides memory for the blocks of point data held by point tables.
+  Allocators may be called from several threads at once.
+*/
+class PDAL_EXPORT BlockAllocator
+{
+public:
+    virtual ~BlockAllocator();
+
+    /**
+      Allocate a zero-filled block.  Throws pdal_error on failure.
+
+      \param size  Size of the block in bytes.
+      \return  Pointer to the block.
+    */
+    virtual char *allocate(std::size_t size) = 0;
+
+    /**
+      Free a block returned by allocate().
+
+      \param block  Pointer to the block.
+      \param size  Size of the block in bytes.
+    */
+    virtual void deallocate(char *block, std::size_t size) = 0;
+
+    /**
+      Return whether a block was allocated by this allocator.
+    */
+    virtual bool owns(const char *block) const = 0;
+};
+using BlockAllocatorPtr = std::shared_ptr<BlockAllocator>;
+
+/**
+  Allocates blocks from a memory-mapped temporary file so that the operating
+  system can page point data to disk rather than running out of memory.
+  The file is mapped in large arenas from which blocks are carved, so the
+  number of mappings stays small.  The space of a freed block is reused by
+  later blocks of the same size.  The file is removed when the allocator is
+  destroyed (or when the process exits).
+*/
+class PDAL_EXPORT FileBlockAllocator : public BlockAllocator
+{
+public:
+    /// Hint to the operating system about how blocks will be accessed.
+    enum class Advice
+    {
+        Normal,
+        Sequential,
+        Random
+    };
+
+    /**
+      \param dir  Directory for the temporary file.  The system temporary
+        directory is used if empty.
+      \param advice  Access pattern hint applied to each block.
+    */
+    FileBlockAllocator(const std::string& dir = "",
+        Advice advice = Advice::Normal);
+    ~FileBlockAllocator();
+
+    char *allocate(std::size_t size) override;
+    void deallocate(char *block, std::size_t size) override;
+    bool owns(const char *block) const override;
+
+    /// Return the number of bytes in the temporary file.
+    uint64_t fileSize() const;
+
+    /// Size of the file extents that are mapped into memory.  Larger blocks
+    /// get an extent of their own.
+    static const std::size_t ArenaSize = 256 * 1024 * 1024;
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_p;
+
+    FileBlockAllocator(const FileBlockAllocator&) = delete;
+    FileBlockAllocator& operator=(const FileBlockAllocator&) = delete;
+};
+
+/**
+  Keeps freed blocks in a pool and hands them out again, so that tables
+  created repeatedly (by a long-running service, for example) don't return
+  their memory to the system and fault it back in on every execution.
+  A single pool can be shared by any number of tables, including tables that
+  are in use on different threads.
+*/
+class PDAL_EXPORT PoolBlockAllocator : public BlockAllocator
+{
+public:
+    struct Options
+    {
+        Options() : m_maxPoolBytes(0), m_hugePages(false), m_numaLocal(false)
+        {}
+
+        /// Largest number of bytes of free blocks kept in the pool.  Zero
+        /// means no limit.
+        std::size_t m_maxPoolBytes;
+        /// Align blocks of 2MB or more to huge page boundaries and, on
+        /// Linux, ask for transparent huge pages.  Smaller blocks are
+        /// allocated as usual.
+        bool m_hugePages;
+        /// On Linux, place new blocks on the NUMA node of the allocating
+        /// thread, even if the process memory policy says otherwise.  Blocks
+        /// are page-aligned.  Allocation throws pdal_error if a block can't
+        /// be placed.
+        bool m_numaLocal;
+    };
+
+    PoolBlockAllocator(const Options& options = Options());
+    ~PoolBlockAllocator();
+
+    char *allocate(std::size_t size) override;
+    void deallocate(char *block, std::size_t size) override;
+    bool owns(const char *block) const override;
+
+    /// Return the number of bytes of free blocks in the pool.
+    std::size_t pooledBytes() const;
+    /// Return the number of bytes of blocks handed out and not yet freed.
+    std::size_t allocatedBytes() const;
+    /// Return the number of allocations satisfied from the pool.
+    std::size_t reuseCount() const;
+    /// Return all free blocks to the system.
+    void clear();
+
+private:
+    struct Private;
+    std::unique_ptr<Private> m_p;
+
+    PoolBlockAllocator(const PoolBlockAllocator&) = delete;
+    PoolBlockAllocator& operator=(const PoolBlockAllocator&) = delete;
+};
+
+PDAL_EXPORT std::istream& operator>>(std::istream& in,
+    FileBlockAllocator::Advice& advice);
+PDAL_EXPORT std::ostream& operator<<(std::ostream& out,
+    const FileBlockAllocator::Advice& advice);
+
+} // namespace pdal
@@ -39,9 +39,15 @@ namespace pdal
 
 ColumnPointTable::~ColumnPointTable()
 {
-    for (DimBlockList& l : m_blocks)
-        for (auto ptr : l)
-            delete [] ptr;
+    if (m_blocks.empty())
+        return;
+    for (Dimension::Id id : m_layoutRef.dims())
+    {
+        const Dimension::Detail *detail = m_layoutRef.dimDetail(id);
+        size_t size = m_blockPtCnt * Dimension::size(detail->type());
+        for (char *ptr : m_blocks[detail->order()])
+            freeBlock(ptr, size);
+    }
 }
 
 
@@ -56,16 +62,17 @@ PointId ColumnPointTable::addPoint()
 {
     if (m_numPts % m_blockPtCnt == 0)
     {
+        // Account for the blocks of all dimensions at once so that we fail
+        // before allocating any of them and spill all or none of them.
+        bool spill = !reserveMemory(pointsToBytes(m_blockPtCnt));
         for (Dimension::Id id : m_layoutRef.dims())
         {
             const Dimension::Detail *detail = m_layoutRef.dimDetail(id);
 
             // Make a block that holds m_blockPtCnt values of a dimension.
             size_t size = m_blockPtCnt * Dimension::size(detail->type());
-            char *buf = new char[size];
-            memset(buf, 0, size);
             DimBlockList& dimBlocks = m_blocks[detail->order()];
-            dimBlocks.push_back(buf);
+            dimBlocks.push_back(allocateBlock(size, spill));
         }
     }
     return m_numPts++;
@@ -55,6 +55,52 @@ Kernel::Kernel() : m_showTime(false), m_hardCoreDebug(false)
 {}
 
 
+namespace
+{
+
+// Parse a byte count with an optional K, M, G or T (binary) suffix.
+std::size_t parseMemorySize(const std::string& s)
+{
+    if (s.empty())
+        return 0;
+
+    size_t pos;
+    double value;
+    try
+    {
+        value = std::stod(s, &pos);
+    }
+    catch (...)
+    {
+        pos = 0;
+    }
+
+    std::string suffix = Utils::toupper(s.substr(pos));
+    if (suffix.size() > 1 && suffix.back() == 'B')
+        suffix.pop_back();
+    if (suffix.size() > 1 && suffix.back() == 'I')
+        suffix.pop_back();
+
+    double mult = 0;
+    if (suffix.empty() || suffix == "B")
+        mult = 1;
+    else if (suffix == "K")
+        mult = 1024.0;
+    else if (suffix == "M")
+        mult = 1024.0 * 1024;
+    else if (suffix == "G")
+        mult = 1024.0 * 1024 * 1024;
+    else if (suffix == "T")
+        mult = 1024.0 * 1024 * 1024 * 1024;
+    if (pos == 0 || mult == 0 || value < 0)
+        throw pdal_error("Invalid memory budget '" + s + "'.  Expected a "
+            "number of bytes with an optional K, M, G or T suffix.");
+    return (std::size_t)(value * mult);
+}
+
+} // unnamed namespace
+
+
 // Overridden in PipelineKernel to accept "stage" as well.
 bool Kernel::isStagePrefix(const std::string& stageType)
 {
@@ -270,6 +316,14 @@ int Kernel::innerRun(ProgramArgs& args)
 {
     try
     {
+        m_manager.setMemoryBudget(parseMemorySize(m_memoryBudget));
+        if (args.set("spill_dir"))
+        {
+            if (!args.set("memory_budget"))
+                throw pdal_error("Option 'spill_dir' requires "
+                    "'memory_budget'.");
+            m_manager.setSpill(m_spillDir, m_spillAdvice);
+        }
         // do any user-level sanity checking
         validateSwitches(args);
     }
@@ -313,6 +367,13 @@ void Kernel::addBasicSwitches(ProgramArgs& args)
         "Enable developer debug (don't trap exceptions)", m_hardCoreDebug);
     args.add("label", "A string to label the process with", m_label);
     args.add("driver", "Override reader driver", m_driverOverride);
+    args.add("memory_budget", "Maximum memory for point storage, in bytes "
+        "with an optional K, M, G or T suffix (e.g. '4G')", m_memoryBudget);
+    args.add("spill_dir", "Directory for a temporary file holding point "
+        "data beyond the memory budget", m_spillDir);
+    args.add("spill_advice", "Expected access pattern of spilled point data "
+        "('normal', 'sequential' or 'random')", m_spillAdvice,
+        FileBlockAllocator::Advice::Normal);
     args.add("help", "Print help and exit", s_help);
 }
 
@@ -132,6 +132,9 @@ private:
     bool m_showTime;
     bool m_hardCoreDebug;
     std::string m_label;
+    std::string m_memoryBudget;
+    std::string m_spillDir;
+    FileBlockAllocator::Advice m_spillAdvice;
 };
 
 PDAL_EXPORT std::ostream& operator<<(std::ostream& ostr, const Kernel&);
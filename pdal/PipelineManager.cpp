@@ -45,9 +45,10 @@
 namespace pdal
 {
 
-PipelineManager::PipelineManager(point_count_t streamLimit) :
+PipelineManager::PipelineManager(point_count_t streamLimit,
+        BlockAllocatorPtr allocator) :
     m_factory(new StageFactory),
-    m_tablePtr(new ColumnPointTable()), m_table(*m_tablePtr),
+    m_tablePtr(new ColumnPointTable(allocator)), m_table(*m_tablePtr),
     m_streamTablePtr(new FixedPointTable(streamLimit)),
     m_streamTable(*m_streamTablePtr),
     m_progressFd(-1), m_input(nullptr)
@@ -200,6 +201,45 @@ bool PipelineManager::hasReader() const
 }
 
 
+void PipelineManager::setProfiling(bool profile, bool trace)
+{
+    if (profile)
+        m_profiler.reset(new Profiler(trace));
+    else
+        m_profiler.reset();
+    for (Stage *s : m_stages)
+        s->setProfiler(m_profiler.get());
+}
+
+
+void PipelineManager::setMemoryBudget(std::size_t bytes)
+{
+    m_table.setMemoryBudget(bytes);
+    m_streamTable.setMemoryBudget(bytes);
+}
+
+
+void PipelineManager::setSpill(const std::string& dir,
+    FileBlockAllocator::Advice advice)
+{
+    m_tablePtr->setSpillAllocator(
+        std::make_shared<FileBlockAllocator>(dir, advice));
+}
+
+
+// Attach the profiler to all stages, including those added since profiling
+// was enabled, and discard the results of any previous run.
+void PipelineManager::startProfiling()
+{
+    if (!m_profiler)
+        return;
+
+    m_profiler->clear();
+    for (Stage *s : m_stages)
+        s->setProfiler(m_profiler.get());
+}
+
+
 QuickInfo PipelineManager::preview() const
 {
     QuickInfo qi;
@@ -230,6 +270,7 @@ PipelineManager::ExecResult PipelineManager::execute(ExecMode mode)
     if (!s)
         return result;
 
+    startProfiling();
     if (mode == ExecMode::PreferStream)
     {
         // If a pipeline isn't streamable before being prepared, it's not
@@ -296,6 +337,7 @@ void PipelineManager::executeStream(StreamPointTable& table)
     if (!s)
         return;
 
+    startProfiling();
     s->prepare(table);
     s->execute(table);
 }
@@ -309,6 +351,9 @@ MetadataNode PipelineManager::getMetadata() const
     {
         output.add(s->getMetadata());
     }
+    if (m_profiler)
+        output.add(m_profiler->toMetadata());
+    output.add(pointTable().memoryMetadata());
     return output;
 }
 
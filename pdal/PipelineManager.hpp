@@ -39,6 +39,7 @@
 #include <pdal/Options.hpp>
 #include <pdal/Log.hpp>
 #include <pdal/FileSpec.hpp>
+#include <pdal/Profiler.hpp>
 
 #include <vector>
 #include <string>
@@ -84,12 +85,32 @@ public:
         point_count_t m_count;
     };
 
-    PipelineManager(point_count_t streamLimit = 10000);
+    // If 'allocator' is provided, point storage for standard mode is
+    // allocated with it.  A pooling allocator shared between managers
+    // lets point memory be reused from one execution to the next.
+    PipelineManager(point_count_t streamLimit = 10000,
+        BlockAllocatorPtr allocator = BlockAllocatorPtr());
     ~PipelineManager();
 
     void setProgressFd(int fd)
         { m_progressFd = fd; }
 
+    // Profile the stages when the pipeline is executed.  If 'trace' is
+    // true, timed events are kept so that a trace can be written with
+    // Profiler::writeTrace().
+    void setProfiling(bool profile, bool trace = false);
+    // Limit the memory used for point storage.  Execution fails with an
+    // error if the limit would be exceeded.  Zero means no limit.
+    void setMemoryBudget(std::size_t bytes);
+    // Store point data that doesn't fit in the memory budget in a
+    // temporary file in 'dir' (the system temporary directory if empty).
+    // Has no effect in stream mode or without a memory budget.
+    void setSpill(const std::string& dir,
+        FileBlockAllocator::Advice advice = FileBlockAllocator::Advice::Normal);
+    // Get the profiler, or nullptr if profiling isn't enabled.
+    const Profiler *profiler() const
+        { return m_profiler.get(); }
+
     void readPipeline(std::istream& input);
     void readPipeline(const std::string& filename);
 
@@ -174,6 +195,7 @@ public:
 private:
     void setOptions(Stage& stage, const Options& addOps);
     Options stageOptions(Stage& stage);
+    void startProfiling();
 
     std::unique_ptr<StageFactory> m_factory;
     std::unique_ptr<SimplePointTable> m_tablePtr;
@@ -187,6 +209,7 @@ private:
     int m_progressFd;
     std::istream *m_input;
     LogPtr m_log;
+    std::unique_ptr<Profiler> m_profiler;
 
     PipelineManager& operator=(const PipelineManager&); // not implemented
     PipelineManager(const PipelineManager&); // not implemented
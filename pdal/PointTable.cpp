@@ -32,6 +32,8 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <sstream>
+
 #include <pdal/ArtifactManager.hpp>
 #include <pdal/PointTable.hpp>
 
@@ -39,7 +41,8 @@ namespace pdal
 {
 
 BasePointTable::BasePointTable(PointLayout& layout) :
-    m_metadata(new Metadata()), m_layoutRef(layout)
+    m_metadata(new Metadata()), m_layoutRef(layout), m_memoryUsage(0),
+    m_peakMemoryUsage(0), m_memoryBudget(0)
 {}
 
 
@@ -70,6 +73,50 @@ void BasePointTable::addSpatialReference(const SpatialReference& spatialRef)
 }
 
 
+bool BasePointTable::reserveMemory(std::size_t bytes)
+{
+    if (m_memoryBudget && m_memoryUsage + bytes > m_memoryBudget)
+        if (overBudget(bytes))
+            return false;
+    m_memoryUsage += bytes;
+    m_peakMemoryUsage = (std::max)(m_peakMemoryUsage, m_memoryUsage);
+    return true;
+}
+
+
+void BasePointTable::releaseMemory(std::size_t bytes)
+{
+    m_memoryUsage -= (std::min)(bytes, m_memoryUsage);
+}
+
+
+bool BasePointTable::overBudget(std::size_t bytes)
+{
+    std::ostringstream oss;
+
+    oss << "Point table memory budget of " << m_memoryBudget << " bytes "
+        "exceeded.  " << m_memoryUsage << " bytes are in use and " << bytes <<
+        " more are needed.  Increase the budget, spill points to disk or "
+        "run the pipeline in stream mode.";
+    throw pdal_error(oss.str());
+}
+
+
+MetadataNode BasePointTable::memoryMetadata() const
+{
+    MetadataNode m("memory");
+
+    m.add("table_bytes", m_memoryUsage, "Bytes allocated for point storage");
+    m.add("peak_table_bytes", m_peakMemoryUsage,
+        "Largest number of bytes allocated for point storage");
+    m.add("budget_bytes", m_memoryBudget,
+        "Limit on bytes allocated for point storage (0 is no limit)");
+    m.add("spilled_bytes", spilledBytes(),
+        "Bytes of point storage held on disk");
+    return m;
+}
+
+
 ArtifactManager& BasePointTable::artifactManager()
 {
     if (!m_artifactManager)
@@ -97,10 +144,49 @@ void SimplePointTable::getFieldInternal(Dimension::Id id, PointId idx, void *val
 }
 
 
+bool SimplePointTable::overBudget(std::size_t bytes)
+{
+    if (!m_spillAllocator)
+        return BasePointTable::overBudget(bytes);
+    m_spilledBytes += bytes;
+    return true;
+}
+
+
+char *SimplePointTable::allocateBlock(std::size_t size, bool spill)
+{
+    if (spill)
+        return m_spillAllocator->allocate(size);
+    if (m_allocator)
+        return m_allocator->allocate(size);
+
+    char *buf = new char[size];
+    memset(buf, 0, size);
+    return buf;
+}
+
+
+void SimplePointTable::freeBlock(char *block, std::size_t size)
+{
+    if (m_spillAllocator && m_spillAllocator->owns(block))
+    {
+        m_spillAllocator->deallocate(block, size);
+        m_spilledBytes -= (std::min)(size, m_spilledBytes);
+        return;
+    }
+
+    if (m_allocator)
+        m_allocator->deallocate(block, size);
+    else
+        delete [] block;
+    releaseMemory(size);
+}
+
+
 RowPointTable::~RowPointTable()
 {
-    for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
-        delete [] *vi;
+    for (char *block : m_blocks)
+        freeBlock(block, pointsToBytes(m_blockPtCnt));
 }
 
 PointId RowPointTable::addPoint()
@@ -108,9 +194,8 @@ PointId RowPointTable::addPoint()
     if (m_numPts % m_blockPtCnt == 0)
     {
         size_t size = pointsToBytes(m_blockPtCnt);
-        char *buf = new char[size];
-        memset(buf, 0, size);
-        m_blocks.push_back(buf);
+        bool spill = !reserveMemory(size);
+        m_blocks.push_back(allocateBlock(size, spill));
     }
     return m_numPts++;
 }
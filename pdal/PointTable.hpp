@@ -38,6 +38,7 @@
 #include <list>
 #include <vector>
 
+#include "pdal/BlockAllocator.hpp"
 #include "pdal/SpatialReference.hpp"
 #include "pdal/Dimension.hpp"
 #include "pdal/PointLayout.hpp"
@@ -91,6 +92,23 @@ public:
     }
     virtual bool supportsView() const
         { return false; }
+    /// Return the number of bytes allocated for point storage.
+    std::size_t memoryUsage() const
+        { return m_memoryUsage; }
+    /// Return the largest number of bytes allocated for point storage.
+    std::size_t peakMemoryUsage() const
+        { return m_peakMemoryUsage; }
+    /// Limit the number of bytes allocated for point storage.  Zero means
+    /// no limit.
+    void setMemoryBudget(std::size_t bytes)
+        { m_memoryBudget = bytes; }
+    std::size_t memoryBudget() const
+        { return m_memoryBudget; }
+    /// Return the number of bytes of point storage held on disk.
+    virtual std::size_t spilledBytes() const
+        { return 0; }
+    /// Return memory usage as a metadata node named "memory".
+    MetadataNode memoryMetadata() const;
     MetadataNode privateMetadata(const std::string& name);
     MetadataNode toMetadata() const;
     ArtifactManager& artifactManager();
@@ -105,11 +123,28 @@ private:
 protected:
     virtual char *getPoint(PointId idx) = 0;
 
+    /// Account for 'bytes' of point storage that are about to be allocated.
+    /// If this would exceed the memory budget, overBudget() is called first.
+    /// Returns false if the storage is to be placed outside of memory.
+    bool reserveMemory(std::size_t bytes);
+    /// Account for 'bytes' of point storage that have been freed.
+    void releaseMemory(std::size_t bytes);
+    /// Called when allocating 'bytes' would exceed the memory budget.  A
+    /// table that can store the points elsewhere (by spilling to disk, for
+    /// example) returns true and the bytes aren't counted against the
+    /// budget.  The default throws pdal_error.
+    virtual bool overBudget(std::size_t bytes);
+
 protected:
     MetadataPtr m_metadata;
     std::list<SpatialReference> m_spatialRefs;
     PointLayout& m_layoutRef;
     std::unique_ptr<ArtifactManager> m_artifactManager;
+
+private:
+    std::size_t m_memoryUsage;
+    std::size_t m_peakMemoryUsage;
+    std::size_t m_memoryBudget;
 };
 typedef BasePointTable& PointTableRef;
 typedef BasePointTable const & ConstPointTableRef;
@@ -118,12 +153,25 @@ class PDAL_EXPORT SimplePointTable : public BasePointTable
 {
 
 protected:
-    SimplePointTable(PointLayout& layout) : BasePointTable(layout)
+    SimplePointTable(PointLayout& layout,
+            BlockAllocatorPtr allocator = BlockAllocatorPtr()) :
+        BasePointTable(layout), m_allocator(allocator), m_spilledBytes(0)
         {}
 
+public:
+    /// Store point blocks with 'allocator' once the memory budget is
+    /// reached.  Has no effect if there is no budget.
+    void setSpillAllocator(BlockAllocatorPtr allocator)
+        { m_spillAllocator = allocator; }
+    std::size_t spilledBytes() const override
+        { return m_spilledBytes; }
+
 protected:
     std::size_t pointsToBytes(point_count_t numPts) const
         { return m_layoutRef.pointSize() * numPts; }
+    bool overBudget(std::size_t bytes) override;
+    char *allocateBlock(std::size_t size, bool spill);
+    void freeBlock(char *block, std::size_t size);
 
 private:
     void setFieldInternal(Dimension::Id id, PointId idx, const void *value) override;
@@ -137,6 +185,10 @@ private:
         SimplePointTable *ncThis = const_cast<SimplePointTable *>(this);
         return ncThis->getPoint(idx) + d->offset();
     }
+
+    BlockAllocatorPtr m_allocator;
+    BlockAllocatorPtr m_spillAllocator;
+    std::size_t m_spilledBytes;
 };
 
 // This provides a context for processing a set of points and allows the library
@@ -154,6 +206,10 @@ private:
 public:
     RowPointTable() : SimplePointTable(m_layout), m_numPts(0)
         {}
+    /// Allocate point blocks with 'allocator' instead of the heap.
+    explicit RowPointTable(BlockAllocatorPtr allocator) :
+        SimplePointTable(m_layout, allocator), m_numPts(0)
+        {}
     virtual ~RowPointTable();
     bool supportsView() const override
         { return true; }
@@ -188,6 +244,10 @@ private:
 public:
     ColumnPointTable() : SimplePointTable(m_layout), m_numPts(0)
         {}
+    /// Allocate dimension blocks with 'allocator' instead of the heap.
+    explicit ColumnPointTable(BlockAllocatorPtr allocator) :
+        SimplePointTable(m_layout, allocator), m_numPts(0)
+        {}
     virtual ~ColumnPointTable();
     bool supportsView() const override
         { return true; }
@@ -286,7 +346,9 @@ public:
         if (!m_layout.finalized())
         {
             BasePointTable::finalize();
-            m_buf.resize(pointsToBytes(capacity() + 1));
+            size_t size = pointsToBytes(capacity() + 1);
+            reserveMemory(size);
+            m_buf.resize(size);
         }
     }
 
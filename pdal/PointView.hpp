@@ -92,6 +92,8 @@ public:
         { return m_size == 0; }
 
     inline void appendPoint(const PointView& buffer, PointId id);
+    inline void appendPoints(const PointView& buffer, const PointId *begin,
+        const PointId *end);
     void append(const PointView& buf)
     {
         // We use size() instead of the index end because temp points might have been
@@ -570,6 +572,18 @@ inline void PointView::appendPoint(const PointView& buffer, PointId id)
     m_size++;
 }
 
+// Append the points with the ids in [begin, end) from 'buffer'.
+inline void PointView::appendPoints(const PointView& buffer,
+    const PointId *begin, const PointId *end)
+{
+    // Invalid ids are a programmer error.
+    size_t pos = m_index.size();
+    m_index.resize(pos + (end - begin));
+    for (auto di = m_index.begin() + pos; begin != end; ++begin, ++di)
+        *di = buffer.m_index[*begin];
+    m_size += (point_count_t)(m_index.size() - pos);
+}
+
 
 PDAL_EXPORT std::ostream& operator<<(std::ostream& ostr, const PointView&);
 
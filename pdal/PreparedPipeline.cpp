@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include <functional>
+
+#include <pdal/PreparedPipeline.hpp>
+#include <pdal/Reader.hpp>
+#include <pdal/Stage.hpp>
+#include <pdal/util/ProgramArgs.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Restores the stages' options when an execution ends, including when it
+// ends with an exception.
+class OptionsGuard
+{
+public:
+    OptionsGuard(std::function<void()> restore) : m_restore(restore)
+    {}
+    ~OptionsGuard()
+        { m_restore(); }
+
+private:
+    std::function<void()> m_restore;
+};
+
+} // unnamed namespace
+
+
+PreparedPipeline::PreparedPipeline(PipelineManagerPtr mgr) :
+    m_manager(std::move(mgr))
+{
+    init();
+}
+
+
+PreparedPipeline::PreparedPipeline(std::istream& input) :
+    m_manager(new PipelineManager)
+{
+    m_manager->readPipeline(input);
+    init();
+}
+
+
+PreparedPipeline::PreparedPipeline(const std::string& filename) :
+    m_manager(new PipelineManager)
+{
+    m_manager->readPipeline(filename);
+    init();
+}
+
+
+PreparedPipeline::~PreparedPipeline()
+{}
+
+
+void PreparedPipeline::init()
+{
+    m_manager->validateStageOptions();
+    m_leaf = m_manager->getStage();
+    if (!m_leaf)
+        throw pdal_error("Can't prepare a pipeline with no stages.");
+
+    for (Stage *s : m_manager->stages())
+    {
+        m_options[s] = s->getOptions();
+        if (dynamic_cast<Reader *>(s))
+        {
+            m_readers.push_back(s);
+
+            // Not every reader can be limited to a region.
+            ProgramArgs args;
+            s->addAllArgs(args);
+            if (args.has("bounds"))
+                m_boundsReaders.push_back(s);
+            if (args.has("polygon"))
+                m_polygonReaders.push_back(s);
+        }
+    }
+    m_streamable = m_leaf->pipelineStreamable();
+    m_executionCount = 0;
+}
+
+
+void PreparedPipeline::applyOverrides(const Overrides& overrides)
+{
+    if (overrides.m_filename.size())
+    {
+        if (m_readers.size() != 1)
+            throw pdal_error("Can't override the filename of a pipeline "
+                "with " + std::to_string(m_readers.size()) + " readers.");
+        Options opts(Option("filename", overrides.m_filename));
+        m_readers.front()->removeOptions(opts);
+        m_readers.front()->addOptions(opts);
+    }
+
+    if (overrides.m_bounds.size())
+    {
+        if (m_boundsReaders.empty())
+            throw pdal_error("Can't override the bounds of a pipeline "
+                "with no reader that has a 'bounds' option.");
+        Options opts(Option("bounds", overrides.m_bounds));
+        for (Stage *s : m_boundsReaders)
+        {
+            s->removeOptions(opts);
+            s->addOptions(opts);
+        }
+    }
+
+    if (overrides.m_polygons.size())
+    {
+        if (m_polygonReaders.empty())
+            throw pdal_error("Can't override the polygon of a pipeline "
+                "with no reader that has a 'polygon' option.");
+        Options opts;
+        for (const std::string& polygon : overrides.m_polygons)
+            opts.add("polygon", polygon);
+        for (Stage *s : m_polygonReaders)
+        {
+            s->removeOptions(opts);
+            s->addOptions(opts);
+        }
+    }
+
+    for (auto& so : overrides.m_stageOptions)
+    {
+        auto it = std::find_if(m_options.begin(), m_options.end(),
+            [&so](const std::pair<Stage * const, Options>& p)
+            { return p.first->tag() == so.first; });
+        if (it == m_options.end())
+            throw pdal_error("Options given for stage with tag '" +
+                so.first + "', which isn't in the pipeline.");
+        it->first->removeOptions(so.second);
+        it->first->addOptions(so.second);
+    }
+}
+
+
+void PreparedPipeline::restoreOptions()
+{
+    for (auto& p : m_options)
+        p.first->setOptions(p.second);
+}
+
+
+PointViewSet PreparedPipeline::execute(PointTableRef table,
+    const Overrides& overrides)
+{
+    OptionsGuard guard([this](){ restoreOptions(); });
+    applyOverrides(overrides);
+
+    // The stages are prepared again because the options and the table
+    // change with each execution.
+    m_executionCount++;
+    m_leaf->prepare(table);
+    return m_leaf->execute(table);
+}
+
+
+void PreparedPipeline::executeStream(StreamPointTable& table,
+    const Overrides& overrides)
+{
+    if (!m_streamable)
+        throw pdal_error("Can't execute a non-streamable pipeline in "
+            "stream mode.");
+
+    OptionsGuard guard([this](){ restoreOptions(); });
+    applyOverrides(overrides);
+
+    m_executionCount++;
+    m_leaf->prepare(table);
+    m_leaf->execute(table);
+}
+
+} // namespace pdal
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include <pdal/PipelineManager.hpp>
+
+namespace pdal
+{
+
+/**
+  A pipeline that is read and built once and then executed any number of
+  times, each time with its own point table and, optionally, its own
+  input file, query bounds and other options.  The parsed pipeline, its
+  stages, loaded plugins and coordinate transformations are kept from one
+  execution to the next.  Each execution still prepares the stages: their
+  options may differ from the previous execution and their dimensions
+  must be registered with the new point table.
+
+  A prepared pipeline runs one execution at a time.  A service that runs
+  executions concurrently should create a prepared pipeline for each
+  thread.
+*/
+class PDAL_EXPORT PreparedPipeline
+{
+public:
+    /// Options for a single execution.  Empty values leave the pipeline's
+    /// own options in place.
+    struct Overrides
+    {
+        /// Replaces 'filename' of the pipeline's reader.  The pipeline must
+        /// have exactly one reader.
+        std::string m_filename;
+        /// Replaces 'bounds' of every reader that has a 'bounds' option.
+        std::string m_bounds;
+        /// Replaces 'polygon' of every reader that has a 'polygon' option.
+        StringList m_polygons;
+        /// Options to set on stages, keyed by stage tag.
+        OptionsMap m_stageOptions;
+    };
+
+    /**
+      Prepare a pipeline that has been built with a pipeline manager.
+
+      \param mgr  Pipeline manager holding the pipeline's stages.
+    */
+    PreparedPipeline(PipelineManagerPtr mgr);
+
+    /**
+      Prepare a pipeline from its JSON description.
+
+      \param input  Stream containing the JSON pipeline.
+    */
+    PreparedPipeline(std::istream& input);
+
+    /**
+      Prepare a pipeline from a JSON pipeline file.
+
+      \param filename  Name of the pipeline file.
+    */
+    PreparedPipeline(const std::string& filename);
+
+    ~PreparedPipeline();
+
+    /**
+      Execute the pipeline in standard mode.
+
+      \param table  Point table to hold the points.  Use a new table for
+        each execution.
+      \param overrides  Options for this execution.
+      \return  The point views produced by the pipeline.
+    */
+    PointViewSet execute(PointTableRef table,
+        const Overrides& overrides = Overrides());
+
+    /**
+      Execute the pipeline in stream mode.  Throws pdal_error if the pipeline
+      isn't streamable.
+
+      \param table  Point table used to stream the points.
+      \param overrides  Options for this execution.
+    */
+    void executeStream(StreamPointTable& table,
+        const Overrides& overrides = Overrides());
+
+    /// Return whether the pipeline can be run in stream mode.
+    bool streamable() const
+        { return m_streamable; }
+    /// Return the number of times the pipeline has been executed.
+    size_t executionCount() const
+        { return m_executionCount; }
+    /// Return the pipeline manager holding the stages.
+    const PipelineManager& manager() const
+        { return *m_manager; }
+
+private:
+    void init();
+    void applyOverrides(const Overrides& overrides);
+    void restoreOptions();
+
+    PipelineManagerPtr m_manager;
+    Stage *m_leaf;
+    std::vector<Stage *> m_readers;
+    std::vector<Stage *> m_boundsReaders;
+    std::vector<Stage *> m_polygonReaders;
+    std::map<Stage *, Options> m_options;
+    bool m_streamable;
+    size_t m_executionCount;
+
+    PreparedPipeline(const PreparedPipeline&) = delete;
+    PreparedPipeline& operator=(const PreparedPipeline&) = delete;
+};
+
+} // namespace pdal
@@ -0,0 +1,257 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+#include <pdal/Profiler.hpp>
+#include <pdal/Stage.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+const char *phaseName(Profiler::PhaseId phase)
+{
+    switch (phase)
+    {
+    case Profiler::Ready:
+        return "ready";
+    case Profiler::Run:
+        return "run";
+    case Profiler::Done:
+        return "done";
+    default:
+        return "";
+    }
+}
+
+} // unnamed namespace
+
+const std::size_t Profiler::MaxEvents;
+
+
+Profiler::Record::Record(const Stage& stage, int instance) :
+    m_stage(&stage), m_name(stage.getName()), m_tag(stage.tag()),
+    m_instance(instance), m_pointsIn(0), m_pointsOut(0), m_peakMemory(0)
+{}
+
+
+Profiler::Timer::Timer(Profiler *profiler, Record *record, PhaseId phase) :
+    m_profiler(profiler), m_record(record), m_phase(phase)
+{
+    if (m_record)
+    {
+        m_start = Clock::now();
+        m_cpuStart = std::clock();
+    }
+}
+
+
+void Profiler::Timer::stop()
+{
+    if (!m_record)
+        return;
+
+    Clock::time_point end = Clock::now();
+    std::clock_t cpuEnd = std::clock();
+
+    double wall = std::chrono::duration<double>(end - m_start).count();
+    Phase& p = m_record->m_phases[m_phase];
+    p.m_wall += wall;
+    p.m_cpu += double(cpuEnd - m_cpuStart) / CLOCKS_PER_SEC;
+    if (m_profiler->m_trace)
+        m_profiler->addEvent(*m_record, m_phase, m_start, wall);
+    m_record = nullptr;
+}
+
+
+Profiler::Profiler(bool trace) : m_trace(trace), m_start(Clock::now())
+{}
+
+
+Profiler::Record& Profiler::begin(const Stage& stage)
+{
+    int instance = 1;
+    for (const Record& r : m_records)
+        if (r.m_stage == &stage)
+            instance++;
+    m_records.emplace_back(stage, instance);
+    return m_records.back();
+}
+
+
+Profiler::Record& Profiler::record(const Stage& stage)
+{
+    for (auto it = m_records.rbegin(); it != m_records.rend(); ++it)
+        if (it->m_stage == &stage)
+            return *it;
+    return begin(stage);
+}
+
+
+void Profiler::sampleMemory(Record& record, std::size_t bytes)
+{
+    record.m_peakMemory = (std::max)(record.m_peakMemory, bytes);
+}
+
+
+void Profiler::clear()
+{
+    m_tracks.clear();
+    m_records.clear();
+    m_start = Clock::now();
+}
+
+
+void Profiler::addEvent(const Record& record, PhaseId phase,
+    Clock::time_point start, double wall)
+{
+    double offset = std::chrono::duration<double>(start - m_start).count();
+    Track& t = m_tracks[{ &record, phase }];
+
+    if (t.m_events.size() && t.m_events.back().m_count < t.m_perEvent)
+    {
+        Event& e = t.m_events.back();
+        e.m_wall += wall;
+        e.m_count++;
+        return;
+    }
+    t.m_events.push_back({ offset, wall, 1 });
+
+    // Merge pairs of events so that memory doesn't grow with the number
+    // of batches streamed.
+    if (t.m_events.size() > MaxEvents)
+    {
+        std::vector<Event>& events = t.m_events;
+        size_t out = 0;
+        for (size_t i = 0; i < events.size(); i += 2, ++out)
+        {
+            events[out] = events[i];
+            if (i + 1 < events.size())
+            {
+                events[out].m_wall += events[i + 1].m_wall;
+                events[out].m_count += events[i + 1].m_count;
+            }
+        }
+        events.resize(out);
+        t.m_perEvent *= 2;
+    }
+}
+
+
+std::size_t Profiler::eventCount() const
+{
+    std::size_t count = 0;
+    for (auto& t : m_tracks)
+        count += t.second.m_events.size();
+    return count;
+}
+
+
+MetadataNode Profiler::toMetadata() const
+{
+    MetadataNode root("profile");
+
+    for (const Record& r : m_records)
+    {
+        MetadataNode n = root.addList("stages");
+
+        double wall = 0;
+        double cpu = 0;
+        for (const Phase& p : r.m_phases)
+        {
+            wall += p.m_wall;
+            cpu += p.m_cpu;
+        }
+        // Readers have no input, so throughput is based on the larger of
+        // the input and output counts.
+        double run = r.m_phases[Run].m_wall;
+        point_count_t points = (std::max)(r.m_pointsIn, r.m_pointsOut);
+
+        n.add("name", r.m_name);
+        n.add("tag", r.m_tag);
+        n.add("instance", r.m_instance);
+        n.add("ready_seconds", r.m_phases[Ready].m_wall);
+        n.add("run_seconds", run);
+        n.add("done_seconds", r.m_phases[Done].m_wall);
+        n.add("wall_seconds", wall);
+        n.add("cpu_seconds", cpu);
+        n.add("points_in", r.m_pointsIn);
+        n.add("points_out", r.m_pointsOut);
+        n.add("points_per_second", run > 0 ? points / run : 0.0);
+        n.add("peak_table_memory", r.m_peakMemory);
+    }
+    return root;
+}
+
+
+void Profiler::writeTrace(std::ostream& out) const
+{
+    NL::json events = NL::json::array();
+
+    // A merged event starts with its first timing and lasts for the total
+    // time of its timings.
+    for (auto& t : m_tracks)
+    {
+        const Record& r = *t.first.first;
+        PhaseId phase = t.first.second;
+
+        for (const Event& e : t.second.m_events)
+        {
+            NL::json event;
+            event["name"] = (r.m_tag.empty() ? r.m_name : r.m_tag) + " " +
+                phaseName(phase);
+            event["cat"] = phaseName(phase);
+            event["ph"] = "X";
+            event["ts"] = e.m_start * 1e6;
+            event["dur"] = e.m_wall * 1e6;
+            event["pid"] = 1;
+            event["tid"] = 1;
+            event["args"] = { { "stage", r.m_name },
+                { "instance", r.m_instance }, { "count", e.m_count } };
+            events.push_back(event);
+        }
+    }
+
+    NL::json root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    out << root.dump() << std::endl;
+}
+
+} // namespace pdal
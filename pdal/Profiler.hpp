@@ -0,0 +1,195 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <chrono>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <pdal/Metadata.hpp>
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+
+class Stage;
+
+/**
+  Collects timing, point counts and table memory for each stage instance
+  run in a pipeline.  A profiler is attached to stages with
+  Stage::setProfiler(), usually through PipelineManager::setProfiling().
+
+  In standard mode a record is made each time a stage is executed.  In
+  stream mode one record covers the stage for the whole run.
+*/
+class PDAL_EXPORT Profiler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum PhaseId
+    {
+        Ready,
+        Run,
+        Done,
+        NumPhases
+    };
+
+    struct Phase
+    {
+        Phase() : m_wall(0), m_cpu(0)
+        {}
+
+        double m_wall;  ///< Wall-clock seconds.
+        double m_cpu;   ///< Process CPU seconds, including other threads.
+    };
+
+    struct Record
+    {
+        Record(const Stage& stage, int instance);
+
+        const Stage *m_stage;
+        std::string m_name;
+        std::string m_tag;
+        int m_instance;
+        Phase m_phases[NumPhases];
+        point_count_t m_pointsIn;
+        point_count_t m_pointsOut;
+        std::size_t m_peakMemory;
+    };
+
+    /**
+      Times a phase of a record from construction until stop() is called or
+      the timer is destroyed.  Does nothing if the record is null.
+    */
+    class PDAL_EXPORT Timer
+    {
+    public:
+        Timer(Profiler *profiler, Record *record, PhaseId phase);
+        ~Timer()
+            { stop(); }
+
+        void stop();
+
+    private:
+        Profiler *m_profiler;
+        Record *m_record;
+        PhaseId m_phase;
+        Clock::time_point m_start;
+        std::clock_t m_cpuStart;
+    };
+
+    /**
+      \param trace  Keep a timed event for each phase so that a trace can
+        be written with writeTrace().
+    */
+    Profiler(bool trace = false);
+
+    /**
+      Start a new record for an instance of \p stage.
+    */
+    Record& begin(const Stage& stage);
+
+    /**
+      Return the latest record for \p stage, starting one if none exists.
+    */
+    Record& record(const Stage& stage);
+
+    /**
+      Note that \p record may use \p bytes of table memory.
+    */
+    void sampleMemory(Record& record, std::size_t bytes);
+
+    const std::deque<Record>& records() const
+        { return m_records; }
+    bool tracing() const
+        { return m_trace; }
+    void clear();
+
+    /**
+      Return the records as a metadata node named "profile".
+    */
+    MetadataNode toMetadata() const;
+
+    /**
+      Write the timed events in the Chrome trace-event JSON format, which
+      can be loaded into chrome://tracing or Perfetto.
+    */
+    void writeTrace(std::ostream& out) const;
+
+    /**
+      Return the number of timed events kept for the trace.
+    */
+    std::size_t eventCount() const;
+
+    /// Largest number of events kept for a phase of a record.
+    static const std::size_t MaxEvents = 1024;
+
+private:
+    struct Event
+    {
+        double m_start;  ///< Seconds since the profiler started.
+        double m_wall;   ///< Seconds spent in the phase.
+        std::size_t m_count;  ///< Number of times the phase was timed.
+    };
+
+    // The events of a phase of a record.  In stream mode a phase is timed
+    // once per batch of points, so once a track is full each event covers
+    // twice as many timings as before.
+    struct Track
+    {
+        Track() : m_perEvent(1)
+        {}
+
+        std::vector<Event> m_events;
+        std::size_t m_perEvent;
+    };
+    using TrackKey = std::pair<const Record *, PhaseId>;
+
+    void addEvent(const Record& record, PhaseId phase,
+        Clock::time_point start, double wall);
+
+    bool m_trace;
+    Clock::time_point m_start;
+    std::deque<Record> m_records;
+    std::map<TrackKey, Track> m_tracks;
+};
+
+} // namespace pdal
@@ -33,6 +33,7 @@
 ****************************************************************************/
 
 #include <pdal/PipelineManager.hpp>
+#include <pdal/Profiler.hpp>
 #include <pdal/Stage.hpp>
 #include <pdal/SpatialReference.hpp>
 #include <pdal/PDALUtils.hpp>
@@ -50,7 +51,7 @@ namespace pdal
 {
 
 Stage::Stage() : m_progressFd(-1), m_verbose(0), m_pointCount(0),
-    m_faceCount(0)
+    m_faceCount(0), m_profiler(nullptr)
 {}
 
 
@@ -308,9 +309,20 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
 
     countElements(views);
 
+    Profiler::Record *record = nullptr;
+    if (m_profiler)
+    {
+        record = &m_profiler->begin(*this);
+        record->m_pointsIn = m_pointCount;
+    }
+
     // Do the ready operation and then start running all the views
     // through the stage.
+    Profiler::Timer readyTimer(m_profiler, record, Profiler::Ready);
     ready(table);
+    readyTimer.stop();
+
+    Profiler::Timer runTimer(m_profiler, record, Profiler::Run);
 
     // Create a runner for each view.
     for (PointViewPtr v : views)
@@ -343,8 +355,17 @@ PointViewSet Stage::execute(PointTableRef table, PointViewSet& views)
                 v->setSpatialReference(srs);
         outViews.insert(temp.begin(), temp.end());
     }
+    runTimer.stop();
 
+    Profiler::Timer doneTimer(m_profiler, record, Profiler::Done);
     done(table);
+    doneTimer.stop();
+    if (record)
+    {
+        for (PointViewPtr v : outViews)
+            record->m_pointsOut += v->size();
+        m_profiler->sampleMemory(*record, table.memoryUsage());
+    }
     stopLogging();
     m_pointCount = 0;
     m_faceCount = 0;
@@ -54,6 +54,7 @@ namespace pdal
 {
 
 class ProgramArgs;
+class Profiler;
 class StageRunner;
 class StageWrapper;
 class Streamable;
@@ -81,6 +82,7 @@ class PDAL_EXPORT Stage
     friend class Reader;
     friend class Filter;
     friend class Writer;
+    friend class PreparedPipeline;
 
 public:
     enum class WhereMergeMode
@@ -250,6 +252,15 @@ public:
     virtual LogPtr log() const
         { return m_log; }
 
+    /**
+      Set a profiler to record timing, point counts and table memory when
+      the stage is executed.  The profiler isn't owned by the stage.
+
+      \param profiler  Profiler to use, or nullptr to stop profiling.
+    */
+    void setProfiler(Profiler *profiler)
+        { m_profiler = profiler; }
+
     /**
       Push the stage's leader into the log.
     */
@@ -375,6 +386,7 @@ private:
     std::string m_userDataJSON;
     point_count_t m_pointCount;
     point_count_t m_faceCount;
+    Profiler *m_profiler;
     // This is never used, but we want something to bind to the argument
     // we stick in ProgramArgs so that it shows up in help and an options list.
     std::string m_optionFile;
@@ -36,6 +36,7 @@
 
 #include <pdal/Streamable.hpp>
 #include <pdal/Filter.hpp>
+#include <pdal/Profiler.hpp>
 #include <pdal/Reader.hpp>
 #include "../filters/private/expr/ConditionalExpression.hpp"
 
@@ -96,8 +97,14 @@ void Streamable::execute(StreamPointTable& table)
         {
             for (auto s : *this)
             {
+                Profiler::Record *record = nullptr;
+                if (s->m_profiler)
+                    record = &s->m_profiler->begin(*s);
+
                 s->startLogging();
+                Profiler::Timer timer(s->m_profiler, record, Profiler::Ready);
                 s->ready(table);
+                timer.stop();
                 s->stopLogging();
                 SpatialReference srs = s->getSpatialReference();
                 if (!srs.empty())
@@ -109,9 +116,17 @@ void Streamable::execute(StreamPointTable& table)
         {
             for (auto s : *this)
             {
+                Profiler::Record *record = nullptr;
+                if (s->m_profiler)
+                    record = &s->m_profiler->record(*s);
+
                 s->startLogging();
+                Profiler::Timer timer(s->m_profiler, record, Profiler::Done);
                 s->done(table);
+                timer.stop();
                 s->stopLogging();
+                if (record)
+                    s->m_profiler->sampleMemory(*record, table.memoryUsage());
             }
         }
     };
@@ -221,6 +236,10 @@ void Streamable::execute(StreamPointTable& table,
         PointRef point(table, idx);
         point_count_t pointLimit = (std::min)(count, table.capacity());
 
+        Profiler::Record *readerRecord = nullptr;
+        if (reader->m_profiler)
+            readerRecord = &reader->m_profiler->record(*reader);
+
         reader->startLogging();
         // When we get false back from a reader, we're done, so set
         // the point limit to the number of points processed in this loop
@@ -228,6 +247,8 @@ void Streamable::execute(StreamPointTable& table,
         if (!pointLimit)
             finished = true;
 
+        Profiler::Timer readTimer(reader->m_profiler, readerRecord,
+            Profiler::Run);
         for (PointId idx = 0; idx < pointLimit; idx++)
         {
             point.setPointId(idx);
@@ -235,7 +256,10 @@ void Streamable::execute(StreamPointTable& table,
             if (finished)
                 pointLimit = idx;
         }
+        readTimer.stop();
         count -= pointLimit;
+        if (readerRecord)
+            readerRecord->m_pointsOut += pointLimit;
 
         reader->stopLogging();
         srs = reader->getSpatialReference();
@@ -254,18 +278,39 @@ void Streamable::execute(StreamPointTable& table,
                 s->spatialReferenceChanged(srs);
                 srsMap[s] = srs;
             }
+            Profiler::Record *record = nullptr;
+            if (s->m_profiler)
+                record = &s->m_profiler->record(*s);
+
             s->startLogging();
 
+            // Points that don't pass the where expression pass through
+            // the stage untouched.
+            point_count_t in = 0;
+            point_count_t out = 0;
+            Profiler::Timer timer(s->m_profiler, record, Profiler::Run);
             const expr::ConditionalExpression* where = s->whereExpr();
             for (PointId idx = 0; idx < pointLimit; idx++)
             {
                 point.setPointId(idx);
                 if (table.skip(idx))
                     continue;
+                in++;
                 if (where && !where->eval(point))
+                {
+                    out++;
                     continue;
+                }
                 if (!s->processOne(point))
                     table.setSkip(idx);
+                else
+                    out++;
+            }
+            timer.stop();
+            if (record)
+            {
+                record->m_pointsIn += in;
+                record->m_pointsOut += out;
             }
             const SpatialReference& tempSrs = s->getSpatialReference();
             if (!tempSrs.empty())
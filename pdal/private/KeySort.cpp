@@ -0,0 +1,168 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#include "KeySort.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <pdal/util/ThreadPool.hpp>
+
+namespace pdal
+{
+namespace keysort
+{
+
+namespace
+{
+
+// Don't bother splitting work into pieces smaller than this.
+const std::size_t MinChunkSize = 65536;
+
+// Below this size a comparison sort is faster than a radix sort.
+const std::size_t MinRadixSize = 1024;
+
+const int KeyBytes = sizeof(uint64_t);
+
+using Histogram = std::array<std::size_t, 256>;
+
+inline uint8_t digit(const KeyId& k, int byte)
+{
+    return (uint8_t)(k.key >> (byte * 8));
+}
+
+} // unnamed namespace
+
+// Least-significant-digit radix sort, one byte per pass.  Each thread
+// handles a contiguous chunk of the list.  Threads count the digits in their
+// chunks, the counts are combined to give each thread its output offsets,
+// and each thread scatters its chunk.  Giving lower chunks lower offsets
+// keeps the sort stable.  Passes where every key has the same digit are
+// skipped, which is common for the high bytes of curve keys.
+void sort(KeyIdList& keys, std::size_t threads)
+{
+    const std::size_t count = keys.size();
+    if (count < MinRadixSize)
+    {
+        std::stable_sort(keys.begin(), keys.end(),
+            [](const KeyId& k1, const KeyId& k2){ return k1.key < k2.key; });
+        return;
+    }
+
+    const std::size_t chunks = (std::max)((std::size_t)1,
+        (std::min)(threads, count / MinChunkSize));
+
+    // Chunk boundaries. Chunk i is [bounds[i], bounds[i + 1]).
+    std::vector<std::size_t> bounds;
+    for (std::size_t i = 0; i < chunks; ++i)
+        bounds.push_back(i * count / chunks);
+    bounds.push_back(count);
+
+    ThreadPool pool(chunks);
+
+    // Count every digit up front to find the passes that can be skipped.
+    std::vector<std::array<Histogram, KeyBytes>> counts(chunks);
+    for (std::size_t c = 0; c < chunks; ++c)
+        pool.add([&keys, &bounds, &counts, c]()
+        {
+            std::array<Histogram, KeyBytes>& h = counts[c];
+            for (Histogram& hb : h)
+                hb.fill(0);
+            for (std::size_t i = bounds[c]; i < bounds[c + 1]; ++i)
+                for (int byte = 0; byte < KeyBytes; ++byte)
+                    h[byte][digit(keys[i], byte)]++;
+        });
+    pool.await();
+
+    KeyIdList temp(count);
+    KeyIdList *src = &keys;
+    KeyIdList *dst = &temp;
+    std::vector<Histogram> offsets(chunks);
+    bool moved = false;
+    for (int byte = 0; byte < KeyBytes; ++byte)
+    {
+        bool skip = false;
+        for (int d = 0; d < 256 && !skip; ++d)
+        {
+            std::size_t total = 0;
+            for (std::size_t c = 0; c < chunks; ++c)
+                total += counts[c][byte][d];
+            skip = (total == count);
+        }
+        if (skip)
+            continue;
+
+        // Once points have moved, the chunk counts are stale.
+        if (moved)
+        {
+            for (std::size_t c = 0; c < chunks; ++c)
+                pool.add([src, &bounds, &counts, c, byte]()
+                {
+                    Histogram& h = counts[c][byte];
+                    h.fill(0);
+                    for (std::size_t i = bounds[c]; i < bounds[c + 1]; ++i)
+                        h[digit((*src)[i], byte)]++;
+                });
+            pool.await();
+        }
+
+        std::size_t offset = 0;
+        for (int d = 0; d < 256; ++d)
+            for (std::size_t c = 0; c < chunks; ++c)
+            {
+                offsets[c][d] = offset;
+                offset += counts[c][byte][d];
+            }
+
+        for (std::size_t c = 0; c < chunks; ++c)
+            pool.add([src, dst, &bounds, &offsets, c, byte]()
+            {
+                Histogram& off = offsets[c];
+                for (std::size_t i = bounds[c]; i < bounds[c + 1]; ++i)
+                {
+                    const KeyId& k = (*src)[i];
+                    (*dst)[off[digit(k, byte)]++] = k;
+                }
+            });
+        pool.await();
+        std::swap(src, dst);
+        moved = true;
+    }
+
+    if (src != &keys)
+        keys.swap(temp);
+}
+
+} // namespace keysort
+} // namespace pdal
@@ -0,0 +1,82 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+
+// A sort key and the ID of the point it was computed from.
+struct KeyId
+{
+    uint64_t key;
+    PointId id;
+};
+using KeyIdList = std::vector<KeyId>;
+
+namespace keysort
+{
+
+/**
+  Map a double to an unsigned integer such that integer ordering matches
+  the ordering of the original values.
+
+  \param d  Value to map.
+  \return  Key that sorts like \a d.
+*/
+inline uint64_t orderedKey(double d)
+{
+    uint64_t u;
+    std::memcpy(&u, &d, sizeof(u));
+    const uint64_t signBit = 0x8000000000000000ULL;
+    return (u & signBit) ? ~u : (u | signBit);
+}
+
+/**
+  Sort a list of keys with a parallel radix sort.  The sort is stable:
+  equal keys keep their relative order.
+
+  \param keys  Keys to sort.
+  \param threads  Maximum number of threads to use.
+*/
+PDAL_EXPORT void sort(KeyIdList& keys, std::size_t threads);
+
+} // namespace keysort
+} // namespace pdal
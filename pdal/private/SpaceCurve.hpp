@@ -0,0 +1,225 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc.
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. or Flaxen Geo Consulting nor the
+*       names of its contributors may be used to endorse or promote
+*       products derived from this software without specific prior
+*       written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+namespace curve
+{
+
+enum class Type
+{
+    Morton,
+    Hilbert
+};
+
+// Spread the low 32 bits of a value so that each is followed by a zero bit.
+inline uint64_t spread2(uint64_t v)
+{
+    v &= 0xFFFFFFFF;
+    v = (v | (v << 16)) & 0x0000FFFF0000FFFFULL;
+    v = (v | (v << 8)) & 0x00FF00FF00FF00FFULL;
+    v = (v | (v << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+// Spread the low 21 bits of a value so that each is followed by two zero bits.
+inline uint64_t spread3(uint64_t v)
+{
+    v &= 0x1FFFFF;
+    v = (v | (v << 32)) & 0x001F00000000FFFFULL;
+    v = (v | (v << 16)) & 0x001F0000FF0000FFULL;
+    v = (v | (v << 8)) & 0x100F00F00F00F00FULL;
+    v = (v | (v << 4)) & 0x10C30C30C30C30C3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+// Morton (Z-order) index of a cell in a 2^32 x 2^32 grid.  X is the more
+// significant axis, which matches the order of the original comparison-based
+// sort in filters.mortonorder.
+inline uint64_t morton2d(uint32_t x, uint32_t y)
+{
+    return spread2(y) | (spread2(x) << 1);
+}
+
+// Hilbert index of a cell in a 2^32 x 2^32 grid.
+inline uint64_t hilbert2d(uint32_t x, uint32_t y)
+{
+    uint64_t d = 0;
+    for (uint32_t s = 1u << 31; s; s >>= 1)
+    {
+        const uint32_t rx = (x & s) ? 1 : 0;
+        const uint32_t ry = (y & s) ? 1 : 0;
+        d += (uint64_t)s * s * ((3 * rx) ^ ry);
+
+        // Rotate the quadrant so the curve is continuous.
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = ~x;
+                y = ~y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return d;
+}
+
+// Morton (Z-order) index of a cell in a 2^21 x 2^21 x 2^21 grid.  As in 2D,
+// X is the most significant axis.
+inline uint64_t morton3d(uint32_t x, uint32_t y, uint32_t z)
+{
+    return spread3(z) | (spread3(y) << 1) | (spread3(x) << 2);
+}
+
+// Hilbert index of a cell in a 2^21 x 2^21 x 2^21 grid.  This is Skilling's
+// transpose algorithm ("Programming the Hilbert curve", AIP Conf. Proc. 707,
+// 2004) followed by interleaving the transposed bits.
+inline uint64_t hilbert3d(uint32_t x, uint32_t y, uint32_t z)
+{
+    uint32_t v[3] = { z, y, x };
+    const uint32_t m = 1u << 20;
+
+    for (uint32_t q = m; q > 1; q >>= 1)
+    {
+        const uint32_t p = q - 1;
+        for (int i = 0; i < 3; ++i)
+        {
+            if (v[i] & q)
+                v[0] ^= p;
+            else
+            {
+                const uint32_t t = (v[0] ^ v[i]) & p;
+                v[0] ^= t;
+                v[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode.
+    v[1] ^= v[0];
+    v[2] ^= v[1];
+    uint32_t t = 0;
+    for (uint32_t q = m; q > 1; q >>= 1)
+        if (v[2] & q)
+            t ^= q - 1;
+    for (uint32_t& c : v)
+        c ^= t;
+
+    return (spread3(v[0]) << 2) | (spread3(v[1]) << 1) | spread3(v[2]);
+}
+
+/**
+  Compute space-filling curve keys for positions inside a bounding box.
+  In 2D, positions are scaled to a 2^32 x 2^32 grid that covers the box.
+  In 3D, the grid is 2^21 cells on a side. Positions outside the box are
+  clamped to its edge.
+*/
+class Encoder
+{
+public:
+    Encoder(Type type, const BOX2D& bounds) : m_type(type), m_3d(false),
+        m_maxCell(0xFFFFFFFF),
+        m_minx(bounds.minx), m_miny(bounds.miny), m_minz(0),
+        m_xscale(scale(bounds.minx, bounds.maxx)),
+        m_yscale(scale(bounds.miny, bounds.maxy)), m_zscale(0)
+    {}
+
+    Encoder(Type type, const BOX3D& bounds) : m_type(type), m_3d(true),
+        m_maxCell(0x1FFFFF),
+        m_minx(bounds.minx), m_miny(bounds.miny), m_minz(bounds.minz),
+        m_xscale(scale(bounds.minx, bounds.maxx)),
+        m_yscale(scale(bounds.miny, bounds.maxy)),
+        m_zscale(scale(bounds.minz, bounds.maxz))
+    {}
+
+    bool is3d() const
+        { return m_3d; }
+
+    uint64_t key(double x, double y) const
+    {
+        const uint32_t xpos = cell(x, m_minx, m_xscale);
+        const uint32_t ypos = cell(y, m_miny, m_yscale);
+        return m_type == Type::Hilbert ?
+            hilbert2d(xpos, ypos) : morton2d(xpos, ypos);
+    }
+
+    uint64_t key(double x, double y, double z) const
+    {
+        const uint32_t xpos = cell(x, m_minx, m_xscale);
+        const uint32_t ypos = cell(y, m_miny, m_yscale);
+        const uint32_t zpos = cell(z, m_minz, m_zscale);
+        return m_type == Type::Hilbert ?
+            hilbert3d(xpos, ypos, zpos) : morton3d(xpos, ypos, zpos);
+    }
+
+private:
+    double scale(double min, double max) const
+    {
+        return max > min ? (double)m_maxCell / (max - min) : 0.0;
+    }
+
+    uint32_t cell(double v, double min, double scale) const
+    {
+        const double d = (v - min) * scale;
+        if (!(d > 0))
+            return 0;
+        if (d >= (double)m_maxCell)
+            return m_maxCell;
+        return static_cast<uint32_t>(d);
+    }
+
+    Type m_type;
+    bool m_3d;
+    uint32_t m_maxCell;
+    double m_minx;
+    double m_miny;
+    double m_minz;
+    double m_xscale;
+    double m_yscale;
+    double m_zscale;
+};
+
+} // namespace curve
+} // namespace pdal
@@ -568,6 +568,8 @@ MapContext mapFile(const std::string& filename, bool readOnly, uintmax_t pos, ui
     {
         ctx.m_addr = nullptr;
         ctx.m_error = "Couldn't map file";
+        ::close(ctx.m_fd);
+        ctx.m_fd = -1;
     }
 #else
     ctx.m_handle = CreateFileMapping((HANDLE)_get_osfhandle(ctx.m_fd),
@@ -1090,6 +1090,14 @@ public:
         return false;
     }
 
+    /**
+      Return whether an argument with the given longname has been added.
+    */
+    bool has(const std::string& name) const
+    {
+        return findLongArg(name) != nullptr;
+    }
+
     /**
       Add a list-based (vector) argument.
 
@@ -36,7 +36,9 @@
 #include "ArrowReader.hpp"
 #include "ArrowCommon.hpp"
 
+#include <array>
 #include <memory>
+#include <numeric>
 
 #include <pdal/Geometry.hpp>
 #include <pdal/PDALUtils.hpp>
@@ -49,6 +51,8 @@
 #include <arrow/record_batch.h>
 #include <arrow/io/api.h>
 #include <arrow/ipc/api.h>
+#include <parquet/metadata.h>
+#include <parquet/statistics.h>
 
 namespace pdal
 {
@@ -66,6 +70,100 @@ CREATE_SHARED_STAGE(ArrowReader, s_info)
 
 std::string ArrowReader::getName() const { return s_info.name; }
 
+namespace
+{
+
+// Copy the values of 'rows' of a numeric column to consecutive points
+// of the view, starting at 'start'.
+template<typename ArrayType>
+void copyColumn(PointView& view, PointId start, Dimension::Id id,
+    const arrow::Array& array, const std::vector<int64_t>& rows)
+{
+    const auto *values = static_cast<const ArrayType&>(array).raw_values();
+    for (int64_t row : rows)
+        view.setField(id, start++, values[row]);
+}
+
+
+double numericValue(const arrow::Array& array, int64_t row)
+{
+    switch (array.type_id())
+    {
+        case arrow::Type::DOUBLE:
+            return static_cast<const arrow::DoubleArray&>(array).Value(row);
+        case arrow::Type::FLOAT:
+            return static_cast<const arrow::FloatArray&>(array).Value(row);
+        case arrow::Type::INT8:
+            return static_cast<const arrow::Int8Array&>(array).Value(row);
+        case arrow::Type::UINT8:
+            return static_cast<const arrow::UInt8Array&>(array).Value(row);
+        case arrow::Type::INT16:
+            return static_cast<const arrow::Int16Array&>(array).Value(row);
+        case arrow::Type::UINT16:
+            return static_cast<const arrow::UInt16Array&>(array).Value(row);
+        case arrow::Type::INT32:
+            return static_cast<const arrow::Int32Array&>(array).Value(row);
+        case arrow::Type::UINT32:
+            return static_cast<const arrow::UInt32Array&>(array).Value(row);
+        case arrow::Type::INT64:
+            return (double)static_cast<const arrow::Int64Array&>(array).Value(row);
+        case arrow::Type::UINT64:
+            return (double)static_cast<const arrow::UInt64Array&>(array).Value(row);
+        default:
+            return 0;
+    }
+}
+
+
+// Get the offset of the coordinates of a GeoArrow point in the list's values.
+int64_t listOffset(const arrow::Array& array, int64_t row)
+{
+    if (array.type_id() == arrow::Type::FIXED_SIZE_LIST)
+        return static_cast<const arrow::FixedSizeListArray&>(array).
+            value_offset(row);
+    return static_cast<const arrow::ListArray&>(array).value_offset(row);
+}
+
+
+const arrow::DoubleArray& listValues(const arrow::Array& array)
+{
+    std::shared_ptr<arrow::Array> values =
+        (array.type_id() == arrow::Type::FIXED_SIZE_LIST) ?
+            static_cast<const arrow::FixedSizeListArray&>(array).values() :
+            static_cast<const arrow::ListArray&>(array).values();
+    assert(values->type_id() == arrow::Type::DOUBLE);
+    return static_cast<const arrow::DoubleArray&>(*values);
+}
+
+
+// Get the min/max statistics of a floating-point column chunk, if present.
+bool columnRange(const parquet::ColumnChunkMetaData& chunk, double& min,
+    double& max)
+{
+    if (!chunk.is_stats_set())
+        return false;
+    std::shared_ptr<parquet::Statistics> stats = chunk.statistics();
+    if (!stats || !stats->HasMinMax())
+        return false;
+    if (stats->physical_type() == parquet::Type::DOUBLE)
+    {
+        auto s = std::static_pointer_cast<parquet::DoubleStatistics>(stats);
+        min = s->min();
+        max = s->max();
+        return true;
+    }
+    if (stats->physical_type() == parquet::Type::FLOAT)
+    {
+        auto s = std::static_pointer_cast<parquet::FloatStatistics>(stats);
+        min = s->min();
+        max = s->max();
+        return true;
+    }
+    return false;
+}
+
+} // unnamed namespace
+
 
 ArrowReader::ArrowReader()
     : pdal::Reader()
@@ -90,6 +188,7 @@ void ArrowReader::addArgs(ProgramArgs& args)
     args.add("geoarrow_dimension_name", "Name of the packed XYZ struct dimension for "
         "GeoArrow (Feather) input.", m_geoArrowDimName, "xyz");
     args.add("format", "", m_formatTypeString, "");
+    args.add("bounds", "Only read points within these bounds", m_bounds);
 }
 
 
@@ -237,14 +336,29 @@ void ArrowReader::initialize()
 
     }
 
-    auto result = arrow::io::ReadableFile::Open(m_filename);
-    if (result.ok())
-        m_file = result.ValueOrDie();
+    arrow::Status openStatus;
+    if (m_formatType == arrowsupport::Feather)
+    {
+        // Map IPC files so that record batches reference the file's pages
+        // rather than copies of them.
+        auto result = arrow::io::MemoryMappedFile::Open(m_filename,
+            arrow::io::FileMode::READ);
+        openStatus = result.status();
+        if (result.ok())
+            m_file = result.ValueOrDie();
+    }
     else
+    {
+        auto result = arrow::io::ReadableFile::Open(m_filename);
+        openStatus = result.status();
+        if (result.ok())
+            m_file = result.ValueOrDie();
+    }
+    if (!openStatus.ok())
     {
         std::stringstream msg;
         msg << "Unable to open '" << m_filename << "' for to read data with message '"
-            << result.status().ToString() <<"'";
+            << openStatus.ToString() <<"'";
         throwError(msg.str());
     }
 
@@ -255,12 +369,13 @@ void ArrowReader::initialize()
         {
             std::stringstream msg;
             msg << "Unable to create RecordBatchFileReader for file  '" << m_filename << "' with message '"
-                << result.status().ToString() <<"'";
+                << status.status().ToString() <<"'";
             throwError(msg.str());
         }
 
         m_ipcReader = status.ValueOrDie();
         m_batchCount = m_ipcReader->num_record_batches();
+        m_schema = m_ipcReader->schema();
 
         const auto fields = m_ipcReader->schema()->fields();
 
@@ -283,21 +398,9 @@ void ArrowReader::initialize()
 
         // add 1 to count
         m_count++;
-
-        m_currentBatchIndex = 0;
-
-        // Read our first batch
-        readNextBatchHeaders();
-
     }
     if (m_formatType == arrowsupport::Parquet)
     {
-        auto arrow_reader_props = parquet::ArrowReaderProperties();
-        arrow_reader_props.set_batch_size(128 * 1024);  // default 64 * 1024
-        parquet::arrow::FileReaderBuilder reader_builder;
-        reader_builder.memory_pool(m_pool);
-        reader_builder.properties(arrow_reader_props);
-
         auto reader_result = parquet::arrow::OpenFile(m_file, m_pool);
         if (!reader_result.ok())
         {
@@ -307,57 +410,33 @@ void ArrowReader::initialize()
             throwError(msg.str());
         }
         m_arrow_reader = std::move(reader_result).ValueOrDie();
+        // Decode the columns of each row group in parallel.
+        m_arrow_reader->set_use_threads(true);
+        m_arrow_reader->set_batch_size(128 * 1024);  // default 64 * 1024
 
         const auto metadata = m_arrow_reader->parquet_reader()->metadata();
         loadParquetGeoMetadata(metadata->key_value_metadata());
 
-        // Get the indexes of all row groups
-        std::vector<int> rowGroupIds(m_arrow_reader->num_row_groups());
-        std::iota(rowGroupIds.begin(), rowGroupIds.end(), 0);
-
-        auto batchOpenResult = m_arrow_reader->GetRecordBatchReader();
-        if (!batchOpenResult.ok())
+        auto schemaStatus = m_arrow_reader->GetSchema(&m_schema);
+        if (!schemaStatus.ok())
         {
             std::stringstream msg;
-            msg << "Unable to create parquet RecordBatchFileReader for file '" << m_filename << "' with message '"
-                << result.status().ToString() <<"'";
+            msg << "Unable to read schema of file '" << m_filename << "' with message '"
+                << schemaStatus.ToString() <<"'";
             throwError(msg.str());
         }
-        m_parquetReader = std::move(batchOpenResult).ValueOrDie();
-
-        for (arrow::Result<std::shared_ptr<arrow::RecordBatch>> maybe_batch : *m_parquetReader) {
-
-            m_batchCount++;
-        }
-        auto closeStatus = m_parquetReader->Close();
+    }
 
-        batchOpenResult = m_arrow_reader->GetRecordBatchReader();
-        if (!batchOpenResult.ok())
-        {
-            std::stringstream msg;
-            msg << "Unable to create parquet RecordBatchFileReader for file '" << m_filename << "' with message '"
-                << result.status().ToString() <<"'";
-            throwError(msg.str());
-        }
-        m_parquetReader = std::move(batchOpenResult).ValueOrDie();
+    if (!m_schema)
+        throwError("Unable to read schema of file '" + m_filename + "'.");
 
-        auto batchIterator = m_parquetReader->begin();
-        auto result = *batchIterator;
-        if (!result.ok())
-        {
-            std::stringstream msg;
-            msg << "Unable to read first batch for file '" << m_filename << "' with message '"
-                << result.status().ToString() <<"'";
-            throwError(msg.str());
-        }
-        m_currentBatch = result.ValueOrDie();
-        if (!m_currentBatch)
-        {
-            std::stringstream msg;
-            msg << "Batch was null for file '" << m_filename << "' with message '"
-                << result.status().ToString() <<"'";
-            throwError(msg.str());
-        }
+    if (m_bounds.is3d())
+        m_box = m_bounds.to3d();
+    else if (m_bounds.valid())
+    {
+        m_box = BOX3D(m_bounds.to2d());
+        m_box.minz = (std::numeric_limits<double>::lowest)();
+        m_box.maxz = (std::numeric_limits<double>::max)();
     }
 }
 
@@ -365,14 +444,12 @@ void ArrowReader::initialize()
 void ArrowReader::addDimensions(PointLayoutPtr layout)
 {
     using namespace Dimension;
-    Dimension::IdList ids;
 
-    // We take the schema of the first batch. If the rest of the
-    // batches don't match the schema, we're f'd
+    // We take the schema of the file. If the batches don't match the
+    // schema, we're f'd
 
-    std::shared_ptr<arrow::Schema> schema = m_currentBatch->schema();
-    int fieldPosition(0);
-    for(auto& f: schema->fields())
+    m_fieldIds.clear();
+    for(auto& f: m_schema->fields())
     {
         std::string name = f->name();
         auto& dt = f->type();
@@ -395,22 +472,138 @@ void ArrowReader::addDimensions(PointLayoutPtr layout)
         if (pt != pdal::Dimension::Type::None)
         {
             pdal::Dimension::Id id = layout->registerOrAssignDim(name, pt);
-            m_arrayIds.insert({fieldPosition, id});
+            m_fieldIds.insert({name, id});
+        }
+    }
+}
+
+
+// Skip row groups whose X/Y/Z column statistics show no overlap with the
+// bounds.
+std::vector<int> ArrowReader::selectRowGroups() const
+{
+    const auto metadata = m_arrow_reader->parquet_reader()->metadata();
+    const parquet::SchemaDescriptor *schema = metadata->schema();
+
+    // Leaf column index of the X, Y and Z columns.
+    std::array<int, 3> columns { -1, -1, -1 };
+    for (auto& f : m_fieldIds)
+    {
+        int dim = (f.second == Dimension::Id::X) ? 0 :
+            (f.second == Dimension::Id::Y) ? 1 :
+            (f.second == Dimension::Id::Z) ? 2 : -1;
+        if (dim >= 0)
+            columns[dim] = schema->ColumnIndex(f.first);
+    }
+
+    const std::array<double, 3> boxMin { m_box.minx, m_box.miny, m_box.minz };
+    const std::array<double, 3> boxMax { m_box.maxx, m_box.maxy, m_box.maxz };
+
+    std::vector<int> rowGroups;
+    for (int rg = 0; rg < metadata->num_row_groups(); ++rg)
+    {
+        std::unique_ptr<parquet::RowGroupMetaData> rgMeta =
+            metadata->RowGroup(rg);
+        bool overlaps = true;
+        for (int dim = 0; dim < 3 && overlaps; ++dim)
+        {
+            if (columns[dim] < 0)
+                continue;
+            double min, max;
+            if (columnRange(*rgMeta->ColumnChunk(columns[dim]), min, max))
+                overlaps = (min <= boxMax[dim] && max >= boxMin[dim]);
+        }
+        if (overlaps)
+            rowGroups.push_back(rg);
+    }
+    log()->get(LogLevel::Debug) << "Reading " << rowGroups.size() <<
+        " of " << metadata->num_row_groups() << " row groups." << std::endl;
+    return rowGroups;
+}
+
+
+// Read only the columns that we can turn into dimensions.
+std::vector<int> ArrowReader::selectColumns() const
+{
+    const auto metadata = m_arrow_reader->parquet_reader()->metadata();
+    const parquet::SchemaDescriptor *schema = metadata->schema();
+
+    std::vector<int> columns;
+    for (int i = 0; i < schema->num_columns(); ++i)
+    {
+        const std::string field = schema->Column(i)->path()->ToDotVector()[0];
+        if (m_fieldIds.count(field))
+        {
+            columns.push_back(i);
+            continue;
+        }
+        std::shared_ptr<arrow::Field> f = m_schema->GetFieldByName(field);
+        if (!f)
+            continue;
+        arrow::Type::type t = f->type()->id();
+        if (t == arrow::Type::BINARY || t == arrow::Type::FIXED_SIZE_LIST ||
+                t == arrow::Type::LIST)
+            columns.push_back(i);
+    }
+    return columns;
+}
+
+
+void ArrowReader::ready(PointTableRef table)
+{
+    if (m_formatType == arrowsupport::Parquet)
+    {
+        std::vector<int> rowGroups;
+        if (m_bounds.valid())
+            rowGroups = selectRowGroups();
+        else
+        {
+            rowGroups.resize(m_arrow_reader->num_row_groups());
+            std::iota(rowGroups.begin(), rowGroups.end(), 0);
         }
-        fieldPosition++;
+
+        auto batchOpenResult =
+            m_arrow_reader->GetRecordBatchReader(rowGroups, selectColumns());
+        if (!batchOpenResult.ok())
+        {
+            std::stringstream msg;
+            msg << "Unable to create parquet RecordBatchFileReader for file '" << m_filename << "' with message '"
+                << batchOpenResult.status().ToString() <<"'";
+            throwError(msg.str());
+        }
+        m_parquetReader = std::move(batchOpenResult).ValueOrDie();
     }
+
+    // The first call to nextBatch() reads batch 0.
+    m_currentBatch.reset();
+    m_currentBatchIndex = -1;
+    m_currentBatchPointIndex = 0;
 }
 
 
 point_count_t ArrowReader::read(PointViewPtr view, point_count_t num)
 {
     point_count_t numRead = 0;
-    PointRef point(view->point(0));
-    bool didRead(true);
-    while (numRead < num && didRead ) {
-        point.setPointId(numRead);
-        didRead = processOne(point);
-        ++numRead;
+    while (numRead < num)
+    {
+        if ((!m_currentBatch ||
+                m_currentBatchPointIndex == m_currentBatch->num_rows()) &&
+                !nextBatch())
+            break;
+
+        point_count_t remaining =
+            m_currentBatch->num_rows() - m_currentBatchPointIndex;
+        int64_t end = m_currentBatchPointIndex +
+            (int64_t)(std::min)(remaining, num - numRead);
+
+        m_rows.clear();
+        for (int64_t row = m_currentBatchPointIndex; row < end; ++row)
+            if (inBounds(row))
+                m_rows.push_back(row);
+        fillColumns(*view);
+
+        numRead += m_rows.size();
+        m_currentBatchPointIndex = end;
     }
     return numRead;
 }
@@ -418,11 +611,11 @@ point_count_t ArrowReader::read(PointViewPtr view, point_count_t num)
 
 bool ArrowReader::readNextBatchHeaders()
 {
-    if (m_currentBatchIndex == m_batchCount)
-        return false;
-
     if (m_formatType == arrowsupport::Feather){
 
+        if (m_currentBatchIndex == m_batchCount)
+            return false;
+
         auto readResult = m_ipcReader->ReadRecordBatch(m_currentBatchIndex);
         if (!readResult.ok())
         {
@@ -451,162 +644,260 @@ bool ArrowReader::readNextBatchHeaders()
             throwError(msg.str());
         }
         m_currentBatch = result.ValueOrDie();
+
+        // A null batch marks the end of the data.
+        if (!m_currentBatch)
+            return false;
     }
 
     return true;
 }
 
 
-bool ArrowReader::readNextBatchData()
+// Move to the next batch that has rows.
+bool ArrowReader::nextBatch()
 {
-    m_arrays.clear();
-    for(int columnNum = 0; columnNum < m_currentBatch->num_columns(); ++columnNum)
+    do
     {
-        // https://arrow.apache.org/docs/cpp/api/array.html#_CPPv4N5arrow5ArrayE
-        std::shared_ptr<arrow::Array> array = m_currentBatch->column(columnNum);
-        m_arrays[m_arrayIds[columnNum]] = array;
-    }
+        m_currentBatchIndex++;
+        if (!readNextBatchHeaders())
+        {
+            m_currentBatch.reset();
+            return false;
+        }
+    } while (m_currentBatch->num_rows() == 0);
+
+    m_currentBatchPointIndex = 0;
+    setupBatch();
     return true;
 }
 
-bool ArrowReader::fillPoint(PointRef& point)
+
+// Find the columns of the current batch to read.
+void ArrowReader::setupBatch()
 {
-    for(int columnNum = 0; columnNum < m_currentBatch->num_columns(); ++columnNum)
+    m_columns.clear();
+    m_xArray.reset();
+    m_yArray.reset();
+    m_zArray.reset();
+    m_xyzArray.reset();
+
+    std::shared_ptr<arrow::Schema> schema = m_currentBatch->schema();
+    for (int columnNum = 0; columnNum < m_currentBatch->num_columns(); ++columnNum)
     {
-        // https://arrow.apache.org/docs/cpp/api/array.html#_CPPv4N5arrow5ArrayE
         std::shared_ptr<arrow::Array> array = m_currentBatch->column(columnNum);
-
-        pdal::Dimension::Id pDimId = m_arrayIds[columnNum];
         switch (array->type_id())
         {
-            case arrow::Type::DOUBLE:
+            case arrow::Type::BINARY:
+                m_columns.emplace_back(columnNum, Dimension::Id::Unknown);
+                break;
+            case arrow::Type::FIXED_SIZE_LIST:
+            case arrow::Type::LIST:
+                m_columns.emplace_back(columnNum, Dimension::Id::Unknown);
+                m_xyzArray = array;
+                break;
+            default:
             {
-                const auto castArray = static_cast<const arrow::DoubleArray*>(array.get());
-                point.setField<double>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                auto it = m_fieldIds.find(schema->field(columnNum)->name());
+                if (it == m_fieldIds.end())
+                    break;
+                m_columns.emplace_back(columnNum, it->second);
+                if (it->second == Dimension::Id::X)
+                    m_xArray = array;
+                else if (it->second == Dimension::Id::Y)
+                    m_yArray = array;
+                else if (it->second == Dimension::Id::Z)
+                    m_zArray = array;
                 break;
             }
+        }
+    }
+
+    if (m_bounds.valid() && !m_xyzArray &&
+            !(m_xArray && m_yArray && (m_zArray || !m_bounds.is3d())))
+        throwError("Option 'bounds' requires X, Y (and Z for 3D bounds) "
+            "columns or a GeoArrow point column.");
+}
+
+
+bool ArrowReader::inBounds(int64_t row) const
+{
+    if (!m_bounds.valid())
+        return true;
+
+    double x, y, z;
+    if (m_xyzArray)
+    {
+        const arrow::DoubleArray& values = listValues(*m_xyzArray);
+        int64_t offset = listOffset(*m_xyzArray, row);
+        x = values.Value(offset);
+        y = values.Value(offset + 1);
+        z = values.Value(offset + 2);
+    }
+    else
+    {
+        x = numericValue(*m_xArray, row);
+        y = numericValue(*m_yArray, row);
+        z = m_zArray ? numericValue(*m_zArray, row) : 0;
+    }
+    return m_box.contains(x, y, z);
+}
+
+
+void ArrowReader::fillGeometry(PointRef& point, const arrow::Array& array,
+    int64_t row)
+{
+    if (array.type_id() == arrow::Type::BINARY)
+    {
+        // We assume any binary arrays are WKB. If they aren't we are throwing
+        // an error
+        const auto& castArray = static_cast<const arrow::BinaryArray&>(array);
+        std::string_view wkb = castArray.Value(row);
+        pdal::Geometry pt = pdal::Geometry(std::string(wkb));
+        OGRGeometry* g = (OGRGeometry*) pt.getOGRHandle();
+        OGRPoint* p = dynamic_cast<OGRPoint*>(g->toPoint());
+        if (p)
+        {
+            point.setField<double>(Dimension::Id::X, p->getX());
+            point.setField<double>(Dimension::Id::Y, p->getY());
+            point.setField<double>(Dimension::Id::Z, p->getZ());
+        } else
+        {
+            throwError("BinaryArray field was not WKB of type point!");
+        }
+    }
+    else
+    {
+        // only xyz for now
+        const arrow::DoubleArray& values = listValues(array);
+        int64_t offset = listOffset(array, row);
+        point.setField<double>(Dimension::Id::X, values.Value(offset));
+        point.setField<double>(Dimension::Id::Y, values.Value(offset + 1));
+        point.setField<double>(Dimension::Id::Z, values.Value(offset + 2));
+    }
+}
+
+
+void ArrowReader::fillPoint(PointRef& point, int64_t row)
+{
+    for (auto& column : m_columns)
+    {
+        // https://arrow.apache.org/docs/cpp/api/array.html#_CPPv4N5arrow5ArrayE
+        const arrow::Array& array = *m_currentBatch->column(column.first);
+
+        pdal::Dimension::Id pDimId = column.second;
+        switch (array.type_id())
+        {
+            case arrow::Type::DOUBLE:
+                point.setField(pDimId, static_cast<const arrow::DoubleArray&>(array).Value(row));
+                break;
             case arrow::Type::FLOAT:
-            {
-                const auto castArray = static_cast<const arrow::FloatArray*>(array.get());
-                point.setField<float>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::FloatArray&>(array).Value(row));
                 break;
-            }
             case arrow::Type::INT8:
-            {
-                const auto castArray = static_cast<const arrow::Int8Array*>(array.get());
-                point.setField<int8_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::Int8Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::UINT8:
-            {
-                const auto castArray = static_cast<const arrow::UInt8Array*>(array.get());
-                point.setField<uint8_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::UInt8Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::INT16:
-            {
-                const auto castArray = static_cast<const arrow::Int16Array*>(array.get());
-                point.setField<int16_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::Int16Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::UINT16:
-            {
-                const auto castArray = static_cast<const arrow::UInt16Array*>(array.get());
-                point.setField<uint16_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::UInt16Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::INT32:
-            {
-                const auto castArray = static_cast<const arrow::Int32Array*>(array.get());
-                point.setField<int32_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::Int32Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::UINT32:
-            {
-                const auto castArray = static_cast<const arrow::UInt32Array*>(array.get());
-                point.setField<uint32_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::UInt32Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::INT64:
-            {
-                const auto castArray = static_cast<const arrow::Int64Array*>(array.get());
-                point.setField<int64_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::Int64Array&>(array).Value(row));
                 break;
-            }
             case arrow::Type::UINT64:
-            {
-                const auto castArray = static_cast<const arrow::UInt64Array*>(array.get());
-                point.setField<uint64_t>(pDimId, castArray->Value(m_currentBatchPointIndex));
+                point.setField(pDimId, static_cast<const arrow::UInt64Array&>(array).Value(row));
                 break;
-            }
-            case arrow::Type::BINARY:
-            {
-                // We assume any binary arrays are WKB. If they aren't we are throwing
-                // an error
-                const auto castArray = static_cast<const arrow::BinaryArray*>(array.get());
-                std::string_view wkb = castArray->Value(m_currentBatchPointIndex);
-                pdal::Geometry pt = pdal::Geometry(std::string(wkb));
-                OGRGeometry* g = (OGRGeometry*) pt.getOGRHandle();
-                OGRPoint* p = dynamic_cast<OGRPoint*>(g->toPoint());
-                if (p)
-                {
-                    point.setField<double>(Dimension::Id::X, p->getX());
-                    point.setField<double>(Dimension::Id::Y, p->getY());
-                    point.setField<double>(Dimension::Id::Z, p->getZ());
-                } else
-                {
-                    throwError("BinaryArray field was not WKB of type point!");
-                }
+            default:
+                fillGeometry(point, array, row);
                 break;
-            }
-            case arrow::Type::FIXED_SIZE_LIST:
-            case arrow::Type::LIST:
-            {
-                const auto listArray = static_cast<const arrow::FixedSizeListArray*>(array.get());
-                assert(listArray->values()->type_id() == arrow::Type::DOUBLE);
-                const auto pointValues =
-                    std::static_pointer_cast<arrow::DoubleArray>(listArray->values());
+        }
+    }
+}
 
-                int nDim(3); // only xyz for now
 
-                point.setField<double>(Dimension::Id::X, pointValues->Value((nDim * m_currentBatchPointIndex)));
-                point.setField<double>(Dimension::Id::Y, pointValues->Value((nDim * m_currentBatchPointIndex) + 1));
-                point.setField<double>(Dimension::Id::Z, pointValues->Value((nDim * m_currentBatchPointIndex) + 2));
+// Copy the rows in m_rows to the view a column at a time.
+void ArrowReader::fillColumns(PointView& view)
+{
+    const PointId start = view.size();
+    for (auto& column : m_columns)
+    {
+        const arrow::Array& array = *m_currentBatch->column(column.first);
+        Dimension::Id id = column.second;
+        switch (array.type_id())
+        {
+            case arrow::Type::DOUBLE:
+                copyColumn<arrow::DoubleArray>(view, start, id, array, m_rows);
                 break;
-            }
-            case arrow::Type::STRING:
-            case arrow::Type::STRUCT:
+            case arrow::Type::FLOAT:
+                copyColumn<arrow::FloatArray>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::INT8:
+                copyColumn<arrow::Int8Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::UINT8:
+                copyColumn<arrow::UInt8Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::INT16:
+                copyColumn<arrow::Int16Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::UINT16:
+                copyColumn<arrow::UInt16Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::INT32:
+                copyColumn<arrow::Int32Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::UINT32:
+                copyColumn<arrow::UInt32Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::INT64:
+                copyColumn<arrow::Int64Array>(view, start, id, array, m_rows);
+                break;
+            case arrow::Type::UINT64:
+                copyColumn<arrow::UInt64Array>(view, start, id, array, m_rows);
+                break;
+            default:
             {
-                // don't do anything for these
-                continue;
+                PointRef point(view, start);
+                PointId idx = start;
+                for (int64_t row : m_rows)
+                {
+                    point.setPointId(idx++);
+                    fillGeometry(point, array, row);
+                }
+                break;
             }
-            default:
-                throw pdal_error("Unrecognized PDAL dimension type for dimension");
         }
     }
-    return true;
 }
 
 
 bool ArrowReader::processOne(PointRef& point)
 {
-    if (m_currentBatchPointIndex == m_currentBatch->num_rows())
+    while (true)
     {
-        // go read a new batch
-        m_currentBatchIndex++;
-
-        bool nextBatch = readNextBatchHeaders();
-        if (!nextBatch) return false; // we're done
-
-        m_currentBatchPointIndex = 0;
+        if ((!m_currentBatch ||
+                m_currentBatchPointIndex == m_currentBatch->num_rows()) &&
+                !nextBatch())
+            return false; // we're done
 
-        // go read data for next batch
-        readNextBatchData();
+        int64_t row = m_currentBatchPointIndex++;
+        if (inBounds(row))
+        {
+            fillPoint(point, row);
+            return true;
+        }
     }
-
-    bool retval = fillPoint(point);
-    m_currentBatchPointIndex++;
-    return retval;
 }
 
 
@@ -41,6 +41,7 @@
 #include <pdal/PointView.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
+#include <pdal/util/Bounds.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 #include "ArrowCommon.hpp"
@@ -66,18 +67,25 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
+    virtual void ready(PointTableRef table);
     virtual point_count_t read(PointViewPtr view, point_count_t num);
     virtual bool processOne(PointRef& point);
     virtual void done(PointTableRef table);
 
     bool readNextBatchHeaders();
-    bool readNextBatchData();
-    bool fillPoint(PointRef& point);
+    bool nextBatch();
+    void setupBatch();
+    bool inBounds(int64_t row) const;
+    void fillPoint(PointRef& point, int64_t row);
+    void fillGeometry(PointRef& point, const arrow::Array& array, int64_t row);
+    void fillColumns(PointView& view);
+    std::vector<int> selectRowGroups() const;
+    std::vector<int> selectColumns() const;
 
     void loadParquetGeoMetadata(const std::shared_ptr<const arrow::KeyValueMetadata> &kv_metadata);
     void loadArrowGeoMetadata(const std::shared_ptr<const arrow::KeyValueMetadata> &kv_metadata);
 
-    std::shared_ptr<arrow::io::ReadableFile> m_file;
+    std::shared_ptr<arrow::io::RandomAccessFile> m_file;
     std::shared_ptr<arrow::ipc::RecordBatchFileReader> m_ipcReader;
     std::unique_ptr<::arrow::RecordBatchReader> m_parquetReader;
     std::unique_ptr<parquet::arrow::FileReader> m_arrow_reader;
@@ -88,8 +96,24 @@ private:
     std::string m_formatTypeString;
 
 
-    std::map<int, pdal::Dimension::Id> m_arrayIds;
-    std::map<pdal::Dimension::Id, std::shared_ptr<arrow::Array> > m_arrays;
+    std::shared_ptr<arrow::Schema> m_schema;
+    std::map<std::string, pdal::Dimension::Id> m_fieldIds;
+
+    // Columns of the current batch to read and the dimension of each.
+    // Geometry columns map to Dimension::Id::Unknown.
+    std::vector<std::pair<int, pdal::Dimension::Id>> m_columns;
+    // Rows of the current batch being copied in standard mode.
+    std::vector<int64_t> m_rows;
+
+    // Only points inside the bounds are read, if they're valid.
+    Bounds m_bounds;
+    BOX3D m_box;
+    // Columns of the current batch holding X, Y and Z, or a GeoArrow
+    // point column, used for the bounds test.
+    std::shared_ptr<arrow::Array> m_xArray;
+    std::shared_ptr<arrow::Array> m_yArray;
+    std::shared_ptr<arrow::Array> m_zArray;
+    std::shared_ptr<arrow::Array> m_xyzArray;
 
     arrow::MemoryPool* m_pool;
     int m_batchCount;
@@ -33,6 +33,8 @@
 ****************************************************************************/
 
 #include <memory>
+#include <numeric>
+#include <thread>
 #include <vector>
 
 #include "ArrowWriter.hpp"
@@ -42,6 +44,8 @@
 #include <pdal/pdal_config.hpp>
 #include <pdal/util/FileUtils.hpp>
 #include <pdal/util/Utils.hpp>
+#include <pdal/private/KeySort.hpp>
+#include <pdal/private/SpaceCurve.hpp>
 #include <pdal/private/gdal/GDALUtils.hpp>
 #include <io/private/las/Header.hpp>
 
@@ -74,10 +78,15 @@ public:
     virtual ~BaseDimHandler()
     {}
 
+    // Make a handler for the same dimension with an empty builder.
+    virtual std::unique_ptr<BaseDimHandler> clone() const = 0;
     // Get an arrow field approriate for handling a dimension.
     virtual std::shared_ptr<arrow::Field> field() = 0;
     // Append a the dimension data from a point to an array builder.
     virtual Utils::StatusWithReason append(const PointRef& point) = 0;
+    // Append the dimension data for a block of points to an array builder.
+    virtual Utils::StatusWithReason append(const PointView& view, const PointId *ids,
+        point_count_t count) = 0;
     // Finish building of point data for a builder. The builder is reused for the next
     // data block.
     virtual Utils::StatusWithReason finish(std::shared_ptr<arrow::Array>& array)
@@ -88,6 +97,14 @@ public:
         return true;
     }
 
+protected:
+    static Utils::StatusWithReason check(const arrow::Status& status)
+    {
+        if (!status.ok())
+            return { -1, status.message() };
+        return true;
+    }
+
 private:
     // Get a builder appropriate for the data type.
     virtual arrow::ArrayBuilder& builder() = 0;
@@ -98,9 +115,14 @@ class DimHandler : public BaseDimHandler
 {
 public:
     DimHandler(arrow::MemoryPool *pool, Dimension::Id id, const std::string& name) :
-        m_builder(pool), m_id(id), m_name(name)
+        m_pool(pool), m_builder(pool), m_id(id), m_name(name)
     {}
 
+    std::unique_ptr<BaseDimHandler> clone() const override
+    {
+        return std::make_unique<DimHandler<DT>>(m_pool, m_id, m_name);
+    }
+
     FieldPtr field() override
     {
         auto kvMetadata = std::make_shared<arrow::KeyValueMetadata>();
@@ -119,10 +141,17 @@ public:
 
     Utils::StatusWithReason append(const PointRef& point) override
     {
-        arrow::Status status = m_builder.Append(point.getFieldAs<DT>(m_id));
-        if (!status.ok())
-            return { -1, status.message() };
-        return true;
+        return check(m_builder.Append(point.getFieldAs<DT>(m_id)));
+    }
+
+    // Gather the block into a contiguous array and append it in one call.
+    Utils::StatusWithReason append(const PointView& view, const PointId *ids,
+        point_count_t count) override
+    {
+        m_values.resize(count);
+        for (point_count_t i = 0; i < count; ++i)
+            m_values[i] = view.getFieldAs<DT>(m_id, ids[i]);
+        return check(m_builder.AppendValues(m_values.data(), (int64_t)count));
     }
 
 private:
@@ -130,9 +159,11 @@ private:
     { return m_builder; }
 
 private:
+    arrow::MemoryPool *m_pool;
     arrow::NumericBuilder<typename TypeTraits<DT>::TypeClass> m_builder;
     Dimension::Id m_id;
     std::string m_name;
+    std::vector<DT> m_values;
 };
 
 // Handler for packed XYZ data.
@@ -141,12 +172,17 @@ class XyzHandler : public BaseDimHandler
 public:
     XyzHandler(arrow::MemoryPool *pool, const std::string& dimName,
             const std::string& pipelineMetadata) :
-        m_dimName(dimName), m_pipelineMetadata(pipelineMetadata),
+        m_pool(pool), m_dimName(dimName), m_pipelineMetadata(pipelineMetadata),
         m_doubleBuilder(std::make_shared<arrow::DoubleBuilder>(pool)),
         m_builder(pool, m_doubleBuilder, 3)
     {
     }
 
+    std::unique_ptr<BaseDimHandler> clone() const override
+    {
+        return std::make_unique<XyzHandler>(m_pool, m_dimName, m_pipelineMetadata);
+    }
+
     std::shared_ptr<arrow::Field> field() override
     {
         NL::json metadata {
@@ -174,9 +210,27 @@ public:
             m_doubleBuilder->Append(x) &
             m_doubleBuilder->Append(y) &
             m_doubleBuilder->Append(z);
-        if (!status.ok())
-            return { -1, status.message() };
-        return true;
+        return check(status);
+    }
+
+    // Interleave the block's XYZ values and append the list values and
+    // list slots in one call each.
+    Utils::StatusWithReason append(const PointView& view, const PointId *ids,
+        point_count_t count) override
+    {
+        m_values.resize(3 * count);
+        double *pos = m_values.data();
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            *pos++ = view.getFieldAs<double>(Dimension::Id::X, ids[i]);
+            *pos++ = view.getFieldAs<double>(Dimension::Id::Y, ids[i]);
+            *pos++ = view.getFieldAs<double>(Dimension::Id::Z, ids[i]);
+        }
+
+        arrow::Status status =
+            m_doubleBuilder->AppendValues(m_values.data(), (int64_t)m_values.size()) &
+            m_builder.AppendValues((int64_t)count);
+        return check(status);
     }
 
 private:
@@ -184,27 +238,37 @@ private:
     { return m_builder; }
 
 private:
+    arrow::MemoryPool *m_pool;
     std::string m_dimName;
     std::string m_pipelineMetadata;
     std::shared_ptr<arrow::DoubleBuilder> m_doubleBuilder;
     arrow::FixedSizeListBuilder m_builder;
+    std::vector<double> m_values;
 };
 
 // Handler for WKB-encoded XYZ data per GeoParquet specification.
 class WkbHandler : public BaseDimHandler
 {
 public:
+    static constexpr int WkbSize = 5 + 3 * sizeof(double);
+
     WkbHandler(arrow::MemoryPool *pool, const std::string& pipelineMetadata = std::string()) :
-        m_pipelineMetadata(pipelineMetadata), m_builder(arrow::fixed_size_binary(29), pool)
+        m_pool(pool), m_pipelineMetadata(pipelineMetadata),
+        m_builder(arrow::fixed_size_binary(WkbSize), pool)
     {}
 
+    std::unique_ptr<BaseDimHandler> clone() const override
+    {
+        return std::make_unique<WkbHandler>(m_pool, m_pipelineMetadata);
+    }
+
     FieldPtr field() override
     {
         NL::json metadata {
             { "name", "wkb" },
             { "description", "WKB points" },
             { "interpretation", "binary" },
-            { "size", 29 }
+            { "size", WkbSize }
         };
 
         auto kvMetadata = std::make_shared<arrow::KeyValueMetadata>();
@@ -217,45 +281,64 @@ public:
         return arrow::field("wkb", arrow::binary(), kvMetadata);
     }
 
-    // Write XYZ as little-endian encoded well-known binary.
     Utils::StatusWithReason append(const PointRef& point) override
+    {
+        uint8_t buf[WkbSize];
+        encode(point.getFieldAs<double>(Dimension::Id::X),
+            point.getFieldAs<double>(Dimension::Id::Y),
+            point.getFieldAs<double>(Dimension::Id::Z), buf);
+        return check(m_builder.Append(buf, WkbSize));
+    }
+
+    // Reserve space for the whole block so that the points can be appended
+    // without checks or reallocation.
+    Utils::StatusWithReason append(const PointView& view, const PointId *ids,
+        point_count_t count) override
+    {
+        arrow::Status status = m_builder.Reserve((int64_t)count) &
+            m_builder.ReserveData((int64_t)count * WkbSize);
+        if (!status.ok())
+            return check(status);
+
+        uint8_t buf[WkbSize];
+        for (point_count_t i = 0; i < count; ++i)
+        {
+            encode(view.getFieldAs<double>(Dimension::Id::X, ids[i]),
+                view.getFieldAs<double>(Dimension::Id::Y, ids[i]),
+                view.getFieldAs<double>(Dimension::Id::Z, ids[i]), buf);
+            m_builder.UnsafeAppend(buf, WkbSize);
+        }
+        return true;
+    }
+
+    arrow::ArrayBuilder& builder() override
+    { return m_builder; }
+
+private:
+    // Write XYZ as little-endian encoded well-known binary.
+    static void encode(double x, double y, double z, uint8_t *buf)
     {
         auto tole = [](double d)
         {
-            uint64_t *u = reinterpret_cast<uint64_t *>(&d);
-            *u = htole64(*u);
-            d = *(reinterpret_cast<double *>(u));
-            return d;
+            uint64_t u;
+            memcpy(&u, &d, sizeof(u));
+            u = htole64(u);
+            return u;
         };
 
-        double x = tole(point.getFieldAs<double>(Dimension::Id::X));
-        double y = tole(point.getFieldAs<double>(Dimension::Id::Y));
-        double z = tole(point.getFieldAs<double>(Dimension::Id::Z));
-
         // The first five bytes in the buffer is the magic code for a
         // little-endian encoded XYZ 2.5d point. The first byte is the little-endian
         // code (0x01). The remaining bytes specify the geometry type.
         // Finding this in any document these days is nigh impossible. See the
         // GDAL source code. :(
-        static uint8_t buf[5 + 3 * sizeof(double)] { 0x01, 0x01, 0x00, 0x00, 0x80 };
-        static uint8_t * const xpos = buf + 5;
-        static uint8_t * const ypos = xpos + sizeof(x);
-        static uint8_t * const zpos = ypos + sizeof(y);
+        static const uint8_t header[5] { 0x01, 0x01, 0x00, 0x00, 0x80 };
 
-        memcpy(xpos, &x, sizeof(x));
-        memcpy(ypos, &y, sizeof(y));
-        memcpy(zpos, &z, sizeof(z));
-
-        arrow::Status status = m_builder.Append(buf, 29);
-        if (!status.ok())
-            return { -1, status.message() };
-        return true;
+        uint64_t xyz[3] { tole(x), tole(y), tole(z) };
+        memcpy(buf, header, sizeof(header));
+        memcpy(buf + sizeof(header), xyz, sizeof(xyz));
     }
 
-    arrow::ArrayBuilder& builder() override
-    { return m_builder; }
-
-private:
+    arrow::MemoryPool *m_pool;
     std::string m_pipelineMetadata;
     arrow::BinaryBuilder m_builder;
 };
@@ -285,6 +368,15 @@ void ArrowWriter::initialize()
     if (m_formatType == arrowsupport::Unknown)
         throwError("Unknown format '" + m_formatString + "' provided. Unable to write array");
 
+    if (m_batchSize <= 0)
+        throwError("Option 'batch_size' must be greater than 0.");
+    if (m_threads < 1)
+        throwError("Option 'threads' must be greater than 0.");
+    m_order = Utils::tolower(m_order);
+    if (m_order != "none" && m_order != "morton" && m_order != "hilbert")
+        throwError("Invalid order '" + m_order + "'. Must be 'none', 'morton' "
+            "or 'hilbert'.");
+
     auto result = arrow::io::FileOutputStream::Open(filename(), /*append=*/false);
     if (result.ok())
         m_file = result.ValueOrDie();
@@ -333,6 +425,10 @@ void ArrowWriter::addArgs(ProgramArgs& args)
     args.add("write_pipeline_metadata", "Write PDAL metadata to schema",
         m_writePipelineMetadata, true);
     args.add("geoparquet_version", "GeoParquet version string", m_geoParquetVersion, "1.0.0");
+    args.add("order", "Order of points in the output: 'none', 'morton' or 'hilbert'",
+        m_order, "none");
+    args.add("threads", "Number of threads used to build batches", m_threads,
+        (int)(std::max)(1U, std::thread::hardware_concurrency()));
 }
 
 void ArrowWriter::prepared(PointTableRef table)
@@ -411,12 +507,99 @@ void ArrowWriter::ready(PointTableRef table)
         setupParquet(table);
     else if (m_formatType == arrowsupport::Feather)
         setupFeather(table);
+
+    // Batches are encoded and written on a single thread while the next
+    // batches are built.  Limit the queue so that memory use is bounded.
+    m_writeError.clear();
+    m_writer.reset(new ThreadPool(1, 2));
+}
+
+
+PointIdList ArrowWriter::pointOrder(const PointView& view) const
+{
+    PointIdList ids(view.size());
+    if (m_order == "none")
+    {
+        std::iota(ids.begin(), ids.end(), 0);
+        return ids;
+    }
+
+    BOX2D bounds;
+    view.calculateBounds(bounds);
+    curve::Encoder encoder(m_order == "hilbert" ?
+        curve::Type::Hilbert : curve::Type::Morton, bounds);
+
+    KeyIdList keys(view.size());
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        keys[idx] = { encoder.key(view.getFieldAs<double>(Dimension::Id::X, idx),
+            view.getFieldAs<double>(Dimension::Id::Y, idx)), idx };
+    keysort::sort(keys, m_threads);
+
+    for (size_t i = 0; i < keys.size(); ++i)
+        ids[i] = keys[i].id;
+    return ids;
 }
 
+
+// Points are split into batches of equal size no larger than batch_size,
+// so that the last batch (Parquet row group) isn't a small remainder.  A
+// window of batches is built in parallel, one set of handlers per batch,
+// and the built batches are queued for writing in order.
 void ArrowWriter::write(const PointViewPtr view)
 {
-    for (PointRef point : *view)
-        processOne(point);
+    const point_count_t count = view->size();
+    if (count == 0)
+        return;
+
+    const PointIdList ids = pointOrder(*view);
+    const point_count_t numBatches = (count + m_batchSize - 1) / m_batchSize;
+    const point_count_t batchSize = (count + numBatches - 1) / numBatches;
+    const size_t slots = (size_t)(std::min)((point_count_t)m_threads, numBatches);
+
+    std::vector<HandlerList> handlers(slots);
+    for (HandlerList& list : handlers)
+        for (auto& handler : m_dimHandlers)
+            list.push_back(handler->clone());
+
+    std::vector<std::vector<std::shared_ptr<arrow::Array>>> arrays(slots);
+    std::vector<std::string> errors(slots);
+    ThreadPool pool(slots);
+    for (point_count_t first = 0; first < numBatches; first += slots)
+    {
+        const size_t window = (size_t)(std::min)((point_count_t)slots, numBatches - first);
+        for (size_t i = 0; i < window; ++i)
+        {
+            const PointId begin = (first + i) * batchSize;
+            const point_count_t size = (std::min)(batchSize, count - begin);
+            pool.add([&, i, begin, size]()
+            {
+                arrays[i].clear();
+                for (auto& handler : handlers[i])
+                {
+                    std::shared_ptr<arrow::Array> array;
+                    auto ok = handler->append(*view, ids.data() + begin, size);
+                    if (ok)
+                        ok = handler->finish(array);
+                    if (!ok)
+                    {
+                        errors[i] = ok.what();
+                        return;
+                    }
+                    arrays[i].push_back(std::move(array));
+                }
+            });
+        }
+        pool.await();
+
+        for (size_t i = 0; i < window; ++i)
+        {
+            if (errors[i].size())
+                throwError("Unable to append point data to arrow array: " +
+                    errors[i] + ".");
+            const PointId begin = (first + i) * batchSize;
+            queueBatch(std::move(arrays[i]), (std::min)(batchSize, count - begin));
+        }
+    }
 }
 
 void ArrowWriter::gatherParquetGeoMetadata(std::shared_ptr<arrow::KeyValueMetadata>& input,
@@ -451,8 +634,10 @@ void ArrowWriter::setupParquet(PointTableRef table)
     m_oWriterPropertiesBuilder.data_page_version(parquet::ParquetDataPageVersion::V2);
     m_oWriterPropertiesBuilder.compression(parquet::Compression::SNAPPY);
 
+    // With threads in use, the columns of a row group are encoded in parallel.
     std::shared_ptr<parquet::ArrowWriterProperties> arrowWriterProperties =
-        parquet::ArrowWriterProperties::Builder().store_schema()->build();
+        parquet::ArrowWriterProperties::Builder().store_schema()->
+            set_use_threads(m_threads > 1)->build();
 
     std::shared_ptr<parquet::SchemaDescriptor> parquet_schema;
     auto result = parquet::arrow::ToParquetSchema(m_schema.get(),
@@ -530,37 +715,58 @@ void ArrowWriter::flushBatch()
         arrays.push_back(std::move(array));
     }
 
-    if (m_formatType == arrowsupport::Parquet)
+    queueBatch(std::move(arrays), m_batchIndex);
+    m_batchIndex = 0;
+}
+
+
+void ArrowWriter::queueBatch(std::vector<std::shared_ptr<arrow::Array>>&& arrays,
+    point_count_t count)
+{
+    std::shared_ptr<arrow::RecordBatch> batch =
+        arrow::RecordBatch::Make(m_schema, count, std::move(arrays));
+    m_writer->add([this, batch]()
     {
-        auto result = m_parquetFileWriter->NewRowGroup();
+        writeBatch(*batch);
+    });
+}
 
-        if (!result.ok())
-            throwError("Unable to make NewRowGroup: " + result.ToString());
 
-        for (auto& array: arrays)
-        {
-            result = m_parquetFileWriter->WriteColumnChunk(*array);
-            if (!result.ok())
-                throwError("Unable to make WriteColumnChunk: " + result.ToString());
-        }
+// Called on the writer thread.  Errors are reported from done().
+void ArrowWriter::writeBatch(const arrow::RecordBatch& batch)
+{
+    if (m_writeError.size())
+        return;
+
+    arrow::Status status;
+    if (m_formatType == arrowsupport::Parquet)
+    {
+        // Each batch is written as its own row group.
+        status = m_parquetFileWriter->NewBufferedRowGroup();
+        if (status.ok())
+            status = m_parquetFileWriter->WriteRecordBatch(batch);
+        if (!status.ok())
+            m_writeError = "Unable to write row group: " + status.ToString();
     }
     else  // Feather
     {
-        std::shared_ptr<arrow::RecordBatch> batch =
-            arrow::RecordBatch::Make(m_schema, m_batchIndex, arrays);
-
-        auto result = m_arrowFileWriter->WriteRecordBatch(*batch);
-        if (!result.ok())
-            throwError("Unable to write arrow batch" + result.ToString());
+        status = m_arrowFileWriter->WriteRecordBatch(batch);
+        if (!status.ok())
+            m_writeError = "Unable to write arrow batch: " + status.ToString();
     }
-    m_batchIndex = 0;
 }
 
 
 void ArrowWriter::done(PointTableRef table)
 {
     // flush our final batch
-    flushBatch();
+    if (m_batchIndex)
+        flushBatch();
+
+    m_writer->await();
+    m_writer.reset();
+    if (m_writeError.size())
+        throwError(m_writeError);
 
     if (m_formatType == arrowsupport::Feather)
     {
@@ -37,6 +37,7 @@
 #include <pdal/pdal_features.hpp>
 #include <pdal/Writer.hpp>
 #include <pdal/Streamable.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #include "ArrowCommon.hpp"
 
@@ -52,6 +53,8 @@ class BaseDimHandler;
 
 class PDAL_EXPORT ArrowWriter  : public Writer, public Streamable
 {
+    using HandlerList = std::vector<std::unique_ptr<BaseDimHandler>>;
+
 public:
     ArrowWriter();
     ArrowWriter& operator=(const ArrowWriter&) = delete;
@@ -74,6 +77,10 @@ private:
     void gatherParquetGeoMetadata(std::shared_ptr<arrow::KeyValueMetadata>& input,
         const SpatialReference& ref);
     void flushBatch();
+    void queueBatch(std::vector<std::shared_ptr<arrow::Array>>&& arrays,
+        point_count_t count);
+    void writeBatch(const arrow::RecordBatch& batch);
+    PointIdList pointOrder(const PointView& view) const;
 
     std::string m_formatString;
     arrowsupport::ArrowFormatType m_formatType;
@@ -92,8 +99,16 @@ private:
     std::string m_geoArrowDimensionName;
     point_count_t m_batchIndex;
     bool m_writePipelineMetadata;
+    std::string m_order;
+    int m_threads;
+
+    HandlerList m_dimHandlers;
 
-    std::vector<std::unique_ptr<BaseDimHandler>> m_dimHandlers;
+    // Set on the writer thread, checked once it is idle.
+    std::string m_writeError;
+    // Declared last so that the writer thread is joined before any state it
+    // uses is destroyed.
+    std::unique_ptr<ThreadPool> m_writer;
 };
 
 } // namespace pdal
@@ -177,5 +177,48 @@ TEST(ArrowParquetReaderTest, SRS)
     EXPECT_EQ(m_reader.getSpatialReference(), utm10);
 }
 
+TEST(ArrowReaderTest, Bounds)
+{
+    const std::string bounds("([636000, 637500], [849000, 850500])");
+    BOX2D box;
+    box.minx = 636000;
+    box.maxx = 637500;
+    box.miny = 849000;
+    box.maxy = 850500;
+
+    LasReader l;
+    Options lo;
+    lo.add("filename", Support::datapath("las/1.2-with-color.las"));
+    l.setOptions(lo);
+    PointTable lt;
+    l.prepare(lt);
+    PointViewPtr lv = *l.execute(lt).begin();
+    point_count_t expected = 0;
+    for (PointId i = 0; i < lv->size(); ++i)
+        if (box.contains(lv->getFieldAs<double>(Dimension::Id::X, i),
+                lv->getFieldAs<double>(Dimension::Id::Y, i)))
+            expected++;
+    ASSERT_GT(expected, 0u);
+    ASSERT_LT(expected, lv->size());
+
+    for (std::string file : { "arrow/1.2-with-color_rowgroups.parquet",
+        "arrow/1.2-with-color.feather" })
+    {
+        ArrowReader r;
+        Options ro;
+        ro.add("filename", Support::datapath(file));
+        ro.add("bounds", bounds);
+        r.setOptions(ro);
+
+        PointTable t;
+        r.prepare(t);
+        PointViewPtr v = *r.execute(t).begin();
+        EXPECT_EQ(v->size(), expected);
+        for (PointId i = 0; i < v->size(); ++i)
+            EXPECT_TRUE(box.contains(v->getFieldAs<double>(Dimension::Id::X, i),
+                v->getFieldAs<double>(Dimension::Id::Y, i)));
+    }
+}
+
 } // namespace pdal
 
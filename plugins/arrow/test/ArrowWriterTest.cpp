@@ -39,6 +39,10 @@
 #include <io/FauxReader.hpp>
 #include "../io/ArrowWriter.hpp"
 
+#include <arrow/api.h>
+#include <arrow/io/api.h>
+#include <arrow/ipc/reader.h>
+
 namespace pdal
 {
 namespace arrow
@@ -86,6 +90,120 @@ TEST(ArrowWriterTest, write_array_parquet)
     PointViewSet viewSet = writer.execute(table);
 }
 
+namespace
+{
+
+void writeFeather(const std::string& filename, const std::string& order, bool stream)
+{
+    Options readerOps;
+    readerOps.add("filename", Support::datapath("las/1.2-with-color.las"));
+    LasReader reader;
+    reader.setOptions(readerOps);
+
+    Options writerOps;
+    writerOps.add("filename", filename);
+    writerOps.add("batch_size", 100);
+    writerOps.add("threads", 4);
+    writerOps.add("order", order);
+    ArrowWriter writer;
+    writer.setInput(reader);
+    writer.setOptions(writerOps);
+
+    if (stream)
+    {
+        FixedPointTable table(1000);
+        writer.prepare(table);
+        writer.execute(table);
+    }
+    else
+    {
+        PointTable table;
+        writer.prepare(table);
+        writer.execute(table);
+    }
+}
+
+// Read the batch sizes of a feather file and the sum of the X and Y
+// extents of the batches.
+std::vector<int64_t> readBatches(const std::string& filename, double& extent)
+{
+    auto file = ::arrow::io::ReadableFile::Open(filename).ValueOrDie();
+    auto reader = ::arrow::ipc::RecordBatchFileReader::Open(file).ValueOrDie();
+
+    std::vector<int64_t> sizes;
+    extent = 0;
+    for (int i = 0; i < reader->num_record_batches(); ++i)
+    {
+        auto batch = reader->ReadRecordBatch(i).ValueOrDie();
+        sizes.push_back(batch->num_rows());
+
+        auto xyz = std::static_pointer_cast<::arrow::FixedSizeListArray>(
+            batch->GetColumnByName("xyz"));
+        auto values = std::static_pointer_cast<::arrow::DoubleArray>(xyz->values());
+        BOX2D box;
+        for (int64_t row = 0; row < batch->num_rows(); ++row)
+            box.grow(values->Value(3 * row), values->Value(3 * row + 1));
+        extent += (box.maxx - box.minx) + (box.maxy - box.miny);
+    }
+    return sizes;
+}
+
+} // unnamed namespace
+
+TEST(ArrowWriterTest, batches)
+{
+    std::string unsorted(Support::temppath("unsorted.feather"));
+    std::string morton(Support::temppath("morton.feather"));
+    std::string streamed(Support::temppath("streamed.feather"));
+
+    writeFeather(unsorted, "none", false);
+    writeFeather(morton, "morton", false);
+    writeFeather(streamed, "none", true);
+
+    // The 1065 points are split into 11 batches of equal size.
+    double unsortedExtent;
+    std::vector<int64_t> sizes = readBatches(unsorted, unsortedExtent);
+    ASSERT_EQ(sizes.size(), 11u);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(sizes[i], 97);
+    EXPECT_EQ(sizes[10], 95);
+
+    // Sorted batches cover smaller areas.
+    double mortonExtent;
+    sizes = readBatches(morton, mortonExtent);
+    ASSERT_EQ(sizes.size(), 11u);
+    EXPECT_LT(mortonExtent, unsortedExtent);
+
+    // Streamed points are written in full batches.
+    double streamedExtent;
+    sizes = readBatches(streamed, streamedExtent);
+    ASSERT_EQ(sizes.size(), 11u);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(sizes[i], 100);
+    EXPECT_EQ(sizes[10], 65);
+}
+
+TEST(ArrowWriterTest, threads)
+{
+    for (int threads : { 0, -1 })
+    {
+        FauxReader reader;
+        Options readerOps;
+        readerOps.add("count", 10);
+        reader.setOptions(readerOps);
+
+        ArrowWriter writer;
+        Options writerOps;
+        writerOps.add("filename", Support::temppath("threads.feather"));
+        writerOps.add("threads", threads);
+        writer.setInput(reader);
+        writer.setOptions(writerOps);
+
+        PointTable table;
+        EXPECT_THROW(writer.prepare(table), pdal_error);
+    }
+}
+
 } // namespace arrow
 } // namespace pdal
 
@@ -32,10 +32,13 @@
  * OF SUCH DAMAGE.
  ****************************************************************************/
 
+#include <thread>
+
 #include "E57Reader.hpp"
 #include "Utils.hpp"
 #include "arbiter/arbiter.hpp"
 #include <pdal/util/Algorithm.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 namespace pdal
 {
@@ -59,50 +62,40 @@ E57Reader::E57Reader()
 {
 }
 
+E57Reader::~E57Reader()
+{
+}
+
 void E57Reader::addArgs(ProgramArgs& args)
 {
     args.add("extra_dims", "Extra dimensions to read from E57 point cloud.",
              m_extraDimsSpec);
+    args.add("threads", "Number of scans to decode in parallel in standard mode.",
+             m_threads, (int)(std::max)(1U, std::thread::hardware_concurrency()));
 }
 
-void E57Reader::initializeBuffers()
+namespace
 {
-    m_doubleBuffers.clear();
-    m_destBuffers.clear();
-    m_e57PointPrototype.reset(new StructureNode(m_scan->getPointPrototype()));
-
-    // Initialize for supported dimensions.
-    auto supportedFields = e57plugin::supportedE57Types();
-    for (auto& dimension : supportedFields)
-    {
-        if (m_e57PointPrototype->isDefined(dimension))
-        {
-            m_doubleBuffers[dimension] =
-                std::vector<double>(m_defaultChunkSize, 0);
-        }
-    }
 
-    // Initialize for extra dimensions.
-    for (auto i = m_extraDims->begin(); i != m_extraDims->end(); ++i)
-    {
-        if (m_e57PointPrototype->isDefined(i->m_name))
-        {
-            m_doubleBuffers[i->m_name] =
-                std::vector<double>(m_defaultChunkSize, 0);
-        }
-    }
+// Number of points read from a scan at a time.
+const size_t ChunkSize = 10000;
 
-    // Link to destination buffers.
-    for (auto& keyValue : m_doubleBuffers)
+// Copy a range of converted values to consecutive points of a view, one
+// field after another.
+void insert(PointView& view, PointId idx,
+    const std::vector<ScanReader::Field>& fields, size_t offset,
+    point_count_t count)
+{
+    for (const ScanReader::Field& f : fields)
     {
-        m_destBuffers.emplace_back(
-            *m_imf, keyValue.first, keyValue.second.data(), m_defaultChunkSize,
-            true,
-            (m_e57PointPrototype->get(keyValue.first).type() ==
-             e57::E57_SCALED_INTEGER));
+        const double *v = f.m_values.data() + offset;
+        for (point_count_t i = 0; i < count; ++i)
+            view.setField(f.m_id, idx + i, v[i]);
     }
 }
 
+} // unnamed namespace
+
 void E57Reader::addDimensions(PointLayoutPtr layout)
 {
     auto supportedFields = e57plugin::supportedE57Types();
@@ -172,13 +165,30 @@ void E57Reader::addDimensions(PointLayoutPtr layout)
     }
 }
 
+std::unique_ptr<ImageFile> E57Reader::openFile(const std::string& path) const
+{
+    std::unique_ptr<ImageFile> imf(new ImageFile(path, "r"));
+
+    const e57::ustring normalsExtension(
+        "http://www.libe57.org/E57_NOR_surface_normals.txt");
+    e57::ustring _normalsExtension;
+
+    // the extension may already be registered
+    if (!imf->extensionsLookupPrefix("nor", _normalsExtension))
+        imf->extensionsAdd("nor", normalsExtension);
+    return imf;
+}
+
 void E57Reader::initialize()
 {
     try
     {
+        // Keep the handle so that a copy of a remote file stays around for
+        // the threads that decode scans.
         arbiter::Arbiter arb;
-        arbiter::LocalHandle fileHandle = arb.getLocalHandle(m_filename);
-        m_imf.reset(new ImageFile(fileHandle.localPath(), "r"));
+        m_localHandle.reset(
+            new arbiter::LocalHandle(arb.getLocalHandle(m_filename)));
+        m_imf = openFile(m_localHandle->localPath());
         StructureNode root = m_imf->root();
 
         if (!root.isDefined("/data3D"))
@@ -186,14 +196,6 @@ void E57Reader::initialize()
             throwError("File doesn't contain 3D data");
         }
 
-        const e57::ustring normalsExtension(
-            "http://www.libe57.org/E57_NOR_surface_normals.txt");
-        e57::ustring _normalsExtension;
-
-        // the extension may already be registered
-        if (!m_imf->extensionsLookupPrefix("nor", _normalsExtension))
-            m_imf->extensionsAdd("nor", normalsExtension);
-
         m_data3D.reset(new VectorNode(root.get("/data3D")));
 
     }
@@ -213,9 +215,17 @@ void E57Reader::ready(PointTableRef& ref)
     
     m_currentIndex = 0;
     m_pointsInCurrentBatch = 0;
-    m_defaultChunkSize = 10000;
     m_currentScan = -1;
-    
+
+    // Resolve the E57 fields to read and their dimensions once. Fields are
+    // ordered by name.
+    std::map<std::string, Dimension::Id> fields;
+    for (auto& dimension : e57plugin::supportedE57Types())
+        fields[dimension] = e57plugin::e57ToPdal(dimension);
+    for (auto i = m_extraDims->begin(); i != m_extraDims->end(); ++i)
+        fields[i->m_name] = i->m_id;
+    m_fieldMap.assign(fields.begin(), fields.end());
+
     // Initial reader setup.
     setupReader();
 }
@@ -246,16 +256,17 @@ QuickInfo E57Reader::inspect()
 /// Setup reader to read next scan if available.
 void E57Reader::setupReader()
 {
+    m_scanReader.reset();
+
     // Are we done with reading all scans?
     if (++m_currentScan >= m_data3D->childCount())
         return;
 
     try
     {
-        m_scan.reset(new Scan((StructureNode)m_data3D->get(m_currentScan)));
-        initializeBuffers();
-        m_reader.reset(new CompressedVectorReader(
-                           m_scan->getPoints().reader(m_destBuffers)));
+        m_scanReader.reset(new ScanReader(*m_imf,
+            (StructureNode)m_data3D->get(m_currentScan), m_fieldMap,
+            ChunkSize));
     }
     catch (E57Exception& e)
     {
@@ -267,29 +278,32 @@ void E57Reader::setupReader()
     }
 }
 
-/// Read the next batch of m_defaultChunkSize.
+/// Read and convert the next batch of points.
 /// This returns number of points aquired.
 /// Returns 0 after finished reading of all scans.
 point_count_t E57Reader::readNextBatch()
 {
     m_currentIndex = 0;
 
-    // Are we done with reading all scans?
-    if (m_currentScan >= m_data3D->childCount())
-        return 0;
-
-    point_count_t gotPoints = m_reader->read(m_destBuffers);
-
-    if (!gotPoints)
+    while (m_scanReader)
     {
+        point_count_t gotPoints;
+        try
+        {
+            gotPoints = m_scanReader->read();
+        }
+        catch (E57Exception& e)
+        {
+            throwError(std::to_string(e.errorCode()) + " : " + e.context());
+        }
+        if (gotPoints)
+            return gotPoints;
+
         // Finished reading all points in current scan.
         // Its time to setup reader at next scan.
-        m_reader->close();
         setupReader();
-        return readNextBatch();
     }
-
-    return gotPoints;
+    return 0;
 }
 
 /// Fill the point information.
@@ -308,38 +322,8 @@ bool E57Reader::fillPoint(PointRef& point)
         return false;
     }
 
-    for (auto& keyValue : m_doubleBuffers)
-    {
-        auto dim = e57plugin::e57ToPdal(keyValue.first);
-
-        if (dim != Dimension::Id::Unknown)
-        {
-            point.setField(dim, m_scan->rescale(dim, keyValue.second[m_currentIndex]));
-        }
-        else
-        {
-            auto dim = m_extraDims->findDim(keyValue.first);
-            if (dim != m_extraDims->end())
-            {
-                point.setField(dim->m_id, keyValue.second[m_currentIndex]);
-            }
-        }
-    }
-
-    if (point.hasDim(Dimension::Id::SphericalRange) &&
-        point.hasDim(Dimension::Id::SphericalAzimuth) &&
-        point.hasDim(Dimension::Id::SphericalElevation))
-    {
-        const double range = point.getFieldAs<double>(Dimension::Id::SphericalRange);
-        const double azimuth = point.getFieldAs<double>(Dimension::Id::SphericalAzimuth);
-        const double elevation = point.getFieldAs<double>(Dimension::Id::SphericalElevation);
-        point.setField(Dimension::Id::X, range * std::cos(elevation) * std::cos(azimuth));
-        point.setField(Dimension::Id::Y, range * std::cos(elevation) * std::sin(azimuth));
-        point.setField(Dimension::Id::Z, range * std::sin(elevation));
-    }
-
-    if (m_scan->hasPose())
-        m_scan->transformPoint(point);
+    for (const ScanReader::Field& f : m_scanReader->fields())
+        point.setField(f.m_id, f.m_values[m_currentIndex]);
 
     ++m_currentIndex;
     return true;
@@ -347,16 +331,109 @@ bool E57Reader::fillPoint(PointRef& point)
 
 point_count_t E57Reader::read(PointViewPtr view, point_count_t count)
 {
-    point_count_t numPoints = e57plugin::numPoints(*m_data3D);
-    PointRef point(*view);
-    for (PointId counter = 0, nextId = view->size(); counter < numPoints;
-            ++counter, ++nextId)
+    if (m_threads > 1 && m_data3D->childCount() > 1)
+        return readParallel(*view, count);
+
+    PointId idx = view->size();
+    point_count_t numRead = 0;
+    while (numRead < count)
     {
-        point.setPointId(nextId);
-        fillPoint(point);
+        if (m_currentIndex >= m_pointsInCurrentBatch)
+            m_pointsInCurrentBatch = readNextBatch();
+        if (!m_pointsInCurrentBatch)
+            break;
+
+        const point_count_t size = (std::min)(count - numRead,
+            m_pointsInCurrentBatch - m_currentIndex);
+        insert(*view, idx, m_scanReader->fields(), m_currentIndex, size);
+        idx += size;
+        numRead += size;
+        m_currentIndex += size;
     }
+    return numRead;
+}
+
+/// Decode a window of scans in parallel, each from its own handle on the
+/// file, and insert them into the view in scan order.
+point_count_t E57Reader::readParallel(PointView& view, point_count_t count)
+{
+    struct DecodedScan
+    {
+        std::vector<ScanReader::Field> m_fields;
+        point_count_t m_count;
+        std::string m_error;
+    };
+
+    const int numScans = m_data3D->childCount();
+    const std::string path = m_localHandle->localPath();
+    const int window = (std::min)(m_threads, numScans);
+    std::vector<DecodedScan> decoded(window);
+
+    ThreadPool pool(window);
+    PointId idx = view.size();
+    point_count_t numRead = 0;
+    for (int first = 0; first < numScans && numRead < count; first += window)
+    {
+        const int last = (std::min)(first + window, numScans);
+        for (int scan = first; scan < last; ++scan)
+        {
+            DecodedScan& d = decoded[scan - first];
+            pool.add([this, &d, &path, scan]()
+            {
+                d.m_fields.clear();
+                d.m_count = 0;
+                try
+                {
+                    std::unique_ptr<ImageFile> imf = openFile(path);
+                    VectorNode data3D(imf->root().get("/data3D"));
+                    {
+                        ScanReader reader(*imf,
+                            (StructureNode)data3D.get(scan), m_fieldMap,
+                            ChunkSize);
+                        for (const ScanReader::Field& f : reader.fields())
+                            d.m_fields.push_back({ f.m_id, {} });
+                        while (point_count_t n = reader.read())
+                        {
+                            for (size_t i = 0; i < d.m_fields.size(); ++i)
+                            {
+                                const std::vector<double>& v =
+                                    reader.fields()[i].m_values;
+                                d.m_fields[i].m_values.insert(
+                                    d.m_fields[i].m_values.end(),
+                                    v.begin(), v.begin() + n);
+                            }
+                            d.m_count += n;
+                        }
+                    }
+                    imf->close();
+                }
+                catch (E57Exception& e)
+                {
+                    d.m_error = std::to_string(e.errorCode()) + " : " +
+                        e.context();
+                }
+                catch (std::exception& e)
+                {
+                    d.m_error = e.what();
+                }
+            });
+        }
+        pool.await();
 
-    return view->size();
+        for (int scan = first; scan < last && numRead < count; ++scan)
+        {
+            DecodedScan& d = decoded[scan - first];
+            if (d.m_error.size())
+                throwError(d.m_error);
+
+            const point_count_t size = (std::min)(count - numRead, d.m_count);
+            insert(view, idx, d.m_fields, 0, size);
+            idx += size;
+            numRead += size;
+            d.m_fields.clear();
+        }
+    }
+    return numRead;
 }
 
 bool E57Reader::processOne(PointRef& point)
@@ -366,6 +443,7 @@ bool E57Reader::processOne(PointRef& point)
 
 void E57Reader::done(PointTableRef table)
 {
+    m_scanReader.reset();
     m_imf->close();
 }
 
@@ -41,10 +41,16 @@
 
 namespace pdal
 {
+namespace arbiter
+{
+class LocalHandle;
+}
+
 class PDAL_EXPORT E57Reader : public Reader, public Streamable
 {
 public:
     E57Reader();
+    ~E57Reader();
     std::string getName() const override;
 
 private:
@@ -62,21 +68,19 @@ private:
     bool fillPoint(PointRef& point);
     point_count_t readNextBatch();
     void setupReader();
-    void initializeBuffers();
+    point_count_t readParallel(PointView& view, point_count_t count);
+    std::unique_ptr<e57::ImageFile> openFile(const std::string& path) const;
 
+    std::unique_ptr<arbiter::LocalHandle> m_localHandle;
     std::unique_ptr<e57::ImageFile> m_imf;
     std::unique_ptr<e57::VectorNode> m_data3D;
-    std::unique_ptr<e57::CompressedVectorReader> m_reader;
-    std::unique_ptr<e57::StructureNode> m_e57PointPrototype;
-    std::shared_ptr<e57::Scan> m_scan;
-
-    std::map<std::string, std::vector<double>> m_doubleBuffers;
-    std::vector<e57::SourceDestBuffer> m_destBuffers;
+    std::unique_ptr<e57::ScanReader> m_scanReader;
+    e57::ScanReader::FieldMap m_fieldMap;
 
     point_count_t m_currentIndex;
     point_count_t m_pointsInCurrentBatch;
-    point_count_t m_defaultChunkSize;
     signed int m_currentScan;
+    int m_threads;
 
     pdal::StringList m_extraDimsSpec;
     std::unique_ptr<e57plugin::ExtraDims> m_extraDims;
@@ -32,6 +32,8 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <cmath>
+
 #include "Scan.hpp"
 #include "Utils.hpp"
 
@@ -76,6 +78,21 @@ void Scan::transformPoint(pdal::PointRef& pt) const
     pt.setField(pdal::Dimension::Id::Z,  x*m_rotation[2][0] + y*m_rotation[2][1] + z*m_rotation[2][2]  + m_translation[2]);
 }
 
+void Scan::transformPoints(double *x, double *y, double *z, size_t count) const
+{
+    const double (&r)[3][3] = m_rotation;
+    const double (&t)[3] = m_translation;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const double px = x[i];
+        const double py = y[i];
+        const double pz = z[i];
+        x[i] = px * r[0][0] + py * r[0][1] + pz * r[0][2] + t[0];
+        y[i] = px * r[1][0] + py * r[1][1] + pz * r[1][2] + t[1];
+        z[i] = px * r[2][0] + py * r[2][1] + pz * r[2][2] + t[2];
+    }
+}
+
 std::array<double,3>
 Scan::transformPoint(const std::array<double,3> &originalPoint) const
 {
@@ -237,4 +254,135 @@ StructureNode Scan::getPointPrototype()
 {
     return StructureNode(getPoints().prototype());
 }
+
+ScanReader::ScanReader(e57::ImageFile& imf, const e57::StructureNode& scanNode,
+        const FieldMap& fieldMap, size_t chunkSize) :
+    m_scan(scanNode), m_chunkSize(chunkSize)
+{
+    StructureNode prototype(m_scan.getPointPrototype());
+
+    // Fields are kept in the order of the map so that when two E57 fields
+    // map to the same dimension, the later one wins.
+    std::vector<std::string> names;
+    for (auto& f : fieldMap)
+    {
+        if (!prototype.isDefined(f.first))
+            continue;
+        names.push_back(f.first);
+        addField(f.second);
+    }
+
+    m_x = m_y = m_z = m_range = m_azimuth = m_elevation = -1;
+    for (size_t i = 0; i < m_fields.size(); ++i)
+    {
+        switch (m_fields[i].m_id)
+        {
+        case pdal::Dimension::Id::X:
+            m_x = (int)i;
+            break;
+        case pdal::Dimension::Id::Y:
+            m_y = (int)i;
+            break;
+        case pdal::Dimension::Id::Z:
+            m_z = (int)i;
+            break;
+        case pdal::Dimension::Id::SphericalRange:
+            m_range = (int)i;
+            break;
+        case pdal::Dimension::Id::SphericalAzimuth:
+            m_azimuth = (int)i;
+            break;
+        case pdal::Dimension::Id::SphericalElevation:
+            m_elevation = (int)i;
+            break;
+        default:
+            break;
+        }
+    }
+
+    // Link the read fields to destination buffers before any fields are
+    // added for computed coordinates.
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        m_destBuffers.emplace_back(imf, names[i], m_fields[i].m_values.data(),
+            m_chunkSize, true,
+            (prototype.get(names[i]).type() == e57::E57_SCALED_INTEGER));
+    }
+
+    // Spherical coordinates are converted to X/Y/Z.
+    if (m_range >= 0 && m_azimuth >= 0 && m_elevation >= 0)
+    {
+        if (m_x < 0)
+            m_x = addField(pdal::Dimension::Id::X);
+        if (m_y < 0)
+            m_y = addField(pdal::Dimension::Id::Y);
+        if (m_z < 0)
+            m_z = addField(pdal::Dimension::Id::Z);
+    }
+
+    m_reader.reset(new CompressedVectorReader(
+        m_scan.getPoints().reader(m_destBuffers)));
+}
+
+ScanReader::~ScanReader()
+{
+    try
+    {
+        m_reader->close();
+    }
+    catch (...)
+    {}
+}
+
+int ScanReader::addField(pdal::Dimension::Id id)
+{
+    m_fields.push_back({ id, std::vector<double>(m_chunkSize, 0) });
+    // Only standard dimensions have rescale factors.
+    m_scales.push_back((int)id < pdal::Dimension::COUNT ?
+        m_scan.rescale(id, 1.0) : 1.0);
+    return (int)m_fields.size() - 1;
+}
+
+pdal::point_count_t ScanReader::read()
+{
+    size_t count = m_reader->read(m_destBuffers);
+    convert(count);
+    return count;
+}
+
+void ScanReader::convert(size_t count)
+{
+    for (size_t i = 0; i < m_fields.size(); ++i)
+    {
+        const double scale = m_scales[i];
+        if (scale == 1.0)
+            continue;
+        double *v = m_fields[i].m_values.data();
+        for (size_t j = 0; j < count; ++j)
+            v[j] *= scale;
+    }
+
+    if (m_x < 0 || m_y < 0 || m_z < 0)
+        return;
+
+    double *x = m_fields[m_x].m_values.data();
+    double *y = m_fields[m_y].m_values.data();
+    double *z = m_fields[m_z].m_values.data();
+    if (m_range >= 0 && m_azimuth >= 0 && m_elevation >= 0)
+    {
+        const double *range = m_fields[m_range].m_values.data();
+        const double *azimuth = m_fields[m_azimuth].m_values.data();
+        const double *elevation = m_fields[m_elevation].m_values.data();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const double r = range[i] * std::cos(elevation[i]);
+            x[i] = r * std::cos(azimuth[i]);
+            y[i] = r * std::sin(azimuth[i]);
+            z[i] = range[i] * std::sin(elevation[i]);
+        }
+    }
+
+    if (m_scan.hasPose())
+        m_scan.transformPoints(x, y, z, count);
+}
 }
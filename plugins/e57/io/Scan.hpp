@@ -34,6 +34,10 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include <pdal/pdal_types.hpp>
 #include <pdal/Writer.hpp>
 #include <pdal/Dimension.hpp>
@@ -54,6 +58,8 @@ public:
     e57::CompressedVectorNode getPoints() const;
     bool hasPose() const;
     void transformPoint(pdal::PointRef& pt) const;
+    /// Apply the pose to arrays of coordinates in place.
+    void transformPoints(double *x, double *y, double *z, size_t count) const;
     pdal::BOX3D getBoundingBox() const;
     double rescale(pdal::Dimension::Id dim, double value);
     StructureNode getPointPrototype();
@@ -87,4 +93,52 @@ private:
 
     float m_rescaleFactors[pdal::Dimension::COUNT];
 };
+
+/// Reads the points of a scan in batches. Each batch is converted as a
+/// whole: values are rescaled, spherical coordinates are converted to
+/// Cartesian and the scan pose is applied.
+class PDAL_EXPORT ScanReader
+{
+public:
+    /// A PDAL dimension and its values for the current batch.
+    struct Field
+    {
+        pdal::Dimension::Id m_id;
+        std::vector<double> m_values;
+    };
+    /// E57 field names and the PDAL dimensions they are read into.
+    typedef std::vector<std::pair<std::string, pdal::Dimension::Id>> FieldMap;
+
+    ScanReader(e57::ImageFile& imf, const e57::StructureNode& scanNode,
+        const FieldMap& fieldMap, size_t chunkSize);
+    ~ScanReader();
+
+    /// Read and convert the next batch of points. Returns the number of
+    /// points read, which is 0 once the scan has been read.
+    pdal::point_count_t read();
+    /// Fields of the current batch, in the order they should be set.
+    const std::vector<Field>& fields() const
+        { return m_fields; }
+    const Scan& scan() const
+        { return m_scan; }
+
+private:
+    int addField(pdal::Dimension::Id id);
+    void convert(size_t count);
+
+    Scan m_scan;
+    size_t m_chunkSize;
+    std::vector<Field> m_fields;
+    std::vector<double> m_scales;
+    std::vector<e57::SourceDestBuffer> m_destBuffers;
+    std::unique_ptr<e57::CompressedVectorReader> m_reader;
+
+    // Indices of the coordinate fields, -1 if not present.
+    int m_x;
+    int m_y;
+    int m_z;
+    int m_range;
+    int m_azimuth;
+    int m_elevation;
+};
 }
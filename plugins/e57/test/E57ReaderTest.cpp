@@ -296,3 +296,46 @@ TEST(E57ReaderTest, testScansWithDifferentDimensions)
 
     remove(outfile.c_str());
 }
+
+TEST(E57ReaderTest, testThreads)
+{
+    auto read = [](const std::string& filename, int threads, PointTableRef table,
+        point_count_t count = 0)
+    {
+        Options ops;
+        ops.add("filename", filename);
+        ops.add("threads", threads);
+        if (count)
+            ops.add("count", count);
+        E57Reader reader;
+        reader.setOptions(ops);
+        reader.prepare(table);
+        return *reader.execute(table).begin();
+    };
+
+    // Scans decoded in parallel match scans decoded one at a time,
+    // including scans with a pose.
+    for (std::string file : { "e57/A_B.e57", "e57/A_moved_B.e57" })
+    {
+        PointTable t1;
+        PointViewPtr v1 = read(Support::datapath(file), 1, t1);
+        PointTable t2;
+        PointViewPtr v2 = read(Support::datapath(file), 4, t2);
+        PointTable t3;
+        PointViewPtr v3 = read(Support::datapath(file), 4, t3, 3);
+
+        ASSERT_EQ(v1->size(), 6u);
+        ASSERT_EQ(v2->size(), 6u);
+        ASSERT_EQ(v3->size(), 3u);
+        for (Dimension::Id dim : t1.layout()->dims())
+        {
+            for (PointId i = 0; i < v1->size(); ++i)
+            {
+                double d = v1->getFieldAs<double>(dim, i);
+                EXPECT_DOUBLE_EQ(d, v2->getFieldAs<double>(dim, i));
+                if (i < v3->size())
+                    EXPECT_DOUBLE_EQ(d, v3->getFieldAs<double>(dim, i));
+            }
+        }
+    }
+}
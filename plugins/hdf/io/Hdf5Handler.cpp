@@ -37,11 +37,23 @@
 #include <pdal/pdal_types.hpp>
 #include <pdal/Dimension.hpp>
 
+#include <numeric>
+
 namespace pdal
 {
 
 using namespace hdf5;
 
+namespace
+{
+
+// Minimum number of values read from each dataset at a time.
+const hsize_t MinBlockSize = 65536;
+// Largest common multiple of the chunk sizes to which blocks are aligned.
+const hsize_t MaxCommonChunkSize = 16 * MinBlockSize;
+
+} // unnamed namespace
+
 void Handler::setLog(pdal::LogPtr log) {
     m_logger = log;
 }
@@ -74,36 +86,56 @@ void Handler::initialize(
             throw pdal_error("All given datasets must have the same length");
         }
     }
+
+    // Read blocks that are a multiple of every dataset's chunk size so that
+    // reads line up with the chunk layout of all the datasets.  If the
+    // chunk sizes have no reasonably small common multiple, line up with
+    // the largest chunks.
+    hsize_t chunkSize = 1;
+    hsize_t maxChunkSize = 1;
+    for (DimInfo& info : m_dimInfos)
+    {
+        if (chunkSize <= MaxCommonChunkSize)
+            chunkSize = std::lcm(chunkSize, info.getChunkSize());
+        maxChunkSize = (std::max)(maxChunkSize, info.getChunkSize());
+    }
+    if (chunkSize > MaxCommonChunkSize)
+        chunkSize = maxChunkSize;
+    m_blockSize = ((MinBlockSize + chunkSize - 1) / chunkSize) * chunkSize;
+    for (DimInfo& info : m_dimInfos)
+        info.setBufferSize(m_blockSize);
 }
 
 
-void Handler::close()
+hsize_t Handler::readBlock(hsize_t start)
 {
-    m_h5File->close();
+    if (start >= m_numPoints)
+        return 0;
+
+    hsize_t count = (std::min)(m_blockSize, m_numPoints - start);
+    for (DimInfo& info : m_dimInfos)
+        info.read(start, count);
+    return count;
 }
 
 
-uint8_t *DimInfo::getValue(pdal::point_count_t pointIndex) {
-    if(pointIndex < chunkLowerBound || pointIndex >= chunkUpperBound) {
-        // load new chunk
-        H5::DataSpace dspace = m_dset.getSpace();
+void Handler::close()
+{
+    m_h5File->close();
+}
 
-        chunkLowerBound = (pointIndex / m_chunkSize) * m_chunkSize;
-        chunkUpperBound =
-            (std::min)(chunkLowerBound + m_chunkSize, m_numPoints);
 
-        hsize_t selectionSize = chunkUpperBound - chunkLowerBound;
+void DimInfo::read(hsize_t start, hsize_t count)
+{
+    H5::DataSpace memspace(1, &count);
+    m_dspace.selectHyperslab(H5S_SELECT_SET, &count, &start);
+    m_dset.read(m_buffer.data(), m_dtype, memspace, m_dspace);
+}
 
-        H5::DataSpace memspace(1, &selectionSize);
-        dspace.selectHyperslab(H5S_SELECT_SET, &selectionSize, &chunkLowerBound);
-        m_dset.read(m_buffer.data(),
-                    m_dset.getDataType(),
-                    memspace,
-                    dspace );
 
-    }
-    hsize_t pointOffsetWithinChunk = pointIndex - chunkLowerBound;
-    return m_buffer.data() + pointOffsetWithinChunk * m_size;
+void DimInfo::setBufferSize(hsize_t count)
+{
+    m_buffer.resize(count * m_size);
 }
 
 
@@ -112,6 +144,12 @@ hsize_t Handler::getNumPoints() const
     return m_numPoints;
 }
 
+
+hsize_t Handler::getBlockSize() const
+{
+    return m_blockSize;
+}
+
 DimInfo::DimInfo(
     const std::string& dimName,
     const std::string& datasetName,
@@ -119,9 +157,11 @@ DimInfo::DimInfo(
     )
     : m_name(dimName)
     , m_dset(file->openDataSet(datasetName))
+    , m_dspace(m_dset.getSpace())
+    , m_dtype(m_dset.getDataType())
     {
         // Will throw if dataset doesn't exists. Gives adequate error message
-        H5::DataSpace dspace = m_dset.getSpace();
+        H5::DataSpace& dspace = m_dspace;
 
         // Sanity check before we cast from signed to unsigned
         if(dspace.getSelectNpoints() < 0)
@@ -136,8 +176,8 @@ DimInfo::DimInfo(
             if(dimensionality != 1)
                 throw pdal_error("Only 1-dimensional arrays are supported.");
         } else {
-            //if dataset is not chunked, use an arbitrary number for buffer size
-            m_chunkSize = 1024; // completely arbitrary number
+            // if dataset is not chunked, any block size will do
+            m_chunkSize = 1;
         }
 
         // populate fields base on HDF type
@@ -161,9 +201,6 @@ DimInfo::DimInfo(
             throw pdal_error("Dataset '" + datasetName + "' has an " +
                 "unsupported type. Only integer and float types are supported.");
         }
-
-        //allocate buffer for getValue() to write into
-        m_buffer.resize(m_chunkSize*m_size);
     }
 
 
@@ -196,5 +233,10 @@ hsize_t DimInfo::getNumPoints() {
     return m_numPoints;
 }
 
+
+hsize_t DimInfo::getChunkSize() {
+    return m_chunkSize;
+}
+
 } // namespace pdal
 
@@ -59,7 +59,12 @@ public:
         const std::string& datasetName,
         H5::H5File *file);
 
-    uint8_t *getValue(pdal::point_count_t pointIndex);
+    // Read 'count' values starting at 'start' into the buffer.
+    void read(hsize_t start, hsize_t count);
+    // Value at 'index' in the buffer.
+    const uint8_t *getValue(hsize_t index) const
+        { return m_buffer.data() + index * m_size; }
+    void setBufferSize(hsize_t count);
     //setters
     void setId(Dimension::Id id);
     //getters
@@ -67,17 +72,18 @@ public:
     Dimension::Type getPdalType();
     std::string getName();
     hsize_t getNumPoints();
+    hsize_t getChunkSize();
 
 private:
     std::vector<uint8_t> m_buffer;
     std::string m_name;
     Dimension::Type m_pdalType;
     Dimension::Id m_pdalId = Dimension::Id::Unknown;
-    hsize_t chunkUpperBound = 0,
-            chunkLowerBound = 0,
-            m_numPoints = 0,
+    hsize_t m_numPoints = 0,
             m_chunkSize;
     H5::DataSet m_dset;
+    H5::DataSpace m_dspace;
+    H5::DataType m_dtype;
     size_t m_size;
 };
 
@@ -90,8 +96,13 @@ public:
     void close();
 
     hsize_t getNumPoints() const;
+    hsize_t getBlockSize() const;
     std::vector<pdal::hdf5::DimInfo>& getDimensions();
 
+    // Read a block of up to getBlockSize() values of every dimension,
+    // starting at 'start'.  Returns the number of values read.
+    hsize_t readBlock(hsize_t start);
+
     void setLog(pdal::LogPtr log);
 
 private:
@@ -101,6 +112,7 @@ private:
 
     std::unique_ptr<H5::H5File> m_h5File;
     hsize_t m_numPoints = 0;
+    hsize_t m_blockSize = 0;
 };
 
 } //namespace hdf5
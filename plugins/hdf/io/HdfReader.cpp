@@ -39,6 +39,7 @@
 #include <pdal/util/ProgramArgs.hpp>
 #include "Hdf5Handler.hpp"
 
+#include <algorithm>
 #include <map>
 
 
@@ -77,38 +78,98 @@ void HdfReader::addDimensions(PointLayoutPtr layout)
 void HdfReader::ready(PointTableRef table)
 {
     m_index = 0;
+    m_blockCount = 0;
+    m_blockPos = 0;
+
+    PointLayoutPtr layout(table.layout());
+    m_packed = true;
+    m_dimTypes.clear();
+    size_t rowSize = 0;
+    for (hdf5::DimInfo& dim : m_hdf5Handler->getDimensions())
+    {
+        m_dimTypes.emplace_back(dim.getId(), dim.getPdalType());
+        rowSize += Dimension::size(dim.getPdalType());
+        if (layout->dimType(dim.getId()) != dim.getPdalType())
+            m_packed = false;
+    }
+    m_row.resize(rowSize);
+}
+
+
+bool HdfReader::nextBlock()
+{
+    m_blockCount = m_hdf5Handler->readBlock(m_index);
+    m_blockPos = 0;
+    m_index += m_blockCount;
+    return m_blockCount != 0;
+}
+
+
+// Gather the values of the current point into a packed row.
+const char *HdfReader::packRow()
+{
+    char *pos = m_row.data();
+    for (hdf5::DimInfo& dim : m_hdf5Handler->getDimensions())
+    {
+        size_t size = Dimension::size(dim.getPdalType());
+        std::copy_n(dim.getValue(m_blockPos), size, pos);
+        pos += size;
+    }
+    return m_row.data();
 }
 
 
 point_count_t HdfReader::read(PointViewPtr view, point_count_t count)
 {
-    PointId startId = view->size();
-    point_count_t remaining = m_hdf5Handler->getNumPoints() - m_index;
-    count = (std::min)(count, remaining);
-    PointId nextId = startId;
-
-    for(uint64_t pi = 0; pi < m_hdf5Handler->getNumPoints(); pi++) {
-        for(hdf5::DimInfo& dim : m_hdf5Handler->getDimensions()) {
-            uint8_t *p = dim.getValue(pi);
-            view->setField(dim.getId(), dim.getPdalType(), nextId, (void*) p);
+    std::vector<hdf5::DimInfo>& dims = m_hdf5Handler->getDimensions();
+    PointId firstId = view->size();
+    point_count_t cnt = 0;
+
+    while (cnt < count)
+    {
+        if (m_blockPos == m_blockCount && !nextBlock())
+            break;
+
+        // Copy the block one dimension at a time, so that each dataset
+        // buffer is read sequentially.  The first dimension adds the points
+        // to the view.
+        point_count_t n = (std::min)(m_blockCount - m_blockPos, count - cnt);
+        PointId nextId = firstId + cnt;
+        for (size_t d = 0; d < dims.size(); ++d)
+        {
+            hdf5::DimInfo& dim = dims[d];
+            if (view->layout()->dimType(dim.getId()) == dim.getPdalType())
+            {
+                const DimTypeList column { m_dimTypes[d] };
+                for (point_count_t i = 0; i < n; ++i)
+                    view->setPackedPoint(column, nextId + i,
+                        (const char *)dim.getValue(m_blockPos + i));
+            }
+            else
+                for (point_count_t i = 0; i < n; ++i)
+                    view->setField(dim.getId(), dim.getPdalType(),
+                        nextId + i, dim.getValue(m_blockPos + i));
         }
-        m_index++;
-        nextId++;
+        m_blockPos += n;
+        cnt += n;
     }
-
-    return count;
+    return cnt;
 }
 
 
 bool HdfReader::processOne(PointRef& point)
 {
-    for(hdf5::DimInfo& dim : m_hdf5Handler-> getDimensions()) {
-        uint8_t *p = dim.getValue(m_index);
-        point.setField(dim.getId(), dim.getPdalType(), p);
-    }
-
-    m_index++;
-    return m_index <= m_hdf5Handler->getNumPoints();
+    if (m_blockPos == m_blockCount && !nextBlock())
+        return false;
+
+    if (m_packed)
+        point.setPackedData(m_dimTypes, packRow());
+    else
+        for (hdf5::DimInfo& dim : m_hdf5Handler->getDimensions())
+            point.setField(dim.getId(), dim.getPdalType(),
+                dim.getValue(m_blockPos));
+    m_blockPos++;
+    return true;
 }
 
 void HdfReader::addArgs(ProgramArgs& args)
@@ -63,6 +63,17 @@ private:
     std::unique_ptr<hdf5::Handler> m_hdf5Handler;
     point_count_t m_index;
 
+    // Values are read from the datasets in blocks.  m_blockPos is the
+    // position of the next point in the current block.
+    point_count_t m_blockCount;
+    point_count_t m_blockPos;
+
+    // When the dimension types in the layout match the dataset types,
+    // streamed points are copied as packed rows.
+    bool m_packed;
+    DimTypeList m_dimTypes;
+    std::vector<char> m_row;
+
     virtual void addDimensions(PointLayoutPtr layout) override;
     virtual void addArgs(ProgramArgs& args) override;
     virtual void initialize() override;
@@ -75,6 +86,8 @@ private:
     std::map<std::string,std::string> m_pathDimMap;
     Dimension::IdList m_idlist;
     void parseDimensions();
+    bool nextBlock();
+    const char *packRow();
 
     HdfReader& operator=(const HdfReader&);   // Not implemented.
     HdfReader(const HdfReader&);              // Not implemented.
@@ -40,6 +40,7 @@
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
 #include <nlohmann/json.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
@@ -115,3 +116,67 @@ TEST(HdfReaderTest, testOptions)
     ASSERT_THROW(reader->prepare(table), pdal_error);
     ASSERT_TRUE(reader->getSpatialReference().empty());
 }
+
+TEST(HdfReaderTest, testCount)
+{
+    StageFactory f;
+    Stage* reader(f.createStage("readers.hdf"));
+
+    NL::json j = {{"X", "autzen/X"}, {"Y", "autzen/Y"}, {"Z", "autzen/Z"}};
+    Options options;
+    options.add("filename", getFilePath());
+    options.add("dimensions", j.dump());
+    options.add("count", 500);
+    reader->setOptions(options);
+
+    PointTable table;
+    reader->prepare(table);
+    PointViewSet viewSet = reader->execute(table);
+    PointViewPtr view = *viewSet.begin();
+    EXPECT_EQ(view->size(), 500u);
+    Support::check_p0_p1_p2(*view);
+}
+
+TEST(HdfReaderTest, testStream)
+{
+    StageFactory f;
+    Stage* reader(f.createStage("readers.hdf"));
+
+    NL::json j = {
+        {"X", "autzen/X"},
+        {"Y", "autzen/Y"},
+        {"Z", "autzen/Z"},
+        {"Intensity", "autzen/Intensity"}
+    };
+    Options options;
+    options.add("filename", getFilePath());
+    options.add("dimensions", j.dump());
+    reader->setOptions(options);
+
+    point_count_t count = 0;
+    double sumX = 0;
+    auto cb = [&count, &sumX](PointRef& point)
+    {
+        count++;
+        sumX += point.getFieldAs<double>(Dimension::Id::X);
+        return true;
+    };
+    StreamCallbackFilter filter;
+    filter.setCallback(cb);
+    filter.setInput(*reader);
+
+    FixedPointTable table(100);
+    filter.prepare(table);
+    filter.execute(table);
+    EXPECT_EQ(count, 1065u);
+
+    PointTable t2;
+    Stage* reader2(f.createStage("readers.hdf"));
+    reader2->setOptions(options);
+    reader2->prepare(t2);
+    PointViewPtr view = *reader2->execute(t2).begin();
+    double expected = 0;
+    for (PointId i = 0; i < view->size(); ++i)
+        expected += view->getFieldAs<double>(Dimension::Id::X, i);
+    EXPECT_DOUBLE_EQ(sumX, expected);
+}
@@ -163,6 +163,9 @@ protected:
         return s;
     }
 
+    virtual uint64_t dataOffset() const
+        { return m_offset; }
+
 private:
     uint64_t m_offset;
     uint64_t m_length;
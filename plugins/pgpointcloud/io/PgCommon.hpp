@@ -96,6 +96,43 @@ inline void pg_execute(PGconn* session, std::string const& sql)
     PQclear(result);
 }
 
+// Start a COPY ... FROM STDIN command.
+inline void pg_copy_start(PGconn* session, std::string const& sql)
+{
+    PGresult *result = PQexec(session, sql.c_str());
+    if ( (!result) || (PQresultStatus(result) != PGRES_COPY_IN) )
+    {
+        std::string errmsg = std::string(PQerrorMessage(session));
+        if( result )
+            PQclear(result);
+        throw pdal_error(errmsg);
+    }
+    PQclear(result);
+}
+
+inline void pg_copy_put(PGconn* session, const char *data, size_t size)
+{
+    if (PQputCopyData(session, data, static_cast<int>(size)) != 1)
+        throw pdal_error(PQerrorMessage(session));
+}
+
+// End a COPY command and check that the server accepted the data.
+inline void pg_copy_end(PGconn* session)
+{
+    if (PQputCopyEnd(session, NULL) != 1)
+        throw pdal_error(PQerrorMessage(session));
+
+    std::string errmsg;
+    while (PGresult *result = PQgetResult(session))
+    {
+        if (PQresultStatus(result) != PGRES_COMMAND_OK && errmsg.empty())
+            errmsg = std::string(PQresultErrorMessage(result));
+        PQclear(result);
+    }
+    if (errmsg.size())
+        throw pdal_error(errmsg);
+}
+
 inline void pg_begin(PGconn* session)
 {
     std::string sql = "BEGIN";
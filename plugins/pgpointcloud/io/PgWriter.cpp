@@ -35,6 +35,11 @@
 
 #include "PgWriter.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
 #include <pdal/PointView.hpp>
 #include <pdal/XMLSchema.hpp>
 #include <pdal/util/FileUtils.hpp>
@@ -56,8 +61,6 @@ CREATE_SHARED_STAGE(PgWriter, s_info)
 std::string PgWriter::getName() const { return s_info.name; }
 
 // TO DO:
-// - change INSERT into COPY
-//
 // - PCID / Schema consistency. If a PCID is specified,
 // must it be consistent with the buffer schema? Or should
 // the writer shove the data into the database schema as best
@@ -67,18 +70,147 @@ std::string PgWriter::getName() const { return s_info.name; }
 // table information about each load? If so, how to distinguish
 // between loads? Leave to pre/post SQL?
 
+// Uploads patches on a number of connections.  Each connection streams the
+// patches it takes from a bounded queue with COPY in its own transaction,
+// which is committed by finish().  If any COPY fails, every transaction is
+// rolled back when the uploader is destroyed, so nothing is committed.
+// Only a failure of the final commits themselves can leave some of the
+// patches loaded.
+class PgWriter::Uploader
+{
+public:
+    Uploader(std::string const& connection, std::string const& copy,
+            int connections) :
+        m_maxQueued(2 * connections), m_done(false)
+    {
+        try
+        {
+            for (int i = 0; i < connections; ++i)
+            {
+                m_sessions.push_back(pg_connect(connection));
+                pg_begin(m_sessions.back());
+                pg_copy_start(m_sessions.back(), copy);
+            }
+        }
+        catch (...)
+        {
+            close();
+            throw;
+        }
+        for (PGconn *session : m_sessions)
+            m_threads.emplace_back([this, session](){ run(session); });
+    }
+
+    ~Uploader()
+    {
+        stop();
+        close();
+    }
+
+    // Queue a patch for upload, waiting if the queue is full.
+    void add(std::string&& patch)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_spaceAvailable.wait(lock, [this]()
+            { return m_queue.size() < m_maxQueued || m_error.size(); });
+        if (m_error.size())
+            throw pdal_error(m_error);
+        m_queue.push_back(std::move(patch));
+        m_patchAvailable.notify_one();
+    }
+
+    // Upload any remaining patches and commit.  Every COPY is ended, which
+    // reports any error from the server, before any transaction is
+    // committed.
+    void finish()
+    {
+        stop();
+        if (m_error.size())
+            throw pdal_error(m_error);
+        for (PGconn *session : m_sessions)
+            pg_copy_end(session);
+        for (PGconn *session : m_sessions)
+            pg_commit(session);
+    }
+
+private:
+    void run(PGconn *session)
+    {
+        while (true)
+        {
+            std::string patch;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_patchAvailable.wait(lock, [this]()
+                    { return m_queue.size() || m_done || m_error.size(); });
+                if (m_queue.empty() || m_error.size())
+                    return;
+                patch = std::move(m_queue.front());
+                m_queue.pop_front();
+                m_spaceAvailable.notify_one();
+            }
+            try
+            {
+                pg_copy_put(session, patch.data(), patch.size());
+            }
+            catch (pdal_error& err)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_error = err.what();
+                m_patchAvailable.notify_all();
+                m_spaceAvailable.notify_all();
+                return;
+            }
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+        }
+        m_patchAvailable.notify_all();
+        for (std::thread& t : m_threads)
+            t.join();
+        m_threads.clear();
+    }
+
+    // Closing a connection without committing rolls back its transaction.
+    void close()
+    {
+        for (PGconn *session : m_sessions)
+            PQfinish(session);
+        m_sessions.clear();
+    }
+
+    std::vector<PGconn *> m_sessions;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_patchAvailable;
+    std::condition_variable m_spaceAvailable;
+    std::deque<std::string> m_queue;
+    size_t m_maxQueued;
+    bool m_done;
+    std::string m_error;
+};
+
+
 PgWriter::PgWriter()
     : m_session(0)
     , m_patch_compression_type(CompressionType::None)
     , m_srid(0)
     , m_pcid(0)
     , m_overwrite(true)
+    , m_connections(1)
+    , m_createIndex(false)
     , m_schema_is_initialized(false)
 {}
 
 
 PgWriter::~PgWriter()
 {
+    m_uploader.reset();
     if (m_session)
         PQfinish(m_session);
 }
@@ -98,11 +230,17 @@ void PgWriter::addArgs(ProgramArgs& args)
     args.add("pcid", "PCID", m_pcid);
     args.add("pre_sql", "SQL to execute before query", m_pre_sql);
     args.add("post_sql", "SQL to execute after query", m_post_sql);
+    args.add("connections", "Number of connections used to upload patches",
+        m_connections, 1);
+    args.add("create_index", "Create a spatial index on the patches after "
+        "loading", m_createIndex, false);
 }
 
 
 void PgWriter::initialize()
 {
+    if (m_connections < 1)
+        throwError("Option 'connections' must be at least 1.");
     m_patch_compression_type = getCompressionType(m_compressionSpec);
     m_session = pg_connect(m_connection);
 }
@@ -149,9 +287,35 @@ void PgWriter::writeInit()
         CreateTable(m_schema_name, m_table_name, m_column_name, m_pcid);
     }
 
+    // With a single connection everything happens in one transaction.
+    // Otherwise the table must be committed before the other connections
+    // can load into it.
+    if (m_connections == 1)
+        pg_copy_start(m_session, CopyStatement());
+    else
+    {
+        pg_commit(m_session);
+        m_uploader.reset(new Uploader(m_connection, CopyStatement(),
+            m_connections));
+        pg_begin(m_session);
+    }
+
     m_schema_is_initialized = true;
 }
 
+
+// pcpatch has no binary input function, so patches are sent as hex-encoded
+// WKB, one per line.
+std::string PgWriter::CopyStatement() const
+{
+    std::string sql("COPY ");
+    if (m_schema_name.size())
+        sql += pg_quote_identifier(m_schema_name) + ".";
+    sql += pg_quote_identifier(m_table_name) + " (" +
+        pg_quote_identifier(m_column_name) + ") FROM STDIN";
+    return sql;
+}
+
 void PgWriter::write(const PointViewPtr view)
 {
     writeInit();
@@ -161,7 +325,34 @@ void PgWriter::write(const PointViewPtr view)
 
 void PgWriter::done(PointTableRef /*table*/)
 {
-    //CreateIndex(m_schema_name, m_table_name, m_column_name);
+    if (m_schema_is_initialized)
+    {
+        try
+        {
+            if (m_uploader)
+                m_uploader->finish();
+            else
+                pg_copy_end(m_session);
+        }
+        catch (pdal_error& err)
+        {
+            // Roll back the uploads on all connections.
+            m_uploader.reset();
+            throwError(err.what());
+        }
+        m_uploader.reset();
+
+        // Indexing after the load is much faster than maintaining the
+        // index while loading.
+        if (m_createIndex)
+        {
+            if (CheckPointCloudPostGISExists())
+                CreateIndex(m_schema_name, m_table_name, m_column_name);
+            else
+                log()->get(LogLevel::Debug) << "pointcloud_postgis "
+                    "extension not found. Not creating index." << std::endl;
+        }
+    }
 
     if (m_post_sql.size())
     {
@@ -355,6 +546,17 @@ bool PgWriter::CheckPostGISExists()
 }
 
 
+bool PgWriter::CheckPointCloudPostGISExists()
+{
+    log()->get(LogLevel::Debug) << "checking for pointcloud_postgis "
+        "existence ... " << std::endl;
+
+    std::string count_str = pg_query_once(m_session, "SELECT count(*) "
+        "FROM pg_extension WHERE extname = 'pointcloud_postgis'");
+    return atoi(count_str.c_str()) > 0;
+}
+
+
 bool PgWriter::CheckTableExists(std::string const& name)
 {
     std::ostringstream oss;
@@ -396,17 +598,20 @@ void PgWriter::CreateTable(std::string const& schema_name,
 }
 
 
-// Make sure you test for the presence of PostGIS before calling this
+// Make sure you test for the presence of pointcloud_postgis before calling
+// this
 void PgWriter::CreateIndex(std::string const& schema_name,
     std::string const& table_name, std::string const& column_name)
 {
     std::ostringstream oss;
 
-    oss << "CREATE INDEX ";
+    oss << "CREATE INDEX IF NOT EXISTS " <<
+        pg_quote_identifier(table_name + "_pc_gix") << " ON ";
     if (schema_name.size())
-        oss << schema_name << "_";
-    oss << table_name << "_pc_gix";
-    oss << " USING GIST (Geometry(" << column_name << "))";
+        oss << pg_quote_identifier(schema_name) << ".";
+    oss << pg_quote_identifier(table_name);
+    oss << " USING GIST (PC_EnvelopeGeometry(" <<
+        pg_quote_identifier(column_name) << "))";
 
     pg_execute(m_session, oss.str());
 }
@@ -414,71 +619,56 @@ void PgWriter::CreateIndex(std::string const& schema_name,
 
 void PgWriter::writeTile(const PointViewPtr view)
 {
-    std::vector<char> storage(packedPointSize());
-    std::string hexrep;
-    size_t maxHexrepSize = packedPointSize() * view->size() * 2;
-    hexrep.reserve(maxHexrepSize);
-
-    m_insert.clear();
-    m_insert.reserve(maxHexrepSize + 3000);
-
-    for (PointId idx = 0; idx < view->size(); ++idx)
+    static const char syms[] = "0123456789ABCDEF";
+    auto appendHex = [this](const char *data, size_t size)
     {
-        size_t size = readPoint(*view.get(), idx, storage.data());
-
-        /* We are always getting uncompressed bytes off the block_data */
-        /* so we always used compression type 0 (uncompressed) in writing */
-        /* our WKB */
-        static char syms[] = "0123456789ABCDEF";
         for (size_t i = 0; i != size; i++)
         {
-            hexrep.push_back(syms[((storage[i] >> 4) & 0xf)]);
-            hexrep.push_back(syms[storage[i] & 0xf]);
+            m_patch.push_back(syms[(data[i] >> 4) & 0xf]);
+            m_patch.push_back(syms[data[i] & 0xf]);
         }
-    }
-
-    std::string insert_into("INSERT INTO ");
-    std::string values(" (" + pg_quote_identifier(m_column_name) +
-                       ") VALUES ('");
-
-    m_insert.append(insert_into);
-
-    if (m_schema_name.size())
-    {
-        m_insert.append(pg_quote_identifier(m_schema_name));
-        m_insert.append(".");
-    }
-
-    m_insert.append(pg_quote_identifier(m_table_name));
-    m_insert.append(values);
-
-    std::ostringstream options;
+    };
 
     if (view->size() > (std::numeric_limits<uint32_t>::max)())
         throwError("Too many points for tile.");
-    uint32_t num_points = htobe32(static_cast<uint32_t>(view->size()));
-    int32_t pcid = htobe32(m_pcid);
-    CompressionType compression_v = CompressionType::None;
-    uint32_t compression = htobe32(static_cast<uint32_t>(compression_v));
 
+    m_patch.clear();
+    m_patch.reserve(packedPointSize() * view->size() * 2 + 32);
+
+    // WKB header: byte order, pcid, compression and point count, all in
+    // native byte order.  We are always writing uncompressed points, so we
+    // always use compression type 0 (uncompressed).  The server compresses
+    // patches as specified by the schema.
 #if BYTE_ORDER == LITTLE_ENDIAN
-    options << "01";
+    const char endian = 1;
 #elif BYTE_ORDER == BIG_ENDIAN
-    options << "00";
+    const char endian = 0;
 #endif
+    uint32_t header[3] = { m_pcid,
+        static_cast<uint32_t>(CompressionType::None),
+        static_cast<uint32_t>(view->size()) };
+    appendHex(&endian, 1);
+    appendHex(reinterpret_cast<const char *>(header), sizeof(header));
 
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << pcid;
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << compression;
-    // needs to be 4 bytes
-    options << std::hex << std::setfill('0') << std::setw(8) << num_points;
-
-    m_insert.append(options.str());
-    m_insert.append(hexrep);
-    m_insert.append("')");
+    std::vector<char> storage(packedPointSize());
+    for (PointId idx = 0; idx < view->size(); ++idx)
+    {
+        size_t size = readPoint(*view.get(), idx, storage.data());
+        appendHex(storage.data(), size);
+    }
+    m_patch.push_back('\n');
 
-    pg_execute(m_session, m_insert);
+    try
+    {
+        if (m_uploader)
+            m_uploader->add(std::move(m_patch));
+        else
+            pg_copy_put(m_session, m_patch.data(), m_patch.size());
+    }
+    catch (pdal_error& err)
+    {
+        throwError(err.what());
+    }
 }
 
 } // namespace pdal
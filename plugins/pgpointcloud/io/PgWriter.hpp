@@ -35,6 +35,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <pdal/DbWriter.hpp>
 #include <pdal/StageFactory.hpp>
 #include "PgCommon.hpp"
@@ -50,6 +52,8 @@ public:
     std::string getName() const;
 
 private:
+    class Uploader;
+
     PgWriter& operator=(const PgWriter&) = delete;
     PgWriter(const PgWriter&) = delete;
 
@@ -78,7 +82,8 @@ private:
                      std::string const& table_name,
                      std::string const& column_name);
 
-    bool WriteBlock(const PointViewPtr view);
+    bool CheckPointCloudPostGISExists();
+    std::string CopyStatement() const;
 
     PGconn* m_session;
     std::string m_schema_name;
@@ -92,7 +97,10 @@ private:
     uint32_t m_srid;
     uint32_t m_pcid;
     bool m_overwrite;
-    std::string m_insert;
+    int m_connections;
+    bool m_createIndex;
+    std::string m_patch;
+    std::unique_ptr<Uploader> m_uploader;
     Orientation m_orientation;
     std::string m_pre_sql;
     std::string m_post_sql;
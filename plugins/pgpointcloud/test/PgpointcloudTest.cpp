@@ -261,6 +261,47 @@ TEST_F(PgpointcloudWriterTest, writeXYZ)
     EXPECT_TRUE(Utils::contains(dims, Dimension::Id::Z));
 }
 
+TEST_F(PgpointcloudWriterTest, writeConnections)
+{
+    if (shouldSkipTests())
+    {
+        return;
+    }
+
+    StageFactory f;
+    Stage* reader(f.createStage("readers.las"));
+    Options options;
+    options.add("filename", Support::datapath("las/1.2-with-color.las"));
+    reader->setOptions(options);
+
+    Stage* chipper(f.createStage("filters.chipper"));
+    Options chipperOps;
+    chipperOps.add("capacity", 100);
+    chipper->setOptions(chipperOps);
+    chipper->setInput(*reader);
+
+    Stage* writer(f.createStage("writers.pgpointcloud"));
+    Options ops = getDbOptions();
+    ops.add("connections", 3);
+    writer->setOptions(ops);
+    writer->setInput(*chipper);
+
+    PointTable table;
+    writer->prepare(table);
+    writer->execute(table);
+
+    Stage* pgReader(f.createStage("readers.pgpointcloud"));
+    pgReader->setOptions(getDbOptions());
+
+    PointTable readTable;
+    pgReader->prepare(readTable);
+    PointViewSet viewSet = pgReader->execute(readTable);
+    point_count_t count(0);
+    for (auto& v : viewSet)
+        count += v->size();
+    EXPECT_EQ(count, 1065U);
+}
+
 TEST_F(PgpointcloudWriterTest, writetNoPointcloudExtension)
 {
     if (shouldSkipTests())
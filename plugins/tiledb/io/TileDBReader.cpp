@@ -72,7 +72,10 @@ std::string TileDBReader::getName() const
     return s_info.name;
 }
 
-TileDBReader::TileDBReader() : m_args(new TileDBReader::Args) {}
+TileDBReader::TileDBReader()
+    : m_args(new TileDBReader::Args), m_submitted(false)
+{
+}
 
 TileDBReader::~TileDBReader() {}
 
@@ -270,10 +273,14 @@ void TileDBReader::localReady()
     m_query.reset(new tiledb::Query(*m_ctx, *m_array));
     m_query->set_layout(TILEDB_UNORDERED);
 
+    // Results are double-buffered so that the next chunk can be read while
+    // the current one is copied to points.
+    m_nextDims.clear();
     for (auto& buffer : m_dims)
     {
         buffer->resizeBuffer(m_args->m_chunkSize);
-        buffer->setQueryBuffer(*m_query.get());
+        m_nextDims.push_back(buffer->clone());
+        m_nextDims.back()->resizeBuffer(m_args->m_chunkSize);
     }
 
     // Set the subarray to query. The default for each dimension is to query
@@ -328,7 +335,67 @@ void TileDBReader::localReady()
     // initialize read buffer variables
     m_offset = 0;
     m_resultSize = 0;
-    m_complete = false;
+    m_error.clear();
+    if (!m_pool)
+        m_pool.reset(new ThreadPool(1));
+
+    submit();
+}
+
+// Start reading the next chunk of results into the spare buffers.
+void TileDBReader::submit()
+{
+    for (auto& buffer : m_nextDims)
+        buffer->setQueryBuffer(*m_query);
+
+    m_submitted = true;
+    m_pool->add(
+        [this]()
+        {
+            try
+            {
+                m_query->submit();
+
+                if (m_args->m_stats)
+                {
+                    tiledb::Stats::dump(stdout);
+                    tiledb::Stats::reset();
+                }
+
+                m_status = m_query->query_status();
+
+                // Get the number of elements read from the `X` dimension.
+                m_nextSize = m_query->result_buffer_elements()["X"].second;
+            }
+            catch (const tiledb::TileDBError& err)
+            {
+                m_error = err.what();
+            }
+        });
+}
+
+// Wait for the submitted chunk, make its buffers current and start reading
+// the chunk after it.  Returns false when there are no more results.
+bool TileDBReader::nextChunk()
+{
+    if (!m_submitted)
+        return false;
+
+    m_pool->await();
+    m_submitted = false;
+    if (m_error.size())
+        throwError("TileDB Error: " + m_error);
+
+    if (m_status == tiledb::Query::Status::INCOMPLETE && m_nextSize == 0)
+        throwError("Need to increase chunk_size for reader.");
+
+    std::swap(m_dims, m_nextDims);
+    m_resultSize = m_nextSize;
+    m_offset = 0;
+
+    if (m_status == tiledb::Query::Status::INCOMPLETE)
+        submit();
+    return m_resultSize > 0;
 }
 
 bool TileDBReader::processOne(PointRef& point)
@@ -346,66 +413,55 @@ bool TileDBReader::processOne(PointRef& point)
 
 bool TileDBReader::processPoint(PointRef& point)
 {
-    if (m_offset == m_resultSize)
-    {
-        if (m_complete)
-        {
-            return false;
-        }
-        else
-        {
-            tiledb::Query::Status status;
-
-            m_query->submit();
-
-            if (m_args->m_stats)
-            {
-                tiledb::Stats::dump(stdout);
-                tiledb::Stats::reset();
-            }
+    if (m_offset == m_resultSize && !nextChunk())
+        return false;
 
-            status = m_query->query_status();
-
-            // Get the number of elements read from the `X` dimension.
-            m_resultSize = (int)m_query->result_buffer_elements()["X"].second;
-
-            if (status == tiledb::Query::Status::INCOMPLETE &&
-                m_resultSize == 0)
-                throwError("Need to increase chunk_size for reader.");
-
-            if (status == tiledb::Query::Status::COMPLETE)
-                m_complete = true;
+    // Get the values read at m_offset and use to set the PDAL point values.
+    for (auto& buffer : m_dims)
+        buffer->copyDataToPoint(point, m_offset);
+    ++m_offset;
+    return true;
+}
 
-            m_offset = 0;
-        }
+point_count_t TileDBReader::read(PointViewPtr view, point_count_t count)
+{
+    try
+    {
+        return readPoints(*view, count);
     }
-
-    if (m_resultSize > 0)
+    catch (const tiledb::TileDBError& err)
     {
-        // Get the values read at m_offset and use to set the PDAL point values.
-        for (auto& buffer : m_dims)
-            buffer->copyDataToPoint(point, m_offset);
-        ++m_offset;
-        return true;
+        throwError(std::string("TileDB Error: ") + err.what());
     }
-    return false;
+    return 0;
 }
 
-point_count_t TileDBReader::read(PointViewPtr view, point_count_t count)
+// Copy results a chunk at a time, one buffer (dimension) after another.
+point_count_t TileDBReader::readPoints(PointView& view, point_count_t count)
 {
-    PointRef point = view->point(0);
-    PointId id;
-    for (id = 0; id < count; ++id)
+    PointId idx = view.size();
+    point_count_t numRead = 0;
+    while (numRead < count)
     {
-        point.setPointId(id);
-        if (!processOne(point))
+        if (m_offset == m_resultSize && !nextChunk())
             break;
+
+        const point_count_t size =
+            (std::min)(count - numRead, m_resultSize - m_offset);
+        for (auto& buffer : m_dims)
+            buffer->copyDataToView(view, idx, m_offset, size);
+        idx += size;
+        m_offset += size;
+        numRead += size;
     }
-    return id;
+    return numRead;
 }
 
 void TileDBReader::done(pdal::BasePointTable& table)
 {
+    // Don't close the array under a running query.
+    m_pool->await();
+    m_submitted = false;
     m_array->close();
 }
 
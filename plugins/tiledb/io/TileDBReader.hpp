@@ -40,6 +40,7 @@
 
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
+#include <pdal/util/ThreadPool.hpp>
 
 #if defined(DELETE)
 #undef DELETE
@@ -74,19 +75,33 @@ private:
                 tiledb_datatype_t typeTileDB, bool required);
     void localReady();
     bool processPoint(PointRef& point);
+    point_count_t readPoints(PointView& view, point_count_t count);
+    void submit();
+    bool nextChunk();
 
     struct Args;
     std::unique_ptr<TileDBReader::Args> m_args;
 
     point_count_t m_offset;
     point_count_t m_resultSize;
-    bool m_complete;
+    // Buffers holding the results being copied to points.
     std::vector<std::unique_ptr<TileDBDimBuffer>> m_dims;
+    // Buffers filled by the query submitted in the background.
+    std::vector<std::unique_ptr<TileDBDimBuffer>> m_nextDims;
 
     std::unique_ptr<tiledb::Context> m_ctx;
     std::unique_ptr<tiledb::Array> m_array;
     std::unique_ptr<tiledb::Query> m_query;
 
+    // State of the background submission, valid once the pool is idle.
+    bool m_submitted;
+    tiledb::Query::Status m_status;
+    point_count_t m_nextSize;
+    std::string m_error;
+    // Declared last so that a running submission is finished before the
+    // query and buffers are destroyed.
+    std::unique_ptr<ThreadPool> m_pool;
+
     TileDBReader(const TileDBReader&) = delete;
     TileDBReader& operator=(const TileDBReader&) = delete;
 };
@@ -576,10 +576,13 @@ void BitFieldsBuffer::copyDataToBuffer(PointRef& point, size_t index)
     m_data[index] = value1 | value2;
 }
 
-void BitFieldsBuffer::copyDataToPoint(PointRef& point, size_t index)
+namespace
+{
+
+// Unpack the bit fields stored in a 2 byte value.
+std::array<uint8_t, 6> unpackBitFields(uint16_t full_value)
 {
     // Read the 2 uint8_t values that store the packed bits.
-    const uint16_t full_value = m_data[index];
     const auto value1 = static_cast<uint8_t>(0xFF & (full_value >> 8));
     const auto value2 = static_cast<uint8_t>(0xFF & full_value);
 
@@ -591,12 +594,37 @@ void BitFieldsBuffer::copyDataToPoint(PointRef& point, size_t index)
     unpacked[3] = (value2 >> 4) & 0x03;
     unpacked[4] = (value2 >> 6) & 0x01;
     unpacked[5] = (value2 >> 7) & 0x01;
+    return unpacked;
+}
+
+} // unnamed namespace
+
+void BitFieldsBuffer::copyDataToPoint(PointRef& point, size_t index)
+{
+    const std::array<uint8_t, 6> unpacked = unpackBitFields(m_data[index]);
 
     // Set the dimension data on the PDAL point.
     for (uint32_t index = 0; index < 6; ++index)
         point.setField(m_ids[index].value(), unpacked[index]);
 }
 
+void BitFieldsBuffer::copyDataToView(PointView& view, PointId idx,
+                                     size_t offset, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        const std::array<uint8_t, 6> unpacked =
+            unpackBitFields(m_data[offset + i]);
+        for (uint32_t index = 0; index < 6; ++index)
+            view.setField(m_ids[index].value(), idx + i, unpacked[index]);
+    }
+}
+
+std::unique_ptr<TileDBDimBuffer> BitFieldsBuffer::clone() const
+{
+    return std::make_unique<BitFieldsBuffer>(m_name, m_ids);
+}
+
 const std::string& BitFieldsBuffer::name() const
 {
     return m_name;
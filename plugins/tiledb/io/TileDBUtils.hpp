@@ -37,6 +37,7 @@
 #include <array>
 #include <iostream>
 #include <istream>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <vector>
@@ -49,6 +50,7 @@
 
 #include <tiledb/tiledb>
 
+#include <pdal/PointView.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
 #include <pdal/Writer.hpp>
@@ -340,6 +342,23 @@ public:
      */
     virtual void copyDataToPoint(PointRef& point, size_t index) = 0;
 
+    /**
+     * Copy a range of data from the buffer to consecutive points in a view.
+     * Points are appended to the view as needed.
+     *
+     * @param view The view to update.
+     * @param idx Index of the first point to update.
+     * @param offset The buffer index of the first value to copy.
+     * @param count Number of values to copy.
+     */
+    virtual void copyDataToView(PointView& view, PointId idx, size_t offset,
+                                size_t count) = 0;
+
+    /**
+     * Returns a new, empty buffer for the same dimension or attribute.
+     */
+    virtual std::unique_ptr<TileDBDimBuffer> clone() const = 0;
+
     /**
      * Create a TileDB attribute compatible with the buffer.
      *
@@ -400,6 +419,19 @@ public:
         point.setField(m_id, m_data[offset]);
     }
 
+    void copyDataToView(PointView& view, PointId idx, size_t offset,
+                        size_t count) override
+    {
+        const T* data = m_data.data() + offset;
+        for (size_t i = 0; i < count; ++i)
+            view.setField(m_id, idx + i, data[i]);
+    }
+
+    std::unique_ptr<TileDBDimBuffer> clone() const override
+    {
+        return std::make_unique<TypedDimBuffer<T>>(m_name, m_id);
+    }
+
     tiledb::Attribute createAttribute(const tiledb::Context& ctx) const override
     {
         return tiledb::Attribute::create<T>(ctx, m_name);
@@ -475,6 +507,11 @@ public:
 
     void copyDataToPoint(PointRef& point, size_t index) override;
 
+    void copyDataToView(PointView& view, PointId idx, size_t offset,
+                        size_t count) override;
+
+    std::unique_ptr<TileDBDimBuffer> clone() const override;
+
     const std::string& name() const override;
 
     void resizeBuffer(size_t nelements) override;
@@ -40,6 +40,7 @@
 
 #include <io/BufferReader.hpp>
 #include <io/FauxReader.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 #include <pdal/Filter.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/pdal_test_main.hpp>
@@ -143,6 +144,57 @@ TEST_F(TileDBReaderTest, read_zero_bbox)
     EXPECT_EQ(table.numPoints(), 0);
 }
 
+TEST_F(TileDBReaderTest, read_chunks)
+{
+    // Use a chunk size that doesn't divide the point count, so that the last
+    // chunk is partial.
+    Options options;
+    options.add("array_name", data_path);
+    options.add("chunk_size", 7);
+
+    {
+        TileDBReader reader;
+        reader.setOptions(options);
+
+        PointTable table;
+        reader.prepare(table);
+        PointViewPtr view = *reader.execute(table).begin();
+
+        ASSERT_EQ(view->size(), count);
+        std::vector<bool> seen(count);
+        for (PointId i = 0; i < view->size(); ++i)
+        {
+            int t = view->getFieldAs<int>(Dimension::Id::OffsetTime, i);
+            ASSERT_GE(t, 0);
+            ASSERT_LT(t, (int)count);
+            EXPECT_FALSE(seen[t]);
+            seen[t] = true;
+            EXPECT_NEAR(t / 99.0, view->getFieldAs<double>(Dimension::Id::X, i),
+                        1e-5);
+        }
+    }
+
+    {
+        TileDBReader reader;
+        reader.setOptions(options);
+
+        point_count_t streamed = 0;
+        StreamCallbackFilter f;
+        f.setCallback(
+            [&streamed](PointRef&)
+            {
+                streamed++;
+                return true;
+            });
+        f.setInput(reader);
+
+        FixedPointTable table(10);
+        f.prepare(table);
+        f.execute(table);
+        EXPECT_EQ(streamed, count);
+    }
+}
+
 TEST_F(TileDBReaderTest, read)
 {
     class Checker : public Filter, public Streamable
@@ -0,0 +1,191 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+#include <regex>
+
+#include <nlohmann/json.hpp>
+
+#include <pdal/pdal_config.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "Bench.hpp"
+#include "TestConfig.hpp"
+
+namespace pdal
+{
+namespace bench
+{
+
+std::string Settings::datapath(const std::string& file) const
+{
+    return TestConfig::dataPath() + file;
+}
+
+std::string Settings::temppath(const std::string& file) const
+{
+    return tempDir + file;
+}
+
+
+double Result::minimum() const
+{
+    return *std::min_element(seconds.begin(), seconds.end());
+}
+
+
+double Result::median() const
+{
+    std::vector<double> s(seconds);
+    std::sort(s.begin(), s.end());
+    size_t mid = s.size() / 2;
+    return (s.size() % 2) ? s[mid] : (s[mid - 1] + s[mid]) / 2;
+}
+
+
+double Result::mean() const
+{
+    return std::accumulate(seconds.begin(), seconds.end(), 0.0) /
+        seconds.size();
+}
+
+
+double Result::stddev() const
+{
+    if (seconds.size() < 2)
+        return 0;
+
+    double m = mean();
+    double sum = 0;
+    for (double s : seconds)
+        sum += (s - m) * (s - m);
+    return std::sqrt(sum / (seconds.size() - 1));
+}
+
+
+void Suite::add(const std::string& group, const std::string& name,
+    const std::string& description, Setup setup)
+{
+    m_entries.push_back({group, group + "/" + name, description, setup});
+}
+
+
+std::vector<Suite::Entry> Suite::matching(const std::string& filter) const
+{
+    std::regex re(filter.empty() ? ".*" : filter);
+
+    std::vector<Entry> entries;
+    for (const Entry& e : m_entries)
+        if (std::regex_search(e.name, re))
+            entries.push_back(e);
+    return entries;
+}
+
+
+void Suite::list(std::ostream& out, const std::string& filter) const
+{
+    for (const Entry& e : matching(filter))
+        out << std::left << std::setw(32) << e.name << e.description << "\n";
+}
+
+
+std::vector<Result> Suite::run(const Settings& settings,
+    const std::string& filter, int warmup, int repeat, std::ostream& log) const
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<Result> results;
+    for (const Entry& e : matching(filter))
+    {
+        Result r { e.name, e.group, 0, {} };
+
+        Body body = e.setup(settings);
+        for (int i = 0; i < warmup; ++i)
+            body();
+        for (int i = 0; i < repeat; ++i)
+        {
+            auto start = Clock::now();
+            r.points = body();
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            r.seconds.push_back(elapsed.count());
+        }
+
+        log << std::left << std::setw(32) << e.name << std::right <<
+            std::setw(12) << std::fixed << std::setprecision(6) <<
+            r.median() << " s" << std::setw(16) << std::setprecision(0) <<
+            (r.points / r.median()) << " pts/s" << std::endl;
+        results.push_back(r);
+    }
+    return results;
+}
+
+
+void Suite::writeJson(std::ostream& out, const Settings& settings,
+    const std::vector<Result>& results)
+{
+    NL::json root;
+
+    root["pdal_version"] = Config::fullVersionString();
+    root["git_sha"] = Config::sha1();
+    root["num_points"] = settings.numPoints;
+
+    NL::json benchmarks = NL::json::array();
+    for (const Result& r : results)
+    {
+        double median = r.median();
+
+        NL::json b;
+        b["name"] = r.name;
+        b["group"] = r.group;
+        b["points"] = r.points;
+        b["repeat"] = r.seconds.size();
+        b["seconds"] = r.seconds;
+        b["min"] = r.minimum();
+        b["median"] = median;
+        b["mean"] = r.mean();
+        b["stddev"] = r.stddev();
+        b["points_per_second"] = median > 0 ? r.points / median : 0.0;
+        benchmarks.push_back(b);
+    }
+    root["benchmarks"] = benchmarks;
+
+    out << std::setw(2) << root << std::endl;
+}
+
+} // namespace bench
+} // namespace pdal
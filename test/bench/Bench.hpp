@@ -0,0 +1,115 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <pdal/pdal_types.hpp>
+
+namespace pdal
+{
+namespace bench
+{
+
+// Settings shared by all benchmarks.
+struct Settings
+{
+    point_count_t numPoints;
+    std::string tempDir;
+
+    std::string datapath(const std::string& file) const;
+    std::string temppath(const std::string& file) const;
+};
+
+// A benchmark body processes some points and returns how many it processed.
+// The body is what gets timed.
+using Body = std::function<point_count_t()>;
+
+// A setup function builds whatever a benchmark needs (readers, tables,
+// indexes) and returns the body to be timed.
+using Setup = std::function<Body(const Settings&)>;
+
+struct Result
+{
+    std::string name;
+    std::string group;
+    point_count_t points;
+    std::vector<double> seconds;
+
+    double minimum() const;
+    double median() const;
+    double mean() const;
+    double stddev() const;
+};
+
+class Suite
+{
+public:
+    void add(const std::string& group, const std::string& name,
+        const std::string& description, Setup setup);
+
+    // List the names and descriptions of benchmarks matching 'filter'.
+    void list(std::ostream& out, const std::string& filter) const;
+
+    // Run the benchmarks matching 'filter'.  Each is run 'warmup' times
+    // untimed and then 'repeat' times timed.  Progress is written to 'log'.
+    std::vector<Result> run(const Settings& settings, const std::string& filter,
+        int warmup, int repeat, std::ostream& log) const;
+
+    static void writeJson(std::ostream& out, const Settings& settings,
+        const std::vector<Result>& results);
+
+private:
+    struct Entry
+    {
+        std::string group;
+        std::string name;
+        std::string description;
+        Setup setup;
+    };
+
+    std::vector<Entry> matching(const std::string& filter) const;
+
+    std::vector<Entry> m_entries;
+};
+
+// Add the benchmarks in Benchmarks.cpp to 'suite'.
+void addBenchmarks(Suite& suite);
+
+} // namespace bench
+} // namespace pdal
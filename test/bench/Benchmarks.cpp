@@ -0,0 +1,397 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <memory>
+
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointTable.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <filters/StreamCallbackFilter.hpp>
+#include <io/BufferReader.hpp>
+
+#include "Bench.hpp"
+
+namespace pdal
+{
+namespace bench
+{
+
+namespace
+{
+
+// Points held by a table that outlives the benchmark body.
+struct Data
+{
+    std::unique_ptr<BasePointTable> table;
+    PointViewPtr view;
+};
+
+Options fauxOptions(point_count_t count)
+{
+    Options o;
+    o.add("count", count);
+    o.add("mode", "uniform");
+    o.add("bounds", BOX3D(0, 0, 0, 1000, 1000, 100));
+    o.add("seed", 1234);
+    return o;
+}
+
+// Read points into 'table' with the reader 'driver' and 'options'.
+std::shared_ptr<Data> load(std::unique_ptr<BasePointTable> table,
+    const std::string& driver, const Options& options)
+{
+    StageFactory f;
+    Stage *r = f.createStage(driver);
+    r->setOptions(options);
+
+    std::shared_ptr<Data> data(new Data);
+    data->table = std::move(table);
+    r->prepare(*data->table);
+    PointViewSet s = r->execute(*data->table);
+    data->view = *s.begin();
+    return data;
+}
+
+std::shared_ptr<Data> loadFaux(std::unique_ptr<BasePointTable> table,
+    point_count_t count)
+{
+    return load(std::move(table), "readers.faux", fauxOptions(count));
+}
+
+std::shared_ptr<Data> loadFile(const std::string& filename)
+{
+    Options o;
+    o.add("filename", filename);
+    return load(std::unique_ptr<BasePointTable>(new PointTable),
+        StageFactory::inferReaderDriver(filename), o);
+}
+
+// Read a file in standard mode.
+point_count_t readStandard(const std::string& filename)
+{
+    StageFactory f;
+    Stage *r = f.createStage(StageFactory::inferReaderDriver(filename));
+    Options o;
+    o.add("filename", filename);
+    r->setOptions(o);
+
+    PointTable t;
+    r->prepare(t);
+    point_count_t count = 0;
+    for (PointViewPtr v : r->execute(t))
+        count += v->size();
+    return count;
+}
+
+// Read a file in stream mode.
+point_count_t readStream(const std::string& filename)
+{
+    StageFactory f;
+    Stage *r = f.createStage(StageFactory::inferReaderDriver(filename));
+    Options o;
+    o.add("filename", filename);
+    r->setOptions(o);
+
+    point_count_t count = 0;
+    StreamCallbackFilter cb;
+    cb.setCallback([&count](PointRef&){ count++; return true; });
+    cb.setInput(*r);
+
+    FixedPointTable t(10000);
+    cb.prepare(t);
+    cb.execute(t);
+    return count;
+}
+
+// Write the points in 'data' in standard mode.
+point_count_t writeStandard(const Data& data, const std::string& driver,
+    const Options& options)
+{
+    StageFactory f;
+    BufferReader r;
+    r.addView(data.view);
+    Stage *w = f.createStage(driver);
+    w->setOptions(options);
+    w->setInput(r);
+
+    w->prepare(*data.table);
+    w->execute(*data.table);
+    return data.view->size();
+}
+
+// Generate and write points in stream mode.
+point_count_t writeStream(point_count_t count, const std::string& driver,
+    const Options& options)
+{
+    StageFactory f;
+    Stage *r = f.createStage("readers.faux");
+    r->setOptions(fauxOptions(count));
+    Stage *w = f.createStage(driver);
+    w->setOptions(options);
+    w->setInput(*r);
+
+    FixedPointTable t(10000);
+    w->prepare(t);
+    w->execute(t);
+    return count;
+}
+
+template<typename Table>
+Setup getFieldAs()
+{
+    return [](const Settings& s)
+    {
+        std::shared_ptr<Data> data =
+            loadFaux(std::unique_ptr<BasePointTable>(new Table), s.numPoints);
+        return [data]()
+        {
+            const PointView& v = *data->view;
+            double sum = 0;
+            for (PointId i = 0; i < v.size(); ++i)
+                sum += v.getFieldAs<double>(Dimension::Id::X, i) +
+                    v.getFieldAs<double>(Dimension::Id::Y, i) +
+                    v.getFieldAs<double>(Dimension::Id::Z, i);
+            // Keep the loop from being optimized away.
+            volatile double sink = sum;
+            (void)sink;
+            return v.size();
+        };
+    };
+}
+
+template<typename Table>
+Setup setField()
+{
+    return [](const Settings& s)
+    {
+        std::shared_ptr<Data> data =
+            loadFaux(std::unique_ptr<BasePointTable>(new Table), s.numPoints);
+        return [data]()
+        {
+            PointView& v = *data->view;
+            for (PointId i = 0; i < v.size(); ++i)
+            {
+                v.setField(Dimension::Id::X, i, (double)i);
+                v.setField(Dimension::Id::Y, i, (double)i);
+                v.setField(Dimension::Id::Z, i, (double)i);
+            }
+            return v.size();
+        };
+    };
+}
+
+Setup readFile(const std::string& file, bool stream)
+{
+    return [file, stream](const Settings& s) -> Body
+    {
+        std::string filename = s.datapath(file);
+        if (stream)
+            return [filename]() { return readStream(filename); };
+        return [filename]() { return readStandard(filename); };
+    };
+}
+
+Setup writeFile(const std::string& driver, const std::string& file,
+    Options options, bool stream)
+{
+    return [driver, file, options, stream](const Settings& s) -> Body
+    {
+        Options o(options);
+        o.add("filename", s.temppath(file));
+
+        point_count_t count = s.numPoints;
+        if (stream)
+            return [count, driver, o]()
+                { return writeStream(count, driver, o); };
+
+        std::shared_ptr<Data> data =
+            loadFaux(std::unique_ptr<BasePointTable>(new PointTable), count);
+        return [data, driver, o]()
+            { return writeStandard(*data, driver, o); };
+    };
+}
+
+Setup expression(bool stream)
+{
+    return [stream](const Settings& s) -> Body
+    {
+        Options fo;
+        fo.add("expression", "(Z > 20 && Z < 80) || X < 100");
+
+        point_count_t count = s.numPoints;
+        if (stream)
+            return [count, fo]()
+            {
+                StageFactory f;
+                Stage *r = f.createStage("readers.faux");
+                r->setOptions(fauxOptions(count));
+                Stage *e = f.createStage("filters.expression");
+                e->setOptions(fo);
+                e->setInput(*r);
+
+                FixedPointTable t(10000);
+                e->prepare(t);
+                e->execute(t);
+                return count;
+            };
+
+        std::shared_ptr<Data> data =
+            loadFaux(std::unique_ptr<BasePointTable>(new PointTable), count);
+        return [data, fo]()
+        {
+            StageFactory f;
+            BufferReader r;
+            r.addView(data->view);
+            Stage *e = f.createStage("filters.expression");
+            e->setOptions(fo);
+            e->setInput(r);
+
+            e->prepare(*data->table);
+            e->execute(*data->table);
+            return data->view->size();
+        };
+    };
+}
+
+Setup kdBuild()
+{
+    return [](const Settings& s)
+    {
+        std::shared_ptr<Data> data =
+            loadFile(s.datapath("las/autzen_trim.las"));
+        return [data]()
+        {
+            KD3Index index(*data->view);
+            index.build();
+            return data->view->size();
+        };
+    };
+}
+
+Setup kdKnn(point_count_t k)
+{
+    return [k](const Settings& s)
+    {
+        std::shared_ptr<Data> data =
+            loadFile(s.datapath("las/autzen_trim.las"));
+        std::shared_ptr<KD3Index> index(new KD3Index(*data->view));
+        index->build();
+        return [data, index, k]()
+        {
+            PointIdList ids(k);
+            std::vector<double> dists(k);
+            for (PointId i = 0; i < data->view->size(); ++i)
+                index->knnSearch(i, k, &ids, &dists);
+            return data->view->size();
+        };
+    };
+}
+
+Setup kdRadius(double radius)
+{
+    return [radius](const Settings& s)
+    {
+        std::shared_ptr<Data> data =
+            loadFile(s.datapath("las/autzen_trim.las"));
+        std::shared_ptr<KD3Index> index(new KD3Index(*data->view));
+        index->build();
+        return [data, index, radius]()
+        {
+            KD3Index::RadiusResults results;
+            for (PointId i = 0; i < data->view->size(); ++i)
+                index->radius(i, radius, results);
+            return data->view->size();
+        };
+    };
+}
+
+} // unnamed namespace
+
+void addBenchmarks(Suite& suite)
+{
+    suite.add("table", "row/getFieldAs",
+        "Read X/Y/Z as double from a row-oriented table",
+        getFieldAs<PointTable>());
+    suite.add("table", "column/getFieldAs",
+        "Read X/Y/Z as double from a column-oriented table",
+        getFieldAs<ColumnPointTable>());
+    suite.add("table", "row/setField",
+        "Write X/Y/Z to a row-oriented table", setField<PointTable>());
+    suite.add("table", "column/setField",
+        "Write X/Y/Z to a column-oriented table", setField<ColumnPointTable>());
+
+    suite.add("read", "las/standard", "Read LAS in standard mode",
+        readFile("las/autzen_trim.las", false));
+    suite.add("read", "las/stream", "Read LAS in stream mode",
+        readFile("las/autzen_trim.las", true));
+    suite.add("read", "laz/standard", "Read LAZ in standard mode",
+        readFile("laz/autzen_trim.laz", false));
+    suite.add("read", "laz/stream", "Read LAZ in stream mode",
+        readFile("laz/autzen_trim.laz", true));
+    suite.add("read", "bpf/standard", "Read BPF in standard mode",
+        readFile("bpf/autzen-utm.bpf", false));
+    suite.add("read", "bpf/stream", "Read BPF in stream mode",
+        readFile("bpf/autzen-utm.bpf", true));
+
+    Options laz;
+    laz.add("compression", "lazperf");
+    suite.add("write", "las/standard", "Write LAS in standard mode",
+        writeFile("writers.las", "bench.las", Options(), false));
+    suite.add("write", "las/stream", "Write LAS in stream mode",
+        writeFile("writers.las", "bench.las", Options(), true));
+    suite.add("write", "laz/standard", "Write LAZ in standard mode",
+        writeFile("writers.las", "bench.laz", laz, false));
+    suite.add("write", "laz/stream", "Write LAZ in stream mode",
+        writeFile("writers.las", "bench.laz", laz, true));
+    suite.add("write", "bpf/standard", "Write BPF in standard mode",
+        writeFile("writers.bpf", "bench.bpf", Options(), false));
+    suite.add("write", "text/standard", "Write text in standard mode",
+        writeFile("writers.text", "bench.txt", Options(), false));
+
+    suite.add("kdtree", "kd3/build", "Build a 3D KD-tree", kdBuild());
+    suite.add("kdtree", "kd3/knn8", "8-nearest-neighbor query for every point",
+        kdKnn(8));
+    suite.add("kdtree", "kd3/radius", "Radius query of every point",
+        kdRadius(5));
+
+    suite.add("expression", "standard", "Expression filter in standard mode",
+        expression(false));
+    suite.add("expression", "stream", "Expression filter in stream mode",
+        expression(true));
+}
+
+} // namespace bench
+} // namespace pdal
@@ -0,0 +1,144 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/ProgramArgs.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Bench.hpp"
+#include "TestConfig.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+void outputHelp(ProgramArgs& args)
+{
+    std::cout << "usage: pdal_bench [options]" << std::endl;
+    std::cout << "options:" << std::endl;
+    args.dump(std::cout, 2, Utils::screenWidth());
+}
+
+} // unnamed namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> argList;
+    for (int i = 1; i < argc; ++i)
+        argList.push_back(argv[i]);
+
+    bench::Settings settings;
+    std::string filter;
+    std::string output;
+    int repeat;
+    int warmup;
+    bool list;
+    bool help;
+
+    ProgramArgs args;
+    args.add("filter,f", "Regular expression selecting the benchmarks to run",
+        filter);
+    args.add("output,o", "JSON results filename (standard output if not set)",
+        output);
+    args.add("repeat,r", "Number of timed runs of each benchmark", repeat, 5);
+    args.add("warmup,w", "Number of untimed runs of each benchmark", warmup, 1);
+    args.add("points,p", "Number of points in generated data",
+        settings.numPoints, point_count_t(1000000));
+    args.add("temp_dir", "Directory for files written by benchmarks",
+        settings.tempDir, TestConfig::dataPath() + "../temp/");
+    args.add("list,l", "List benchmarks and exit", list);
+    args.add("help,h", "Print help message", help);
+
+    try
+    {
+        args.parse(argList);
+        if (repeat < 1)
+            throw arg_error("Option 'repeat' must be at least 1.");
+        if (warmup < 0)
+            throw arg_error("Option 'warmup' can't be negative.");
+    }
+    catch (arg_error& e)
+    {
+        std::cerr << "pdal_bench: " << e.what() << std::endl;
+        outputHelp(args);
+        return -1;
+    }
+    if (help)
+    {
+        outputHelp(args);
+        return 0;
+    }
+    if (settings.tempDir.size() && settings.tempDir.back() != '/')
+        settings.tempDir += '/';
+
+    bench::Suite suite;
+    bench::addBenchmarks(suite);
+
+    if (list)
+    {
+        suite.list(std::cout, filter);
+        return 0;
+    }
+
+    try
+    {
+        FileUtils::createDirectory(settings.tempDir);
+
+        // Progress goes to stderr so that JSON on stdout stays clean.
+        std::vector<bench::Result> results =
+            suite.run(settings, filter, warmup, repeat, std::cerr);
+
+        if (output.empty())
+            bench::Suite::writeJson(std::cout, settings, results);
+        else
+        {
+            std::ostream *out = FileUtils::createFile(output, false);
+            if (!out)
+                throw pdal_error("Can't open output file '" + output + "'.");
+            bench::Suite::writeJson(*out, settings, results);
+            FileUtils::closeFile(out);
+        }
+    }
+    catch (pdal_error& e)
+    {
+        std::cerr << "pdal_bench: " << e.what() << std::endl;
+        return -1;
+    }
+    return 0;
+}
@@ -36,6 +36,8 @@
 
 #include "Support.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <pdal/Stage.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/PipelineManager.hpp>
@@ -68,6 +70,111 @@ TEST(PipelineManagerTest, basic)
     FileUtils::deleteFile(outfile);
 }
 
+TEST(PipelineManagerTest, profile)
+{
+    auto test = [](ExecMode mode)
+    {
+        PipelineManager mgr;
+
+        Stage& reader = mgr.makeReader(
+            Support::datapath("las/1.2-with-color.las"), "readers.las");
+        Options decOpts;
+        decOpts.add("step", 2);
+        Stage& dec = mgr.makeFilter("filters.decimation", reader, decOpts);
+        mgr.makeWriter("", "writers.null", dec);
+
+        mgr.setProfiling(true, true);
+        EXPECT_EQ(mgr.execute(mode).m_mode, mode);
+
+        const Profiler *profiler = mgr.profiler();
+        ASSERT_TRUE(profiler);
+        const std::deque<Profiler::Record>& records = profiler->records();
+        ASSERT_EQ(records.size(), 3U);
+
+        EXPECT_EQ(records[0].m_name, "readers.las");
+        EXPECT_EQ(records[0].m_pointsOut, 1065U);
+        EXPECT_EQ(records[1].m_name, "filters.decimation");
+        EXPECT_EQ(records[1].m_pointsIn, 1065U);
+        EXPECT_EQ(records[1].m_pointsOut, 533U);
+        EXPECT_EQ(records[2].m_name, "writers.null");
+        EXPECT_EQ(records[2].m_pointsIn, 533U);
+        for (const Profiler::Record& r : records)
+        {
+            EXPECT_EQ(r.m_instance, 1);
+            EXPECT_GT(r.m_peakMemory, 0U);
+        }
+
+        MetadataNode m = mgr.getMetadata().findChild("profile");
+        EXPECT_EQ(m.children("stages").size(), 3U);
+
+        std::ostringstream trace;
+        profiler->writeTrace(trace);
+        EXPECT_NE(trace.str().find("\"filters.decimation run\""),
+            std::string::npos);
+    };
+
+    test(ExecMode::Standard);
+    test(ExecMode::Stream);
+}
+
+// Streaming times each stage once per batch, so events are merged to bound
+// the size of the trace.
+TEST(PipelineManagerTest, profileEvents)
+{
+    StageFactory f;
+    Stage *s = f.createStage("filters.decimation");
+    ASSERT_TRUE(s);
+
+    Profiler profiler(true);
+    Profiler::Record& r = profiler.begin(*s);
+    const size_t batches = 10 * Profiler::MaxEvents + 3;
+    for (size_t i = 0; i < batches; ++i)
+        Profiler::Timer t(&profiler, &r, Profiler::Run);
+    EXPECT_LE(profiler.eventCount(), Profiler::MaxEvents);
+    EXPECT_GT(profiler.eventCount(), Profiler::MaxEvents / 2);
+
+    std::ostringstream out;
+    profiler.writeTrace(out);
+    NL::json trace = NL::json::parse(out.str());
+    size_t count = 0;
+    double wall = 0;
+    for (const NL::json& e : trace["traceEvents"])
+    {
+        count += e["args"]["count"].get<size_t>();
+        wall += e["dur"].get<double>();
+    }
+    EXPECT_EQ(count, batches);
+    EXPECT_NEAR(wall, r.m_phases[Profiler::Run].m_wall * 1e6, 1);
+
+    profiler.clear();
+    EXPECT_EQ(profiler.eventCount(), 0U);
+}
+
+TEST(PipelineManagerTest, memoryBudget)
+{
+    auto run = [](size_t budget, ExecMode mode)
+    {
+        PipelineManager mgr;
+        mgr.makeReader(Support::datapath("las/1.2-with-color.las"),
+            "readers.las");
+        mgr.setMemoryBudget(budget);
+        mgr.execute(mode);
+        return mgr.getMetadata().findChild("memory");
+    };
+
+    MetadataNode m = run(0, ExecMode::Standard);
+    size_t peak = m.findChild("peak_table_bytes").value<size_t>();
+    EXPECT_GT(peak, 0U);
+    EXPECT_EQ(m.findChild("budget_bytes").value<size_t>(), 0U);
+
+    EXPECT_NO_THROW(run(peak, ExecMode::Standard));
+    EXPECT_THROW(run(peak - 1, ExecMode::Standard), pdal_error);
+
+    // The stream table holds 10,000 points rather than the 16,384 of a
+    // standard table block.
+    EXPECT_NO_THROW(run(peak * 2 / 3, ExecMode::Stream));
+}
+
 // Make sure that when we add an option at the command line, it overrides
 // a pipeline option.
 TEST(PipelineManagerTest, OptionOrder)
@@ -303,4 +303,196 @@ TEST(PointTable, layoutLimit)
     }
 }
 
+TEST(PointTable, memoryBudget)
+{
+    // 'blockSize' is the number of points in a table's allocation block.
+    auto test = [](BasePointTable& t, point_count_t blockSize)
+    {
+        t.layout()->registerDim(Dimension::Id::X, Dimension::Type::Double);
+        t.finalize();
+
+        const size_t blockBytes = blockSize * sizeof(double);
+        t.setMemoryBudget(2 * blockBytes);
+
+        PointView v(t);
+        for (PointId id = 0; id < 2 * blockSize; id++)
+            v.setField(Dimension::Id::X, id, id);
+        EXPECT_EQ(t.memoryUsage(), 2 * blockBytes);
+        EXPECT_EQ(t.peakMemoryUsage(), 2 * blockBytes);
+
+        // The next point needs a new block, which exceeds the budget.
+        EXPECT_THROW(v.setField(Dimension::Id::X, 2 * blockSize, 0),
+            pdal_error);
+        EXPECT_EQ(t.memoryUsage(), 2 * blockBytes);
+        EXPECT_EQ(v.size(), 2 * blockSize);
+
+        MetadataNode m = t.memoryMetadata();
+        EXPECT_EQ(m.findChild("peak_table_bytes").value<size_t>(),
+            2 * blockBytes);
+        EXPECT_EQ(m.findChild("budget_bytes").value<size_t>(), 2 * blockBytes);
+    };
+
+    PointTable rowTable;
+    test(rowTable, 65536);
+    ColumnPointTable columnTable;
+    test(columnTable, 16384);
+}
+
+TEST(PointTable, spill)
+{
+    // 'blockSize' is the number of points in a table's allocation block.
+    auto test = [](SimplePointTable& t, point_count_t blockSize)
+    {
+        using D = Dimension::Id;
+
+        auto allocator = std::make_shared<FileBlockAllocator>(Support::temppath(),
+            FileBlockAllocator::Advice::Sequential);
+        t.layout()->registerDim(D::X, Dimension::Type::Double);
+        t.layout()->registerDim(D::Intensity, Dimension::Type::Unsigned16);
+        t.finalize();
+
+        const size_t blockBytes = blockSize * (sizeof(double) + sizeof(uint16_t));
+        t.setMemoryBudget(blockBytes);
+        t.setSpillAllocator(allocator);
+
+        // The first block is in memory and the rest are spilled.
+        PointView v(t);
+        const point_count_t count = 3 * blockSize + 10;
+        for (PointId id = 0; id < count; id++)
+        {
+            v.setField(D::X, id, id * 0.5);
+            v.setField(D::Intensity, id, id % 65536);
+        }
+        EXPECT_EQ(t.memoryUsage(), blockBytes);
+        EXPECT_EQ(t.spilledBytes(), 3 * blockBytes);
+        EXPECT_GE(allocator->fileSize(), 3 * blockBytes);
+        EXPECT_EQ(t.memoryMetadata().findChild("spilled_bytes").value<size_t>(),
+            3 * blockBytes);
+
+        for (PointId id = 0; id < count; id++)
+        {
+            EXPECT_DOUBLE_EQ(v.getFieldAs<double>(D::X, id), id * 0.5);
+            EXPECT_EQ(v.getFieldAs<uint16_t>(D::Intensity, id), id % 65536);
+        }
+    };
+
+    PointTable rowTable;
+    test(rowTable, 65536);
+    ColumnPointTable columnTable;
+    test(columnTable, 16384);
+}
+
+TEST(PointTable, fileBlockAllocator)
+{
+    FileBlockAllocator allocator(Support::temppath());
+
+    char *a = allocator.allocate(100);
+    char *b = allocator.allocate(10000);
+    EXPECT_TRUE(allocator.owns(a));
+    EXPECT_TRUE(allocator.owns(b));
+    EXPECT_FALSE(allocator.owns(a + 1));
+    EXPECT_EQ(std::count(b, b + 10000, 0), 10000);
+
+    std::fill(a, a + 100, 'a');
+    std::fill(b, b + 10000, 'b');
+    EXPECT_EQ(std::count(a, a + 100, 'a'), 100);
+    EXPECT_EQ(std::count(b, b + 10000, 'b'), 10000);
+
+    allocator.deallocate(a, 100);
+    EXPECT_FALSE(allocator.owns(a));
+    EXPECT_TRUE(allocator.owns(b));
+
+    // Freed space is reused, and cleared, by a block of the same size.
+    uint64_t fileSize = allocator.fileSize();
+    char *c = allocator.allocate(100);
+    EXPECT_EQ(c, a);
+    EXPECT_EQ(std::count(c, c + 100, 0), 100);
+    EXPECT_EQ(allocator.fileSize(), fileSize);
+
+    // Blocks share large mappings.
+    const size_t blockSize = 16384 * sizeof(double);
+    const size_t count = FileBlockAllocator::ArenaSize / blockSize;
+    for (size_t i = 0; i < count; ++i)
+        allocator.allocate(blockSize);
+    EXPECT_EQ(allocator.fileSize(), 2 * FileBlockAllocator::ArenaSize);
+
+    FileBlockAllocator::Advice advice;
+    EXPECT_TRUE(Utils::fromString("Random", advice));
+    EXPECT_EQ(advice, FileBlockAllocator::Advice::Random);
+    EXPECT_FALSE(Utils::fromString("often", advice));
+}
+
+TEST(PointTable, poolAllocator)
+{
+    using D = Dimension::Id;
+
+    auto pool = std::make_shared<PoolBlockAllocator>();
+
+    // Blocks freed by one table are reused by the next, and come back
+    // cleared.
+    auto fill = [pool](SimplePointTable& t, point_count_t count)
+    {
+        t.layout()->registerDim(D::X, Dimension::Type::Double);
+        t.layout()->registerDim(D::Y, Dimension::Type::Double);
+        t.finalize();
+
+        PointView v(t);
+        for (PointId id = 0; id < count; id++)
+        {
+            v.setField(D::X, id, id + 1);
+            EXPECT_EQ(v.getFieldAs<double>(D::Y, id), 0);
+            v.setField(D::Y, id, id + 2);
+        }
+        EXPECT_EQ(pool->allocatedBytes(), t.memoryUsage());
+    };
+
+    for (int i = 0; i < 3; ++i)
+    {
+        PointTable t(pool);
+        fill(t, 100000);
+    }
+    EXPECT_EQ(pool->allocatedBytes(), 0u);
+    EXPECT_EQ(pool->pooledBytes(), 2 * 65536 * 2 * sizeof(double));
+    EXPECT_EQ(pool->reuseCount(), 4u);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        ColumnPointTable t(pool);
+        fill(t, 20000);
+    }
+    EXPECT_EQ(pool->reuseCount(), 12u);
+
+    pool->clear();
+    EXPECT_EQ(pool->pooledBytes(), 0u);
+
+    // Only large blocks are aligned to huge pages, and the pool doesn't
+    // grow past its limit.
+    const size_t hugePage = 2 * 1024 * 1024;
+    PoolBlockAllocator::Options opts;
+    opts.m_maxPoolBytes = 1000;
+    opts.m_hugePages = true;
+    PoolBlockAllocator small(opts);
+    char *a = small.allocate(100);
+    char *b = small.allocate(100);
+    char *c = small.allocate(3 * hugePage / 2);
+    EXPECT_EQ((uintptr_t)c % hugePage, 0u);
+    EXPECT_EQ(small.allocatedBytes(), 2 * 128 + 3 * hugePage / 2);
+    EXPECT_TRUE(small.owns(a));
+    small.deallocate(a, 100);
+    small.deallocate(b, 100);
+    small.deallocate(c, 3 * hugePage / 2);
+    EXPECT_FALSE(small.owns(a));
+    EXPECT_EQ(small.allocatedBytes(), 0u);
+    EXPECT_EQ(small.pooledBytes(), 2u * 128);
+
+    // Blocks placed on a NUMA node are page-aligned.
+    opts.m_hugePages = false;
+    opts.m_numaLocal = true;
+    PoolBlockAllocator numa(opts);
+    char *d = numa.allocate(100);
+    EXPECT_EQ((uintptr_t)d % 4096, 0u);
+    EXPECT_EQ(std::count(d, d + 100, 0), 100);
+    numa.deallocate(d, 100);
+}
+
 } // namespace
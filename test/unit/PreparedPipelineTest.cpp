@@ -0,0 +1,211 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include "Support.hpp"
+
+#include <pdal/PointView.hpp>
+#include <pdal/PreparedPipeline.hpp>
+
+#include <cmath>
+
+using namespace pdal;
+
+namespace
+{
+
+point_count_t count(const PointViewSet& views)
+{
+    point_count_t cnt = 0;
+    for (const PointViewPtr& v : views)
+        cnt += v->size();
+    return cnt;
+}
+
+std::string pipeline()
+{
+    return R"(
+    [
+        ")" + Support::datapath("las/1.2-with-color.las") + R"(",
+        {
+            "type": "filters.range",
+            "limits": "Classification[0:31]",
+            "tag": "range"
+        },
+        {
+            "type": "filters.reprojection",
+            "out_srs": "EPSG:4326",
+            "tag": "reproject"
+        }
+    ]
+    )";
+}
+
+} // unnamed namespace
+
+TEST(PreparedPipelineTest, overrides)
+{
+    std::istringstream iss(pipeline());
+    PreparedPipeline pp(iss);
+    EXPECT_TRUE(pp.streamable());
+
+    PointViewSet views;
+    {
+        ColumnPointTable table;
+        views = pp.execute(table);
+        EXPECT_EQ(count(views), 1065u);
+    }
+
+    {
+        ColumnPointTable table;
+        PreparedPipeline::Overrides o;
+        o.m_filename = Support::datapath("las/100-points.las");
+        EXPECT_EQ(count(pp.execute(table, o)), 100u);
+    }
+
+    {
+        ColumnPointTable table;
+        PreparedPipeline::Overrides o;
+        o.m_stageOptions["range"].add("limits", "Classification[2:2]");
+        point_count_t ground = count(pp.execute(table, o));
+        EXPECT_GT(ground, 0u);
+        EXPECT_LT(ground, 1065u);
+    }
+
+    // Overrides only apply to a single execution.
+    {
+        ColumnPointTable table;
+        PointViewSet again = pp.execute(table);
+        ASSERT_EQ(count(again), 1065u);
+
+        PointViewPtr v1 = *views.begin();
+        PointViewPtr v2 = *again.begin();
+        for (PointId i = 0; i < v1->size(); i += 100)
+        {
+            EXPECT_DOUBLE_EQ(v1->getFieldAs<double>(Dimension::Id::X, i),
+                v2->getFieldAs<double>(Dimension::Id::X, i));
+            EXPECT_DOUBLE_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+                v2->getFieldAs<double>(Dimension::Id::Y, i));
+        }
+    }
+
+    {
+        FixedPointTable table(100);
+        PreparedPipeline::Overrides o;
+        o.m_filename = Support::datapath("las/100-points.las");
+        pp.executeStream(table, o);
+    }
+    EXPECT_EQ(pp.executionCount(), 5u);
+}
+
+// The reprojection transform is cached between executions, but must be
+// recreated when the output SRS changes.
+TEST(PreparedPipelineTest, reprojection)
+{
+    std::istringstream iss(pipeline());
+    PreparedPipeline pp(iss);
+
+    auto firstX = [&pp](const PreparedPipeline::Overrides& o)
+    {
+        ColumnPointTable table;
+        PointViewSet views = pp.execute(table, o);
+        return (*views.begin())->getFieldAs<double>(Dimension::Id::X, 0);
+    };
+
+    double geo = firstX(PreparedPipeline::Overrides());
+
+    PreparedPipeline::Overrides o;
+    o.m_stageOptions["reproject"].add("out_srs", "EPSG:3857");
+    double web = firstX(o);
+    EXPECT_GT(std::abs(web - geo), 1000.0);
+
+    EXPECT_DOUBLE_EQ(firstX(PreparedPipeline::Overrides()), geo);
+    EXPECT_DOUBLE_EQ(firstX(o), web);
+}
+
+// Bounds and polygons only apply to readers with those options.
+TEST(PreparedPipelineTest, regionOverrides)
+{
+    std::istringstream iss(R"(
+    [
+        ")" + Support::datapath("las/1.2-with-color.las") + R"(",
+        ")" + Support::datapath("text/file1.txt") + R"(",
+        {
+            "type": "filters.merge"
+        }
+    ]
+    )");
+    PreparedPipeline pp(iss);
+
+    {
+        ColumnPointTable table;
+        EXPECT_EQ(count(pp.execute(table)), 1074u);
+    }
+
+    {
+        ColumnPointTable table;
+        PreparedPipeline::Overrides o;
+        o.m_bounds = "([635000, 637000], [848000, 854000])";
+        // All 9 text points and 438 of the LAS points.
+        EXPECT_EQ(count(pp.execute(table, o)), 447u);
+    }
+
+    {
+        ColumnPointTable table;
+        PreparedPipeline::Overrides o;
+        o.m_polygons.push_back("POLYGON ((0 0, 1 0, 1 1, 0 0))");
+        EXPECT_THROW(pp.execute(table, o), pdal_error);
+    }
+}
+
+TEST(PreparedPipelineTest, errors)
+{
+    std::istringstream iss(pipeline());
+    PreparedPipeline pp(iss);
+
+    ColumnPointTable table;
+    PreparedPipeline::Overrides o;
+    o.m_stageOptions["nosuchtag"].add("limits", "Classification[2:2]");
+    EXPECT_THROW(pp.execute(table, o), pdal_error);
+
+    // A failed execution doesn't affect the next one.
+    o.m_stageOptions.clear();
+    o.m_filename = Support::datapath("las/nosuchfile.las");
+    EXPECT_THROW(pp.execute(table, o), pdal_error);
+
+    ColumnPointTable table2;
+    EXPECT_EQ(count(pp.execute(table2)), 1065u);
+}
@@ -40,6 +40,7 @@
 
 #include <filters/private/Segmentation.hpp>
 
+#include <algorithm>
 #include <vector>
 
 using namespace pdal;
@@ -155,6 +156,46 @@ TEST(SegmentationTest, Clustering2D)
     EXPECT_EQ(1u, clusters[0].size());
 }
 
+// Splitting the neighbor searches among threads must not change the clusters.
+TEST(SegmentationTest, ClusteringThreads)
+{
+    using namespace Segmentation;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+
+    layout->registerDim(Dimension::Id::X);
+    layout->registerDim(Dimension::Id::Y);
+    layout->registerDim(Dimension::Id::Z);
+
+    PointViewPtr src(new PointView(table));
+
+    // Points on a few lines in a pseudo-random order.
+    uint32_t seed = 1;
+    for (PointId i = 0; i < 20000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        uint32_t line = (seed >> 8) % 40;
+        uint32_t pos = (seed >> 16) % 2000;
+        src->setField(Dimension::Id::X, i, pos * 0.1);
+        src->setField(Dimension::Id::Y, i, line * 2.0);
+        src->setField(Dimension::Id::Z, i, line % 3);
+    }
+
+    std::deque<PointIdList> clusters1 = extractClusters<KD3Index>(*src, 1, 100000, 0.5, 1);
+    std::deque<PointIdList> clusters2 = extractClusters<KD3Index>(*src, 1, 100000, 0.5, 8);
+    EXPECT_GT(clusters1.size(), 1u);
+    EXPECT_EQ(clusters1, clusters2);
+
+    point_count_t total = 0;
+    for (const PointIdList& c : clusters1)
+    {
+        EXPECT_TRUE(std::is_sorted(c.begin(), c.end()));
+        total += c.size();
+    }
+    EXPECT_EQ(total, src->size());
+}
+
 TEST(SegmentationTest, SegmentReturns)
 {
     using namespace Segmentation;
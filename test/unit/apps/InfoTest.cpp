@@ -250,3 +250,25 @@ std::string validation = R"foo(
         << "Found: '" << output << "'" << std::endl
         << "expected: '" << validation<<"'" << std::endl;
 }
+
+TEST(Info, boundary_resolution)
+{
+    std::string cmd;
+    std::string output;
+
+    cmd = appName() + " --boundary_resolution 50 " +
+        Support::datapath("copc/lone-star.copc.laz") + " 2>&1";
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+    EXPECT_NE(output.find("\"boundary\":"), std::string::npos) << output;
+    EXPECT_NE(output.find("\"density\":"), std::string::npos) << output;
+
+    // Only octree formats can be read at a coarse resolution.
+    cmd = appName() + " --boundary_resolution 50 " +
+        Support::datapath("las/autzen_trim.las") + " 2>&1";
+    EXPECT_NE(Utils::run_shell_command(cmd, output), 0);
+
+    // Statistics need every point.
+    cmd = appName() + " --boundary_resolution 50 --stats " +
+        Support::datapath("copc/lone-star.copc.laz") + " 2>&1";
+    EXPECT_NE(Utils::run_shell_command(cmd, output), 0);
+}
@@ -0,0 +1,85 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc., (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. nor the names of contributors
+*       may be used to endorse or promote products derived from this
+*       software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/util/FileUtils.hpp>
+#include <io/private/las/SpatialIndex.hpp>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+// Index ranges default to the LAZ chunk size.
+TEST(LasIndex, chunks)
+{
+    std::string in(Support::datapath("laz/autzen_trim.laz"));
+    std::string out(Support::temppath("autzen_trim.laz.lsi"));
+    FileUtils::deleteFile(out);
+
+    std::string cmd = Support::binpath("pdal") + " lasindex \"" + in +
+        "\" --output=\"" + out + "\"";
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+    las::SpatialIndex index;
+    index.load(out, 110000);
+    const std::vector<las::SpatialIndex::Entry>& entries = index.entries();
+    ASSERT_EQ(entries.size(), 3u);
+    EXPECT_EQ(entries[0].count, 50000u);
+    EXPECT_EQ(entries[1].first, 50000u);
+    EXPECT_EQ(entries[2].count, 10000u);
+    for (const las::SpatialIndex::Entry& e : entries)
+        EXPECT_TRUE(index.overlaps(e.first, e.first + e.count, e.bounds));
+    FileUtils::deleteFile(out);
+}
+
+TEST(LasIndex, rangeSize)
+{
+    std::string in(Support::datapath("las/simple.las"));
+    std::string out(Support::temppath("simple.las.lsi"));
+    FileUtils::deleteFile(out);
+
+    std::string cmd = Support::binpath("pdal") + " lasindex \"" + in +
+        "\" --output=\"" + out + "\" --range_size=100";
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+    las::SpatialIndex index;
+    index.load(out, 1065);
+    EXPECT_EQ(index.entries().size(), 11u);
+    EXPECT_EQ(index.entries().back().count, 65u);
+    EXPECT_THROW(index.load(out, 1000), pdal_error);
+    FileUtils::deleteFile(out);
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc., (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. nor the names of contributors
+*       may be used to endorse or promote products derived from this
+*       software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <io/LasReader.hpp>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+PointViewPtr readLas(const std::string& filename, PointTable& table)
+{
+    Options o;
+    o.add("filename", filename);
+    LasReader r;
+    r.setOptions(o);
+    r.prepare(table);
+    PointViewSet s = r.execute(table);
+    EXPECT_EQ(s.size(), 1u);
+    return *s.begin();
+}
+
+} // unnamed namespace
+
+// A small memory limit forces the sort to spill and merge several runs.
+TEST(Sort, externalGpsTime)
+{
+    std::string in(Support::datapath("las/simple.las"));
+    std::string out(Support::temppath("sort_gpstime.las"));
+    FileUtils::deleteFile(out);
+
+    std::string cmd = Support::binpath("pdal") + " sort \"" + in + "\" \"" +
+        out + "\" --external --key=GpsTime --memory=0.01";
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+    PointTable inTable;
+    PointViewPtr inView = readLas(in, inTable);
+    PointTable outTable;
+    PointViewPtr outView = readLas(out, outTable);
+
+    ASSERT_EQ(inView->size(), outView->size());
+    for (PointId i = 1; i < outView->size(); ++i)
+        EXPECT_LE(outView->getFieldAs<double>(Dimension::Id::GpsTime, i - 1),
+            outView->getFieldAs<double>(Dimension::Id::GpsTime, i));
+    FileUtils::deleteFile(out);
+}
+
+TEST(Sort, externalDescending)
+{
+    std::string in(Support::datapath("las/simple.las"));
+    std::string out(Support::temppath("sort_desc.las"));
+    FileUtils::deleteFile(out);
+
+    std::string cmd = Support::binpath("pdal") + " sort \"" + in + "\" \"" +
+        out + "\" --external --key=Z --order=DESC --memory=0.01";
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+    PointTable outTable;
+    PointViewPtr outView = readLas(out, outTable);
+    EXPECT_EQ(outView->size(), 1065u);
+    for (PointId i = 1; i < outView->size(); ++i)
+        EXPECT_GE(outView->getFieldAs<double>(Dimension::Id::Z, i - 1),
+            outView->getFieldAs<double>(Dimension::Id::Z, i));
+    FileUtils::deleteFile(out);
+}
+
+// Sorting in one run and in many runs must give the same order.
+TEST(Sort, externalCurves)
+{
+    std::string in(Support::datapath("las/simple.las"));
+    std::string out1(Support::temppath("sort_curve1.las"));
+    std::string out2(Support::temppath("sort_curve2.las"));
+
+    for (std::string curve : { "morton", "hilbert" })
+    {
+        FileUtils::deleteFile(out1);
+        FileUtils::deleteFile(out2);
+
+        std::string base = Support::binpath("pdal") + " sort \"" + in +
+            "\" --external --key=" + curve + " \"";
+        std::string output;
+        EXPECT_EQ(Utils::run_shell_command(base + out1 + "\"", output), 0);
+        EXPECT_EQ(Utils::run_shell_command(base + out2 +
+            "\" --memory=0.01 --threads=3", output), 0);
+
+        PointTable t1;
+        PointViewPtr v1 = readLas(out1, t1);
+        PointTable t2;
+        PointViewPtr v2 = readLas(out2, t2);
+        ASSERT_EQ(v1->size(), 1065u);
+        ASSERT_EQ(v1->size(), v2->size());
+        for (PointId i = 0; i < v1->size(); ++i)
+        {
+            EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::X, i),
+                v2->getFieldAs<double>(Dimension::Id::X, i));
+            EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+                v2->getFieldAs<double>(Dimension::Id::Y, i));
+        }
+    }
+    FileUtils::deleteFile(out1);
+    FileUtils::deleteFile(out2);
+}
@@ -31,6 +31,7 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <fstream>
 #include <iostream>
 #include <string>
 
@@ -323,3 +324,81 @@ TEST(TIndex, test8)
 
     EXPECT_EQ(desc, "foo");
 }
+
+// Testing incremental indexing
+TEST(TIndex, incremental)
+{
+    std::string inSpec(Support::datapath("tindex/*.txt"));
+    std::string outSpec(Support::temppath("tindex_incremental.json"));
+
+    std::string cmd = Support::binpath("pdal") + " --verbose=info tindex create " +
+        outSpec + " \"" + inSpec + "\" -f GeoJSON --log=stdout --incremental";
+
+    FileUtils::deleteFile(outSpec);
+    std::string output;
+    Utils::run_shell_command(cmd, output);
+    EXPECT_NE(output.find("Indexed file"), std::string::npos);
+
+    // Nothing has changed, so nothing is reindexed.
+    Utils::run_shell_command(cmd, output);
+    EXPECT_EQ(output.find("Indexed file"), std::string::npos);
+    EXPECT_NE(output.find("No new or changed files to index"),
+        std::string::npos);
+
+    std::string json = FileUtils::readFileIntoString(outSpec);
+    NL::json features = NL::json::parse(json)["features"];
+    EXPECT_EQ(features.size(), 3u);
+    for (auto& f : features)
+        EXPECT_EQ(f["properties"]["checksum"].get<std::string>().size(), 64u);
+
+    FileUtils::deleteFile(outSpec);
+}
+
+// Files changed or added between runs are indexed, others are skipped.
+// The default Shapefile driver doesn't keep the time of date fields.
+TEST(TIndex, incrementalChanges)
+{
+    std::string dir(Support::temppath("tindex_changes"));
+    FileUtils::deleteDirectory(dir);
+    FileUtils::createDirectory(dir);
+
+    auto copy = [&dir](const std::string& name)
+    {
+        std::ofstream out(dir + "/" + name);
+        out << FileUtils::readFileIntoString(
+            Support::datapath("tindex/" + name));
+    };
+    copy("t1.txt");
+    copy("t2.txt");
+
+    std::string cmd = Support::binpath("pdal") + " --verbose=info tindex "
+        "create " + dir + "/index.shp \"" + dir + "/*.txt\" "
+        "--log=stdout --incremental";
+
+    std::string output;
+    Utils::run_shell_command(cmd, output);
+    EXPECT_NE(output.find("t1.txt"), std::string::npos);
+    EXPECT_NE(output.find("t2.txt"), std::string::npos);
+
+    Utils::run_shell_command(cmd, output);
+    EXPECT_EQ(output.find("Indexed file"), std::string::npos);
+    EXPECT_EQ(output.find("Updated unchanged file"), std::string::npos);
+    EXPECT_NE(output.find("No new or changed files to index"),
+        std::string::npos);
+
+    // Change t1 and add t3.
+    {
+        std::ofstream out(dir + "/t1.txt", std::ios::app);
+        out << "9 9 0\n";
+    }
+    copy("t3.txt");
+
+    Utils::run_shell_command(cmd, output);
+    EXPECT_NE(output.find("Indexed file " + dir + "/t1.txt"),
+        std::string::npos);
+    EXPECT_NE(output.find("Indexed file " + dir + "/t3.txt"),
+        std::string::npos);
+    EXPECT_EQ(output.find("t2.txt"), std::string::npos);
+
+    FileUtils::deleteDirectory(dir);
+}
@@ -90,6 +90,30 @@ TEST(Tile, test1)
 }
 
 
+// Read several inputs at once and force temporary tile files to be closed
+// and reopened.
+TEST(Tile, maxOpen)
+{
+    std::string inSpec(Support::datapath("text/file*.txt"));
+    std::string outSpec(Support::temppath("tile/out#.txt"));
+
+    std::string baseCmd = Support::binpath("pdal") + " tile \"" +
+        inSpec + "\" \"" + outSpec + "\" ";
+
+    FileUtils::deleteDirectory(Support::temppath("tile"));
+    FileUtils::createDirectory(Support::temppath("tile"));
+
+    std::string output;
+    std::string cmd = baseCmd + " --origin_x=0 --origin_y=0 --length=10 "
+        "--threads=3 --max_open=2";
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+    EXPECT_EQ(FileUtils::directoryList(Support::temppath("tile")).size(), 11U);
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            checkFile(i, j, 3);
+}
+
 TEST(Tile, test2)
 {
     std::string output;
@@ -135,6 +159,53 @@ TEST(Tile, test2)
             checkFile(i, j, 3, 500000, 5000000);
 }
 
+// Each tile gets the SRS of the input, or out_srs if it is given.
+TEST(Tile, srs)
+{
+    std::string output;
+    std::string infile(Support::datapath("tile/tile.txt"));
+    std::string lasfile(Support::temppath("tile/in.las"));
+
+    FileUtils::deleteDirectory(Support::temppath("tile"));
+    FileUtils::createDirectory(Support::temppath("tile"));
+
+    std::string txCmd = Support::binpath("pdal") + " translate \"" +
+        infile + "\" \"" + lasfile +
+        "\" --readers.text.override_srs=\"EPSG:2029\"";
+    EXPECT_EQ(Utils::run_shell_command(txCmd, output), 0);
+
+    auto check = [&](const std::string& dir, const std::string& args,
+        const SpatialReference& srs)
+    {
+        FileUtils::createDirectory(Support::temppath("tile/" + dir));
+        std::string cmd = Support::binpath("pdal") + " tile \"" + lasfile +
+            "\" \"" + Support::temppath("tile/" + dir + "/out#.las") +
+            "\" --origin_x=500000 --origin_y=5000000 --length=10 "
+            "--threads=2 " + args;
+        EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+
+        int count = 0;
+        for (const std::string& f : FileUtils::directoryList(
+            Support::temppath("tile/" + dir)))
+        {
+            if (FileUtils::extension(f) != ".las")
+                continue;
+            count++;
+            Options o;
+            o.add("filename", f);
+            LasReader r;
+            r.setOptions(o);
+            PointTable t;
+            r.prepare(t);
+            EXPECT_EQ(r.getSpatialReference(), srs) << f;
+        }
+        EXPECT_GT(count, 0);
+    };
+
+    check("in", "", SpatialReference("EPSG:2029"));
+    check("out", "--out_srs=EPSG:2031", SpatialReference("EPSG:2031"));
+}
+
 TEST(Tile, test3)
 {
     std::string tmp(Support::temppath("tile/tile1.txt"));
@@ -152,6 +152,25 @@ TEST(pipelineBaseTest, progress)
     EXPECT_NE(progress.find("DONEFILE"), std::string::npos);
 }
 
+TEST(pipelineBaseTest, profile)
+{
+    std::string cmd = appName();
+    std::string traceOut = Support::temppath("trace.json");
+    FileUtils::deleteFile(traceOut);
+
+    cmd += " --profile_trace " + traceOut + " "  +
+        Support::configuredpath("pipeline/bpf2las.json");
+
+    std::string output;
+    EXPECT_EQ(Utils::run_shell_command(cmd, output), 0);
+    EXPECT_NE(output.find("\"points_per_second\":"), std::string::npos);
+    EXPECT_NE(output.find("\"readers.bpf\""), std::string::npos);
+
+    std::string trace = FileUtils::readFileIntoString(traceOut);
+    EXPECT_NE(trace.find("\"traceEvents\""), std::string::npos);
+    FileUtils::deleteFile(traceOut);
+}
+
 class json : public testing::TestWithParam<const char*> {};
 
 // TEST_P is run for each of the values in INSTANTIATE_TEST_CASE below.
@@ -0,0 +1,144 @@
+/******************************************************************************
+* Copyright (c) 2026, Hobu Inc., (info@hobu.co)
+*
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following
+* conditions are met:
+*
+*     * Redistributions of source code must retain the above copyright
+*       notice, this list of conditions and the following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright
+*       notice, this list of conditions and the following disclaimer in
+*       the documentation and/or other materials provided
+*       with the distribution.
+*     * Neither the name of Hobu, Inc. nor the names of contributors
+*       may be used to endorse or promote products derived from this
+*       software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+* "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+* LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+* FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+* COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+* INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+* BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+* OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+* AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+* OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+* OF SUCH DAMAGE.
+****************************************************************************/
+
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointView.hpp>
+#include <pdal/StageFactory.hpp>
+#include <io/LasReader.hpp>
+
+#include <unordered_set>
+
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+// Sequential DBSCAN that stores every neighborhood.
+std::vector<int64_t> referenceDbscan(PointView& view, double eps, uint64_t minPoints)
+{
+    Dimension::IdList dims { Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z };
+    KDFlexIndex kdfi(view, dims);
+    kdfi.build();
+
+    std::vector<PointIdList> neighbors(view.size());
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        neighbors[idx] = kdfi.radius(idx, eps);
+
+    std::vector<int64_t> labels(view.size(), -2);
+    int64_t label = 0;
+    for (PointId idx = 0; idx < view.size(); ++idx)
+    {
+        if (labels[idx] != -2)
+            continue;
+        if (neighbors[idx].size() < minPoints)
+        {
+            labels[idx] = -1;
+            continue;
+        }
+
+        std::unordered_set<PointId> next(neighbors[idx].begin(), neighbors[idx].end());
+        labels[idx] = label;
+        while (!next.empty())
+        {
+            PointId p = *next.begin();
+            next.erase(next.begin());
+            if (labels[p] == -1)
+                labels[p] = label;
+            if (labels[p] != -2)
+                continue;
+            labels[p] = label;
+            if (neighbors[p].size() >= minPoints)
+                for (PointId q : neighbors[p])
+                    if (labels[q] < 0)
+                        next.insert(q);
+        }
+        label++;
+    }
+    return labels;
+}
+
+} // unnamed namespace
+
+TEST(DBSCANFilterTest, create)
+{
+    StageFactory f;
+    Stage* filter(f.createStage("filters.dbscan"));
+    EXPECT_TRUE(filter);
+}
+
+// The labels must match those of a sequential DBSCAN, whatever the number
+// of threads.
+TEST(DBSCANFilterTest, threads)
+{
+    const double eps = 3.0;
+    const uint64_t minPoints = 6;
+
+    for (int threads : { 1, 4 })
+    {
+        Options ro;
+        ro.add("filename", Support::datapath("las/autzen_trim.las"));
+        ro.add("count", 20000);
+        LasReader reader;
+        reader.setOptions(ro);
+
+        StageFactory f;
+        Stage *filter(f.createStage("filters.dbscan"));
+        Options fo;
+        fo.add("eps", eps);
+        fo.add("min_points", minPoints);
+        fo.add("threads", threads);
+        filter->setOptions(fo);
+        filter->setInput(reader);
+
+        PointTable table;
+        filter->prepare(table);
+        PointViewSet s = filter->execute(table);
+        PointViewPtr view = *s.begin();
+        ASSERT_EQ(view->size(), 20000u);
+
+        std::vector<int64_t> expected = referenceDbscan(*view, eps, minPoints);
+        int64_t clusters = 0;
+        for (PointId idx = 0; idx < view->size(); ++idx)
+        {
+            int64_t label = view->getFieldAs<int64_t>(Dimension::Id::ClusterID, idx);
+            EXPECT_EQ(label, expected[idx]);
+            clusters = (std::max)(clusters, label + 1);
+        }
+        EXPECT_GT(clusters, 1);
+    }
+}
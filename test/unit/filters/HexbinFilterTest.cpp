@@ -149,6 +149,46 @@ TEST(HexbinFilterTest, HexbinFilterTest_test_2)
     EXPECT_FLOAT_EQ(m2.findChild("estimated_edge").value<float>(), 1e-05);
 }
 
+// Densities and the threshold are scaled when the input stands for more
+// points than it has.
+TEST(HexbinFilterTest, point_count)
+{
+    auto run = [](point_count_t pointCount)
+    {
+        Options ro;
+        ro.add("filename", Support::datapath("las/autzen_trim.las"));
+        LasReader r;
+        r.setOptions(ro);
+
+        Options ho;
+        ho.add("edge_length", 20);
+        if (pointCount)
+            ho.add("point_count", pointCount);
+        HexBin h;
+        h.setOptions(ho);
+        h.setInput(r);
+
+        PointTable t;
+        h.prepare(t);
+        h.execute(t);
+        return h.getMetadata();
+    };
+
+    MetadataNode m1 = run(0);
+    MetadataNode m2 = run(220000);
+
+    // Half of the points were read, so half of the threshold is needed.
+    EXPECT_EQ(m1.findChild("threshold").value<int>(), 15);
+    EXPECT_EQ(m2.findChild("threshold").value<int>(), 8);
+
+    // More hexagons are dense, and the density is that of all points.
+    double area1 = m1.findChild("area").value<double>();
+    double area2 = m2.findChild("area").value<double>();
+    EXPECT_GE(area2, area1);
+    EXPECT_NEAR(m2.findChild("density").value<double>(), 220000 / area2,
+        1e-6);
+}
+
 // Test that we create proper WKT for geometry with islands.
 TEST(HexbinFilterTest, HexGrid_issue_2507)
 {
@@ -35,10 +35,14 @@
 #include <pdal/pdal_test_main.hpp>
 
 #include <io/BufferReader.hpp>
+#include <io/LasReader.hpp>
 #include <filters/MortonOrderFilter.hpp>
 
 #include "Support.hpp"
 
+#include <climits>
+#include <numeric>
+
 using namespace pdal;
 
 TEST(MortonOrderTest, test_code)
@@ -113,3 +117,169 @@ TEST(MortonOrderTest, test_code)
     EXPECT_EQ(outView->getFieldAs<double>(Dimension::Id::X, 5), 3);
     EXPECT_EQ(outView->getFieldAs<double>(Dimension::Id::Y, 5), 2);
 }
+
+namespace
+{
+
+PointViewPtr sortGrid(int size, bool use3d, const Options& o)
+{
+    PointTable table;
+    table.layout()->registerDim(Dimension::Id::X);
+    table.layout()->registerDim(Dimension::Id::Y);
+    table.layout()->registerDim(Dimension::Id::Z);
+
+    PointViewPtr view(new PointView(table));
+
+    PointId n = 0;
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j < size; j++)
+            for (int k = 0; k < (use3d ? size : 1); k++)
+            {
+                view->setField(Dimension::Id::X, n, i);
+                view->setField(Dimension::Id::Y, n, j);
+                view->setField(Dimension::Id::Z, n, k);
+                n++;
+            }
+
+    BufferReader r;
+    r.addView(view);
+
+    MortonOrderFilter filter;
+    filter.setInput(r);
+    filter.setOptions(o);
+
+    filter.prepare(table);
+    PointViewSet s = filter.execute(table);
+    EXPECT_EQ(s.size(), 1u);
+    return *s.begin();
+}
+
+// Each point in Hilbert order must be a neighbor of the point before it.
+void checkAdjacent(PointViewPtr view)
+{
+    using namespace Dimension;
+
+    for (PointId i = 1; i < view->size(); ++i)
+    {
+        double dist =
+            std::abs(view->getFieldAs<double>(Id::X, i) -
+                view->getFieldAs<double>(Id::X, i - 1)) +
+            std::abs(view->getFieldAs<double>(Id::Y, i) -
+                view->getFieldAs<double>(Id::Y, i - 1)) +
+            std::abs(view->getFieldAs<double>(Id::Z, i) -
+                view->getFieldAs<double>(Id::Z, i - 1));
+        EXPECT_EQ(dist, 1.0);
+    }
+}
+
+} // unnamed namespace
+
+TEST(MortonOrderTest, morton)
+{
+    Options o;
+    PointViewPtr v = sortGrid(4, false, o);
+    ASSERT_EQ(v->size(), 16u);
+
+    // Z-order of the lower left quadrant, then the upper left. X is the
+    // more significant axis.
+    double xs[] = { 0, 0, 1, 1, 0, 0, 1, 1 };
+    double ys[] = { 0, 1, 0, 1, 2, 3, 2, 3 };
+    for (PointId i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::X, i), xs[i]);
+        EXPECT_EQ(v->getFieldAs<double>(Dimension::Id::Y, i), ys[i]);
+    }
+}
+
+// The order must match that of the comparison-based sort that the filter
+// originally used.
+TEST(MortonOrderTest, baseline)
+{
+    using namespace Dimension;
+
+    LasReader reader;
+    Options ro;
+    ro.add("filename", Support::datapath("las/1.2-with-color.las"));
+    reader.setOptions(ro);
+
+    PointTable table;
+    reader.prepare(table);
+    PointViewPtr in = *reader.execute(table).begin();
+
+    BOX2D bounds;
+    in->calculateBounds(bounds);
+    auto cell = [](double v, double min, double max)
+        { return (int)((v - min) / (max - min) * INT_MAX); };
+
+    std::vector<std::pair<int, int>> cells;
+    for (PointId i = 0; i < in->size(); ++i)
+        cells.emplace_back(
+            cell(in->getFieldAs<double>(Id::X, i), bounds.minx, bounds.maxx),
+            cell(in->getFieldAs<double>(Id::Y, i), bounds.miny, bounds.maxy));
+
+    // Compare along the axis with the most significant differing bit,
+    // preferring X.
+    auto lessMsb = [](int x, int y) { return x < y && x < (x ^ y); };
+    std::vector<PointId> expected(in->size());
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(),
+        [&](PointId p1, PointId p2)
+        {
+            const std::pair<int, int>& a = cells[p1];
+            const std::pair<int, int>& b = cells[p2];
+            int y = a.second ^ b.second;
+            if (lessMsb(a.first ^ b.first, y))
+                return a.second < b.second;
+            return a.first < b.first;
+        });
+
+    LasReader reader2;
+    reader2.setOptions(ro);
+    MortonOrderFilter filter;
+    filter.setInput(reader2);
+
+    PointTable table2;
+    filter.prepare(table2);
+    PointViewPtr out = *filter.execute(table2).begin();
+
+    ASSERT_EQ(out->size(), in->size());
+    for (PointId i = 0; i < out->size(); ++i)
+    {
+        EXPECT_EQ(out->getFieldAs<double>(Id::X, i),
+            in->getFieldAs<double>(Id::X, expected[i]));
+        EXPECT_EQ(out->getFieldAs<double>(Id::Y, i),
+            in->getFieldAs<double>(Id::Y, expected[i]));
+    }
+}
+
+TEST(MortonOrderTest, hilbert)
+{
+    Options o;
+    o.add("curve", "hilbert");
+    PointViewPtr v = sortGrid(8, false, o);
+    ASSERT_EQ(v->size(), 64u);
+    checkAdjacent(v);
+}
+
+TEST(MortonOrderTest, hilbert3d)
+{
+    Options o;
+    o.add("curve", "hilbert");
+    o.add("use_z", true);
+    o.add("threads", 3);
+    PointViewPtr v = sortGrid(8, true, o);
+    ASSERT_EQ(v->size(), 512u);
+    checkAdjacent(v);
+}
+
+TEST(MortonOrderTest, invalid)
+{
+    Options o;
+    o.add("curve", "peano");
+    EXPECT_THROW(sortGrid(2, false, o), pdal_error);
+
+    Options o2;
+    o2.add("reverse", true);
+    o2.add("curve", "hilbert");
+    EXPECT_THROW(sortGrid(2, false, o2), pdal_error);
+}
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include <limits>
+#include <map>
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <filters/private/Partitioner.hpp>
+
+using namespace pdal;
+
+namespace
+{
+
+// Check the groups against a straightforward grouping of the same input.
+void check(Partitioner& p, const std::vector<int64_t>& keys)
+{
+    std::vector<int64_t> order;
+    std::map<int64_t, PointIdList> expected;
+    for (PointId id = 0; id < keys.size(); ++id)
+    {
+        if (expected.find(keys[id]) == expected.end())
+            order.push_back(keys[id]);
+        expected[keys[id]].push_back(id);
+        p.add(keys[id], id);
+    }
+
+    std::vector<Partitioner::Group> groups = p.partition();
+    ASSERT_EQ(groups.size(), order.size());
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        const Partitioner::Group& g = groups[i];
+        EXPECT_EQ(g.key, order[i]);
+        EXPECT_EQ(PointIdList(g.begin, g.end), expected[g.key]);
+    }
+}
+
+} // unnamed namespace
+
+TEST(PartitionerTest, dense)
+{
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 10000; ++i)
+        keys.push_back(100 - (i * 7919) % 37);
+
+    Partitioner p;
+    check(p, keys);
+}
+
+TEST(PartitionerTest, sparse)
+{
+    // Keys of 2D cells, including negative cells, spread far apart.
+    std::vector<int64_t> keys;
+    for (int64_t i = 0; i < 10000; ++i)
+    {
+        int x = (int)((i * 7919) % 13) - 6;
+        int y = (int)((i * 104729) % 11) - 5;
+        keys.push_back(Partitioner::cellKey(x * 1000, y));
+    }
+    keys.push_back((std::numeric_limits<int64_t>::max)());
+    keys.push_back((std::numeric_limits<int64_t>::min)());
+
+    Partitioner p;
+    check(p, keys);
+
+    // The partitioner can be reused.
+    p.clear();
+    check(p, { 5, 5, 1, 5, 1 });
+}
+
+TEST(PartitionerTest, cell)
+{
+    for (int x : { -100000, -1, 0, 1, 100000 })
+        for (int y : { -100000, -1, 0, 1, 100000 })
+        {
+            std::pair<int, int> c =
+                Partitioner::cell(Partitioner::cellKey(x, y));
+            EXPECT_EQ(c.first, x);
+            EXPECT_EQ(c.second, y);
+        }
+    EXPECT_LT(Partitioner::cellKey(0, 5), Partitioner::cellKey(1, -5));
+}
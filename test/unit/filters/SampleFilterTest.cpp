@@ -0,0 +1,170 @@
+/******************************************************************************
+ * Copyright (c) 2026, Hobu Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *     * Neither the name of Hobu, Inc. nor the
+ *       names of its contributors may be used to endorse or promote
+ *       products derived from this software without specific prior
+ *       written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+
+#include <random>
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <pdal/Streamable.hpp>
+#include "io/BufferReader.hpp"
+#include "filters/SampleFilter.hpp"
+
+#include "Support.hpp"
+
+namespace pdal
+{
+
+using namespace Dimension;
+
+namespace
+{
+
+struct Pt
+{
+    double x;
+    double y;
+    double z;
+};
+
+std::vector<Pt> makePoints()
+{
+    std::mt19937 gen(1234);
+    std::uniform_real_distribution<double> dist(-10, 10);
+
+    std::vector<Pt> pts;
+    for (size_t i = 0; i < 5000; ++i)
+        pts.push_back({dist(gen), dist(gen), dist(gen)});
+    return pts;
+}
+
+// Poisson sampling keeps a point if it is at least 'radius' away from every
+// point kept before it.
+std::vector<PointId> expected(const std::vector<Pt>& pts, double radius)
+{
+    std::vector<PointId> keep;
+    for (PointId i = 0; i < pts.size(); ++i)
+    {
+        const Pt& p = pts[i];
+        bool close = false;
+        for (PointId k : keep)
+        {
+            const Pt& q = pts[k];
+            double d = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) +
+                (p.z - q.z) * (p.z - q.z);
+            if (d < radius * radius)
+            {
+                close = true;
+                break;
+            }
+        }
+        if (!close)
+            keep.push_back(i);
+    }
+    return keep;
+}
+
+PointViewPtr makeView(PointTableRef t, const std::vector<Pt>& pts)
+{
+    PointViewPtr v(new PointView(t));
+    for (PointId i = 0; i < pts.size(); ++i)
+    {
+        v->setField(Id::X, i, pts[i].x);
+        v->setField(Id::Y, i, pts[i].y);
+        v->setField(Id::Z, i, pts[i].z);
+        v->setField(Id::PointSourceId, i, i);
+    }
+    return v;
+}
+
+} // unnamed namespace
+
+TEST(SampleFilterTest, radius)
+{
+    std::vector<Pt> pts = makePoints();
+    std::vector<PointId> keep = expected(pts, 1.5);
+    ASSERT_GT(keep.size(), 100u);
+    ASSERT_LT(keep.size(), pts.size());
+
+    PointTable t;
+    t.layout()->registerDims({Id::X, Id::Y, Id::Z, Id::PointSourceId});
+    BufferReader r;
+    r.addView(makeView(t, pts));
+
+    SampleFilter f;
+    Options o;
+    o.add("radius", 1.5);
+    f.setOptions(o);
+    f.setInput(r);
+    f.prepare(t);
+    PointViewSet s = f.execute(t);
+    ASSERT_EQ(s.size(), 1u);
+    PointViewPtr v = *s.begin();
+
+    ASSERT_EQ(v->size(), keep.size());
+    for (PointId i = 0; i < v->size(); ++i)
+        EXPECT_EQ(v->getFieldAs<PointId>(Id::PointSourceId, i), keep[i]);
+}
+
+TEST(SampleFilterTest, dimension)
+{
+    std::vector<Pt> pts = makePoints();
+    std::vector<PointId> keep = expected(pts, 1.5);
+
+    PointTable t;
+    t.layout()->registerDims({Id::X, Id::Y, Id::Z, Id::PointSourceId});
+    BufferReader r;
+    r.addView(makeView(t, pts));
+
+    SampleFilter f;
+    Options o;
+    o.add("radius", 1.5);
+    o.add("dimension", "Sampled");
+    f.setOptions(o);
+    f.setInput(r);
+    f.prepare(t);
+    PointViewSet s = f.execute(t);
+    PointViewPtr v = *s.begin();
+
+    // All points are kept and the sampled ones are marked.
+    ASSERT_EQ(v->size(), pts.size());
+    Id sampled = t.layout()->findDim("Sampled");
+    std::vector<PointId> marked;
+    for (PointId i = 0; i < v->size(); ++i)
+        if (v->getFieldAs<int>(sampled, i))
+            marked.push_back(i);
+    EXPECT_EQ(marked, keep);
+}
+
+} // namespace pdal
@@ -505,6 +505,116 @@ TEST(Stats, merge)
     }
 }
 
+TEST(Stats, sketch)
+{
+    std::mt19937 gen(271828);
+    std::normal_distribution<double> dis(100, 15);
+
+    std::vector<double> values;
+    std::array<stats::QuantileSketch, 4> parts;
+    for (size_t i = 0; i < 1000000; ++i)
+    {
+        double d = dis(gen);
+        values.push_back(d);
+        parts[i % parts.size()].insert(d);
+    }
+    for (size_t i = 1; i < parts.size(); ++i)
+        parts[0].merge(parts[i]);
+    EXPECT_EQ(parts[0].count(), values.size());
+
+    std::sort(values.begin(), values.end());
+    EXPECT_NEAR(parts[0].quantile(.5), values[values.size() / 2], .1);
+    EXPECT_NEAR(parts[0].quantile(.1), values[values.size() / 10], .1);
+    EXPECT_NEAR(parts[0].quantile(.9), values[values.size() * 9 / 10], .1);
+}
+
+TEST(Stats, sketchExact)
+{
+    const size_t size = stats::QuantileSketch::LevelSize;
+
+    std::vector<double> values;
+    for (size_t i = 0; i < size; ++i)
+        values.push_back((double)i);
+    std::shuffle(values.begin(), values.end(), std::mt19937(314159));
+
+    stats::QuantileSketch sketch;
+    for (double d : values)
+        sketch.insert(d);
+
+    // No values have been dropped, so every rank is exact.
+    for (size_t k : { (size_t)0, (size_t)1, (size_t)100, size / 2 - 1,
+            size / 2, size - 1 })
+        EXPECT_EQ(sketch.quantile((double)k / size), (double)k);
+    EXPECT_EQ(sketch.medianDeviation(0), (double)(size / 2));
+}
+
+TEST(Stats, threads)
+{
+    auto run = [](int threads, bool stream)
+    {
+        Options ops;
+        ops.add("bounds", BOX3D(0, 0, 0, 1000, 1000, 1000));
+        ops.add("count", 100000);
+        ops.add("mode", "random");
+        ops.add("seed", 42);
+
+        FauxReader reader;
+        reader.setOptions(ops);
+
+        Options filterOps;
+        filterOps.add("dimensions", "X, Y, Z");
+        filterOps.add("global", "Z");
+        filterOps.add("advanced", true);
+        filterOps.add("threads", threads);
+
+        StatsFilter filter;
+        filter.setInput(reader);
+        filter.setOptions(filterOps);
+
+        std::vector<stats::Summary> summaries;
+        auto collect = [&]()
+        {
+            summaries.push_back(filter.getStats(Dimension::Id::X));
+            summaries.push_back(filter.getStats(Dimension::Id::Y));
+            summaries.push_back(filter.getStats(Dimension::Id::Z));
+        };
+        if (stream)
+        {
+            FixedPointTable table(1000);
+            filter.prepare(table);
+            filter.execute(table);
+            collect();
+        }
+        else
+        {
+            PointTable table;
+            filter.prepare(table);
+            filter.execute(table);
+            collect();
+        }
+        return summaries;
+    };
+
+    std::vector<stats::Summary> serial = run(1, false);
+    for (bool stream : { false, true })
+    {
+        std::vector<stats::Summary> threaded = run(4, stream);
+        for (size_t i = 0; i < serial.size(); ++i)
+        {
+            const stats::Summary& s = serial[i];
+            const stats::Summary& t = threaded[i];
+
+            EXPECT_EQ(s.count(), t.count());
+            EXPECT_DOUBLE_EQ(s.minimum(), t.minimum());
+            EXPECT_DOUBLE_EQ(s.maximum(), t.maximum());
+            EXPECT_FLOAT_EQ((float)s.average(), (float)t.average());
+            EXPECT_FLOAT_EQ((float)s.sampleVariance(), (float)t.sampleVariance());
+            EXPECT_FLOAT_EQ((float)s.skewness(), (float)t.skewness());
+            EXPECT_FLOAT_EQ((float)s.kurtosis(), (float)t.kurtosis());
+        }
+    }
+}
+
 TEST(Stats, counts)
 {
     PointTable table;
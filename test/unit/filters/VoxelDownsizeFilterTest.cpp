@@ -271,6 +271,53 @@ TEST(VoxelDownsizeFilter, voxelcenter_standard)
     standard_test("center");
 }
 
+// Running on several threads must give the same points in the same order.
+void threads_test(std::string mode)
+{
+    auto run = [&mode](int threads)
+    {
+        StageFactory fac;
+
+        Stage* reader = fac.createStage("readers.las");
+        Options ro;
+        ro.add("filename", Support::datapath("las/autzen_trim.las"));
+        reader->setOptions(ro);
+
+        Stage* filter = fac.createStage("filters.voxeldownsize");
+        Options fo;
+        fo.add("cell", 10);
+        fo.add("mode", mode);
+        fo.add("threads", threads);
+        filter->setOptions(fo);
+        filter->setInput(*reader);
+
+        PointTable t;
+        filter->prepare(t);
+        PointViewSet set = filter->execute(t);
+        EXPECT_EQ(set.size(), 1U);
+        std::vector<std::array<double, 3>> points;
+        for (PointRef p : **set.begin())
+            points.push_back({ p.getFieldAs<double>(Id::X),
+                p.getFieldAs<double>(Id::Y), p.getFieldAs<double>(Id::Z) });
+        return points;
+    };
+
+    std::vector<std::array<double, 3>> serial = run(1);
+    std::vector<std::array<double, 3>> parallel = run(4);
+    EXPECT_EQ(serial.size(), 7824U);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST(VoxelDownsizeFilter, firstinvoxel_threads)
+{
+    threads_test("first");
+}
+
+TEST(VoxelDownsizeFilter, voxelcenter_threads)
+{
+    threads_test("center");
+}
+
 TEST(VoxelDownsizeFilter, firstinvoxel_stream)
 {
     stream_test("first");
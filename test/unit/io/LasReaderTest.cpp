@@ -44,6 +44,8 @@
 #include <io/HeaderVal.hpp>
 #include <io/LasHeader.hpp>
 #include <io/LasReader.hpp>
+#include <io/private/las/SpatialIndex.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
@@ -540,6 +542,160 @@ TEST(LasReaderTest, stream)
 }
 
 
+// Make sure point data read through the file mapping matches data read with streams.
+TEST(LasReaderTest, mmap)
+{
+    auto test = [](const std::string& filename, int start)
+    {
+        auto read = [&filename, start](bool mmap)
+        {
+            Options opts;
+            opts.add("filename", filename);
+            opts.add("start", start);
+            opts.add("mmap", mmap);
+
+            LasReader r;
+            r.setOptions(opts);
+
+            PointTable t;
+            r.prepare(t);
+            PointViewSet s = r.execute(t);
+            EXPECT_EQ(s.size(), 1UL);
+            return *s.begin();
+        };
+
+        PointViewPtr v1 = read(true);
+        PointViewPtr v2 = read(false);
+        EXPECT_EQ(v1->size(), (point_count_t)110000 - start);
+        EXPECT_EQ(v1->size(), v2->size());
+
+        DimTypeList dims = v1->dimTypes();
+        size_t pointSize = v1->pointSize();
+        std::vector<char> buf1(pointSize);
+        std::vector<char> buf2(pointSize);
+        for (PointId i = 0; i < v1->size(); i += 7)
+        {
+           v1->getPackedPoint(dims, i, buf1.data());
+           v2->getPackedPoint(dims, i, buf2.data());
+           EXPECT_EQ(memcmp(buf1.data(), buf2.data(), pointSize), 0);
+        }
+    };
+
+    test(Support::datapath("las/autzen_trim.las"), 0);
+    test(Support::datapath("las/autzen_trim.las"), 60001);
+    test(Support::datapath("laz/autzen_trim.laz"), 0);
+    test(Support::datapath("laz/autzen_trim.laz"), 60001);
+}
+
+
+// Reading with 'bounds' must return the points inside the bounds, in file order,
+// whether or not a spatial index is used to skip data.
+TEST(LasReaderTest, bounds)
+{
+    std::string indexFile = Support::temppath("autzen_trim.lsi");
+
+    for (std::string file : { "las/autzen_trim.las", "laz/autzen_trim.laz" })
+    {
+        std::string filename = Support::datapath(file);
+
+        PointTable t;
+        Options opts;
+        opts.add("filename", filename);
+        LasReader r;
+        r.setOptions(opts);
+        r.prepare(t);
+        PointViewSet s = r.execute(t);
+        PointViewPtr v = *s.begin();
+
+        BOX2D full;
+        v->calculateBounds(full);
+        BOX2D box(full.minx, full.miny, full.minx + (full.maxx - full.minx) / 3,
+            full.miny + (full.maxy - full.miny) / 3);
+
+        las::SpatialIndex index(10000);
+        std::vector<PointId> expected;
+        for (PointId i = 0; i < v->size(); ++i)
+        {
+            double x = v->getFieldAs<double>(Dimension::Id::X, i);
+            double y = v->getFieldAs<double>(Dimension::Id::Y, i);
+            index.add(x, y, v->getFieldAs<double>(Dimension::Id::Z, i));
+            if (box.contains(x, y))
+                expected.push_back(i);
+        }
+        ASSERT_GT(expected.size(), 0u);
+        index.save(indexFile);
+
+        auto check = [&](const std::string& indexOpt)
+        {
+            Options opts;
+            opts.add("filename", filename);
+            opts.add("bounds", box);
+            if (indexOpt.size())
+                opts.add("index", indexOpt);
+
+            // Standard mode.
+            {
+                PointTable t2;
+                LasReader r2;
+                r2.setOptions(opts);
+                r2.prepare(t2);
+                PointViewSet s2 = r2.execute(t2);
+                PointViewPtr v2 = *s2.begin();
+                ASSERT_EQ(v2->size(), expected.size());
+                for (PointId i = 0; i < v2->size(); ++i)
+                {
+                    EXPECT_EQ(v2->getFieldAs<double>(Dimension::Id::X, i),
+                        v->getFieldAs<double>(Dimension::Id::X, expected[i]));
+                    EXPECT_EQ(v2->getFieldAs<double>(Dimension::Id::GpsTime, i),
+                        v->getFieldAs<double>(Dimension::Id::GpsTime, expected[i]));
+                }
+            }
+
+            // Stream mode.
+            {
+                LasReader r2;
+                r2.setOptions(opts);
+
+                size_t cnt = 0;
+                StreamCallbackFilter f;
+                f.setCallback([&](PointRef& p)
+                {
+                    if (cnt < expected.size())
+                    {
+                        EXPECT_EQ(p.getFieldAs<double>(Dimension::Id::Y),
+                            v->getFieldAs<double>(Dimension::Id::Y, expected[cnt]));
+                    }
+                    cnt++;
+                    return true;
+                });
+                f.setInput(r2);
+
+                FixedPointTable t2(100);
+                f.prepare(t2);
+                f.execute(t2);
+                EXPECT_EQ(cnt, expected.size());
+            }
+        };
+
+        check("");
+        check(indexFile);
+    }
+
+    // An index built for another file is an error when requested explicitly.
+    Options opts;
+    opts.add("filename", Support::datapath("las/simple.las"));
+    opts.add("bounds", BOX2D(0, 0, 1, 1));
+    opts.add("index", indexFile);
+    LasReader r;
+    r.setOptions(opts);
+    PointTable t;
+    r.prepare(t);
+    EXPECT_THROW(r.execute(t), pdal_error);
+
+    FileUtils::deleteFile(indexFile);
+}
+
+
 // The header of 1.2-with-color-clipped says that it has 1065 points,
 // but it really only has 1064.
 TEST(LasReaderTest, LasHeaderIncorrectPointcount)
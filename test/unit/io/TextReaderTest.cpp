@@ -361,3 +361,53 @@ TEST(TextReaderTest, quotedHeader)
         testme(opts, "text/quoted2.txt");
     }
 }
+
+// Parsing in parallel should produce the same points as parsing serially.
+TEST(TextReaderTest, threads)
+{
+    std::string filename(Support::temppath("threads.txt"));
+    {
+        std::ofstream out(filename);
+        out << "X,Y,Z\n";
+        for (int i = 0; i < 5000; ++i)
+        {
+            if (i % 100 == 0)
+                out << "\n";
+            if (i % 250 == 0)
+                out << "1,2\n";
+            out << i << ", +" << (i * 2.5) << "," << -i << "e-2";
+            out << ((i % 2) ? "\r\n" : "\n");
+        }
+        out << "5000,5000,5000";
+    }
+
+    auto read = [&filename](int threads)
+    {
+        TextReader reader;
+        Options options;
+        options.add("filename", filename);
+        options.add("threads", threads);
+        reader.setOptions(options);
+
+        PointTable table;
+        reader.prepare(table);
+        PointViewSet s = reader.execute(table);
+        PointViewPtr v = *s.begin();
+        EXPECT_EQ(v->size(), 5001U);
+        std::vector<double> values;
+        for (PointId i = 0; i < v->size(); ++i)
+        {
+            values.push_back(v->getFieldAs<double>(Dimension::Id::X, i));
+            values.push_back(v->getFieldAs<double>(Dimension::Id::Y, i));
+            values.push_back(v->getFieldAs<double>(Dimension::Id::Z, i));
+        }
+        return values;
+    };
+
+    std::vector<double> serial = read(1);
+    EXPECT_EQ(serial[3 * 1000 + 1], 2500.0);
+    EXPECT_EQ(serial[3 * 1000 + 2], -10.0);
+    EXPECT_EQ(serial, read(4));
+    EXPECT_EQ(serial, read(7));
+    FileUtils::deleteFile(filename);
+}
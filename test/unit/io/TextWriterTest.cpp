@@ -217,3 +217,52 @@ TEST(TextWriterTest, geojson)
 
     EXPECT_EQ(Support::compare_text_files(comparefile, outfile), true);
 }
+
+// Formatting in parallel should produce the same output as writing serially.
+TEST(TextWriterTest, threads)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    table.layout()->registerDims( { Id::X, Id::Y, Id::Z, Id::Intensity } );
+
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < 100000; ++i)
+    {
+        view->setField(Id::X, i, i / 3.0);
+        view->setField(Id::Y, i, -1e5 + i * 1.7);
+        view->setField(Id::Z, i, (i % 7) * 0.125);
+        view->setField(Id::Intensity, i, i % 1000);
+    }
+
+    auto write = [&table, &view](const std::string& format, int threads)
+    {
+        BufferReader r;
+        r.addView(view);
+
+        std::string outfile(Support::temppath("threads.txt"));
+        FileUtils::deleteFile(outfile);
+
+        TextWriter w;
+        Options o;
+        o.add("filename", outfile);
+        o.add("format", format);
+        o.add("order", "X:4,Y:2,Z");
+        o.add("threads", threads);
+        w.setInput(r);
+        w.setOptions(o);
+
+        w.prepare(table);
+        w.execute(table);
+
+        std::string out = FileUtils::readFileIntoString(outfile);
+        FileUtils::deleteFile(outfile);
+        return out;
+    };
+
+    std::string csv = write("csv", 1);
+    EXPECT_NE(csv.find("\n1.0000,-99994.90,0.375,3.000\n"),
+        std::string::npos);
+    EXPECT_EQ(csv, write("csv", 4));
+    EXPECT_EQ(write("geojson", 1), write("geojson", 3));
+}